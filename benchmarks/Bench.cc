@@ -0,0 +1,158 @@
+#include <algorithm>
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <chrono>
+#include <limits>
+#include <regex>
+#include <ctime>
+
+#include <omp.h>
+
+#include <localmpi.H>
+#include <config_exp.h>
+
+#include "Bench.H"
+
+namespace Bench
+{
+  std::vector<std::string> Suite::names()
+  {
+    std::regex re(opt.filter);
+    std::vector<std::string> ret;
+    for (auto & c : cases)
+      if (std::regex_search(c.name, re)) ret.push_back(c.name);
+    return ret;
+  }
+
+  void Suite::run(std::ostream& out)
+  {
+    using clock = std::chrono::steady_clock;
+
+    std::regex re(opt.filter);
+
+    int maxthreads = *std::max_element(opt.threads.begin(), opt.threads.end());
+
+    for (auto & c : cases) {
+
+      if (not std::regex_search(c.name, re)) continue;
+
+      auto sizes = c.sizes.size() ? c.sizes : opt.sizes;
+
+      for (auto n : sizes) {
+
+	// The bases size their per-thread storage at construction so
+	// the setup runs with the largest thread count
+	//
+	omp_set_num_threads(maxthreads);
+
+	Kernel k;
+	try {
+	  k = c.setup(n);
+	}
+	catch (std::exception& e) {
+	  if (myid==0)
+	    std::cerr << "expbench: skipping <" << c.name << "> for size "
+		      << n << ": " << e.what() << std::endl;
+	  continue;
+	}
+
+	for (auto t : opt.threads) {
+
+	  if (not c.threaded and t>1) continue;
+
+	  omp_set_num_threads(t);
+
+	  k.run();		// Warm up
+
+	  double best = std::numeric_limits<double>::max(), sum = 0.0;
+
+	  for (int r=0; r<opt.repeat; r++) {
+	    MPI_Barrier(MPI_COMM_WORLD);
+	    auto t0 = clock::now();
+	    k.run();
+	    std::chrono::duration<double> dt = clock::now() - t0;
+
+	    // The slowest process determines the time
+	    //
+	    double s = dt.count();
+	    MPI_Allreduce(MPI_IN_PLACE, &s, 1, MPI_DOUBLE, MPI_MAX,
+			  MPI_COMM_WORLD);
+
+	    best = std::min<double>(best, s);
+	    sum += s;
+	  }
+
+	  Result res {c.name, c.unit, n, t, opt.repeat,
+		      best, sum/opt.repeat, k.items, k.bytes};
+
+	  results.push_back(res);
+
+	  if (myid==0)
+	    std::cerr << std::left  << std::setw(32) << c.name
+		      << std::right << std::setw(10) << n
+		      << std::setw(4)  << t
+		      << std::setw(14) << std::setprecision(4)
+		      << k.items/best << " " << c.unit << "/s"
+		      << std::endl;
+	}
+      }
+    }
+
+    omp_set_num_threads(maxthreads);
+
+    if (myid==0) writeJSON(out);
+  }
+
+  void Suite::writeJSON(std::ostream& out)
+  {
+    // Time stamp
+    //
+    std::time_t now = std::time(nullptr);
+    char date[64];
+    std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+
+    auto quote = [](const std::string& s)
+    {
+      std::ostringstream sout;
+      sout << '"';
+      for (auto c : s) {
+	if (c=='"' or c=='\\') sout << '\\';
+	sout << c;
+      }
+      sout << '"';
+      return sout.str();
+    };
+
+    out << std::setprecision(8);
+
+    out << "{" << std::endl
+	<< "  \"context\": {" << std::endl
+	<< "    \"version\": "     << quote(VERSION)        << "," << std::endl
+	<< "    \"git_commit\": "  << quote(GIT_COMMIT)     << "," << std::endl
+	<< "    \"git_branch\": "  << quote(GIT_BRANCH)     << "," << std::endl
+	<< "    \"date\": "        << quote(date)           << "," << std::endl
+	<< "    \"host\": "        << quote(processor_name) << "," << std::endl
+	<< "    \"mpi_ranks\": "   << numprocs              << "," << std::endl
+	<< "    \"max_threads\": " << omp_get_max_threads() << "," << std::endl
+	<< "    \"repeat\": "      << opt.repeat            << std::endl
+	<< "  }," << std::endl
+	<< "  \"benchmarks\": [" << std::endl;
+
+    for (size_t i=0; i<results.size(); i++) {
+      auto & r = results[i];
+      out << "    {"
+	  << "\"name\": "             << quote(r.name)    << ", "
+	  << "\"unit\": "             << quote(r.unit)    << ", "
+	  << "\"size\": "             << r.size           << ", "
+	  << "\"threads\": "          << r.threads        << ", "
+	  << "\"best_seconds\": "     << r.best           << ", "
+	  << "\"mean_seconds\": "     << r.mean           << ", "
+	  << "\"items_per_second\": " << r.items/r.best   << ", "
+	  << "\"bytes_per_second\": " << r.bytes/r.best
+	  << "}" << (i+1<results.size() ? "," : "") << std::endl;
+    }
+
+    out << "  ]" << std::endl << "}" << std::endl;
+  }
+}
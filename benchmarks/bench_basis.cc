@@ -0,0 +1,258 @@
+// Coefficient accumulation and field evaluation for the biorthogonal
+// bases on synthetic particle distributions
+
+#include <fstream>
+#include <sstream>
+#include <cmath>
+
+#include <omp.h>
+
+#include <hernquist_model.H>
+#include <BiorthBasis.H>
+#include <CounterRNG.H>
+#include <localmpi.H>
+
+#include "Bench.H"
+
+namespace Bench
+{
+  // Mass, position and velocity for a particle set.  Rows are
+  // particles, columns are m, x, y, z, u, v, w as for gen_points.
+  //
+  using Particles = std::shared_ptr<Eigen::MatrixXd>;
+
+  std::shared_ptr<SphericalModelTable>
+  hernquistTable(const Options& opt, std::string& filename)
+  {
+    const int    num  = 2000;
+    const double rmin = 1.0e-4, rmax = 100.0;
+
+    filename = opt.cachedir + "/expbench.hernquist.model";
+
+    HernquistSphere model(1.0, rmin, rmax);
+
+    if (myid==0) {
+      std::ofstream out(filename);
+      if (not out)
+	throw std::runtime_error("expbench: could not write <" + filename + ">");
+
+      out << "! Hernquist model for expbench: a=1 M=1" << std::endl
+	  << "! 1) = r   2) = rho   3) = M(r)   4) U(r)" << std::endl
+	  << std::setw(10) << num << std::endl
+	  << std::scientific << std::setprecision(12);
+
+      double dr = (log(rmax) - log(rmin))/(num-1);
+      for (int i=0; i<num; i++) {
+	double r = rmin*exp(dr*i);
+	out << std::setw(20) << r
+	    << std::setw(20) << model.get_density(r)
+	    << std::setw(20) << model.get_mass(r)
+	    << std::setw(20) << model.get_pot(r) << std::endl;
+      }
+    }
+
+    MPI_Barrier(MPI_COMM_WORLD);
+
+    return std::make_shared<SphericalModelTable>(filename);
+  }
+
+  // Hernquist halo realized from the distribution function
+  //
+  static Particles halo(const Options& opt, int n)
+  {
+    HernquistSphere model(1.0, 1.0e-4, 100.0);
+    unsigned nfail;
+    return std::make_shared<Eigen::MatrixXd>
+      (model.gen_points(n, opt.seed, 0, nfail));
+  }
+
+  // Exponential disk with unit scale length and a sech^2 vertical
+  // profile with a scale height of 0.1.  Only the positions are used.
+  //
+  static Particles disk(const Options& opt, int n)
+  {
+    const double a = 1.0, h = 0.1;
+
+    auto p = std::make_shared<Eigen::MatrixXd>(n, 7);
+    p->setZero();
+
+#pragma omp parallel for
+    for (int i=0; i<n; i++) {
+      CounterRNG rng(opt.seed, i);
+      double R   = -a*log((1.0 - rng.uniform())*(1.0 - rng.uniform()));
+      double phi = 2.0*M_PI*rng.uniform();
+      double z   = h*atanh(2.0*rng.uniform() - 1.0);
+      (*p)(i, 0) = 1.0/n;
+      (*p)(i, 1) = R*cos(phi);
+      (*p)(i, 2) = R*sin(phi);
+      (*p)(i, 3) = z;
+    }
+
+    return p;
+  }
+
+  // Uniform particles in the unit cube
+  //
+  static Particles cube(const Options& opt, int n)
+  {
+    auto p = std::make_shared<Eigen::MatrixXd>(n, 7);
+    p->setZero();
+
+#pragma omp parallel for
+    for (int i=0; i<n; i++) {
+      CounterRNG rng(opt.seed, i);
+      (*p)(i, 0) = 1.0/n;
+      for (int k=1; k<4; k++) (*p)(i, k) = rng.uniform();
+    }
+
+    return p;
+  }
+
+  // Register the accumulation and evaluation cases for one basis.
+  // The basis is constructed on first use and shared by both cases.
+  //
+  static void addCases(Suite& suite, const std::string& name,
+		       std::function<BasisClasses::BasisPtr()> make,
+		       std::function<Particles(const Options&, int)> dist)
+  {
+    auto basis = std::make_shared<BasisClasses::BasisPtr>();
+
+    auto get = [basis, make]()
+    {
+      if (not *basis) *basis = make();
+      return *basis;
+    };
+
+    const Options& opt = suite.options();
+
+    // Accumulation.  The expui accumulate() members are not thread
+    // safe so this case is serial.
+    //
+    suite.add
+      ({"basis/" + name + "/accumulate", "particles", false, {},
+	[get, dist, &opt](int n)
+	{
+	  auto b = get();
+	  auto p = dist(opt, n);
+
+	  Kernel k;
+	  k.items = n;
+	  k.bytes = n*4*sizeof(double);
+	  k.run = [b, p, n]()
+	  {
+	    b->reset_coefs();
+	    for (int i=0; i<n; i++)
+	      b->accumulate((*p)(i, 1), (*p)(i, 2), (*p)(i, 3), (*p)(i, 0));
+	    b->make_coefs();
+	  };
+	  return k;
+	}});
+
+    // Field evaluation at the particle positions using coefficients
+    // from the same particles
+    //
+    suite.add
+      ({"basis/" + name + "/evaluate", "points", true, {},
+	[get, dist, &opt](int n)
+	{
+	  auto b = get();
+	  auto p = dist(opt, n);
+
+	  b->reset_coefs();
+	  for (int i=0; i<n; i++)
+	    b->accumulate((*p)(i, 1), (*p)(i, 2), (*p)(i, 3), (*p)(i, 0));
+	  b->make_coefs();
+
+	  auto x = std::make_shared<Eigen::VectorXd>(p->col(1));
+	  auto y = std::make_shared<Eigen::VectorXd>(p->col(2));
+	  auto z = std::make_shared<Eigen::VectorXd>(p->col(3));
+
+	  int nfld = b->getFieldsBatch(x->head(1), y->head(1), z->head(1)).cols();
+
+	  Kernel k;
+	  k.items = n;
+	  k.bytes = n*(3 + nfld)*sizeof(double);
+	  k.run = [b, x, y, z]() { b->getFieldsBatch(*x, *y, *z); };
+	  return k;
+	}});
+  }
+
+  void addBasis(Suite& suite)
+  {
+    const Options& opt = suite.options();
+
+    addCases
+      (suite, "spherical",
+       [&opt]()
+       {
+	 std::string model;
+	 hernquistTable(opt, model);
+
+	 std::ostringstream conf;
+	 conf << "id: sphereSL"                                        << std::endl
+	      << "parameters:"                                         << std::endl
+	      << "  Lmax: 6"                                           << std::endl
+	      << "  nmax: 12"                                          << std::endl
+	      << "  numr: 2000"                                        << std::endl
+	      << "  rmapping: 1.0"                                     << std::endl
+	      << "  modelname: " << model                              << std::endl
+	      << "  cachename: " << opt.cachedir << "/expbench.sph.cache" << std::endl;
+
+	 return BasisClasses::Basis::factory_string(conf.str());
+       }, halo);
+
+    addCases
+      (suite, "cylindrical",
+       [&opt]()
+       {
+	 std::ostringstream conf;
+	 conf << "id: cylinder"                                        << std::endl
+	      << "parameters:"                                         << std::endl
+	      << "  acyl: 1.0"                                         << std::endl
+	      << "  hcyl: 0.1"                                         << std::endl
+	      << "  lmaxfid: 20"                                       << std::endl
+	      << "  nmaxfid: 20"                                       << std::endl
+	      << "  mmax: 6"                                           << std::endl
+	      << "  nmax: 12"                                          << std::endl
+	      << "  ncylnx: 128"                                       << std::endl
+	      << "  ncylny: 64"                                        << std::endl
+	      << "  ncylodd: 3"                                        << std::endl
+	      << "  rnum: 32"                                          << std::endl
+	      << "  pnum: 0"                                           << std::endl
+	      << "  tnum: 16"                                          << std::endl
+	      << "  logr: false"                                       << std::endl
+	      << "  cachename: " << opt.cachedir << "/expbench.cyl.cache" << std::endl;
+
+	 return BasisClasses::Basis::factory_string(conf.str());
+       }, disk);
+
+    addCases
+      (suite, "flatdisk",
+       [&opt]()
+       {
+	 std::ostringstream conf;
+	 conf << "id: flatdisk"                                        << std::endl
+	      << "parameters:"                                         << std::endl
+	      << "  mmax: 6"                                           << std::endl
+	      << "  nmax: 12"                                          << std::endl
+	      << "  rcylmax: 10.0"                                     << std::endl
+	      << "  cachename: " << opt.cachedir << "/expbench.flat.cache" << std::endl;
+
+	 return BasisClasses::Basis::factory_string(conf.str());
+       }, disk);
+
+    addCases
+      (suite, "cube",
+       []()
+       {
+	 std::ostringstream conf;
+	 conf << "id: cube"                                            << std::endl
+	      << "parameters:"                                         << std::endl
+	      << "  nmaxx: 6"                                          << std::endl
+	      << "  nmaxy: 6"                                          << std::endl
+	      << "  nmaxz: 6"                                          << std::endl;
+
+	 return BasisClasses::Basis::factory_string(conf.str());
+       }, cube);
+  }
+}
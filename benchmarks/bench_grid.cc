@@ -0,0 +1,63 @@
+// Radial table interpolation for the spherical Sturm-Liouville grid
+
+#include <cmath>
+
+#include <omp.h>
+
+#include <SLGridMP2.H>
+#include <localmpi.H>
+
+#include "Bench.H"
+
+namespace Bench
+{
+  void addGrid(Suite& suite)
+  {
+    const Options& opt = suite.options();
+
+    const int    lmax = 6, nmax = 12, numr = 2000;
+    const double rmin = 1.0e-4, rmax = 99.0;
+
+    auto grid = std::make_shared<std::shared_ptr<SLGridSph>>();
+
+    suite.add
+      ({"grid/slgridsph/get_pot", "points", true, {},
+	[grid, &opt, lmax, nmax, numr, rmin, rmax](int n)
+	{
+	  if (not *grid) {
+	    std::string file;
+	    auto model = hernquistTable(opt, file);
+
+	    // The MPI table build needs worker processes; a single
+	    // process computes the tables itself
+	    //
+	    SLGridSph::mpi = numprocs>1 ? 1 : 0;
+	    *grid = std::make_shared<SLGridSph>
+	      (model, lmax, nmax, numr, rmin, rmax, true, 1, 1.0,
+	       opt.cachedir + "/expbench.slgrid.cache");
+	  }
+
+	  auto g = *grid;
+
+	  // Logarithmically spaced evaluation radii
+	  //
+	  auto r = std::make_shared<std::vector<double>>(n);
+	  double dr = (log(rmax) - log(rmin))/n;
+	  for (int i=0; i<n; i++) (*r)[i] = rmin*exp(dr*(0.5 + i));
+
+	  Kernel k;
+	  k.items = n;
+	  k.bytes = n*(1 + (lmax+1)*nmax)*sizeof(double);
+	  k.run = [g, r, n]()
+	  {
+#pragma omp parallel
+	    {
+	      Eigen::MatrixXd tab;
+#pragma omp for
+	      for (int i=0; i<n; i++) g->get_pot(tab, (*r)[i]);
+	    }
+	  };
+	  return k;
+	}});
+  }
+}
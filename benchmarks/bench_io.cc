@@ -0,0 +1,188 @@
+// Particle serialization: PSP stream and MPI-IO buffer formats and,
+// when the n-body library is available, ParticleFerry packing
+
+#include <sstream>
+
+#include <omp.h>
+
+#include <Particle.H>
+#include <CounterRNG.H>
+
+#ifdef EXP_BENCH_NBODY
+#include <ParticleFerry.H>
+#endif
+
+#include "Bench.H"
+
+namespace Bench
+{
+  // Number of integer and real attributes per particle; typical of
+  // a disk component with a level and a few diagnostics
+  //
+  static const int niatr = 1, ndatr = 4;
+
+  using PartList = std::shared_ptr<std::vector<PartPtr>>;
+
+  static PartList particles(const Options& opt, int n)
+  {
+    auto p = std::make_shared<std::vector<PartPtr>>(n);
+
+#pragma omp parallel for
+    for (int i=0; i<n; i++) {
+      CounterRNG rng(opt.seed, i);
+      auto & q = (*p)[i] = std::make_shared<Particle>(niatr, ndatr);
+      q->mass = 1.0/n;
+      for (int k=0; k<3; k++) {
+	q->pos[k] = rng.uniform();
+	q->vel[k] = rng.uniform();
+      }
+      for (auto & v : q->iattrib) v = i;
+      for (auto & v : q->dattrib) v = rng.uniform();
+      q->indx = i + 1;
+    }
+
+    return p;
+  }
+
+  void addIO(Suite& suite)
+  {
+    const Options& opt = suite.options();
+
+    // PSP stream format as used by OutPSN, with a fresh stream for
+    // every call to include the buffer growth
+    //
+    suite.add
+      ({"io/psp/write", "particles", false, {},
+	[&opt](int n)
+	{
+	  auto p = particles(opt, n);
+
+	  Kernel k;
+	  k.items = n;
+	  k.bytes = n*(*p)[0]->getMPIBufSize(sizeof(float), true);
+	  k.run = [p]()
+	  {
+	    std::ostringstream out;
+	    for (auto & q : *p) q->writeBinary(sizeof(float), true, &out);
+	  };
+	  return k;
+	}});
+
+    suite.add
+      ({"io/psp/read", "particles", false, {},
+	[&opt](int n)
+	{
+	  auto p = particles(opt, n);
+
+	  auto buf = std::make_shared<std::string>();
+	  {
+	    std::ostringstream out;
+	    for (auto & q : *p) q->writeBinary(sizeof(float), true, &out);
+	    *buf = out.str();
+	  }
+
+	  Kernel k;
+	  k.items = n;
+	  k.bytes = buf->size();
+	  k.run = [p, buf]()
+	  {
+	    std::istringstream in(*buf);
+	    int seq = 0;
+	    for (auto & q : *p) q->readBinary(sizeof(float), true, seq++, &in);
+	  };
+	  return k;
+	}});
+
+    // MPI-IO buffer format as used by OutPSP.  Each particle has a
+    // fixed size so the buffer is packed and unpacked in parallel.
+    //
+    suite.add
+      ({"io/mpiio/pack", "particles", true, {},
+	[&opt](int n)
+	{
+	  auto p = particles(opt, n);
+	  size_t sz = (*p)[0]->getMPIBufSize(sizeof(float), true);
+	  auto buf = std::make_shared<std::vector<char>>(n*sz);
+
+	  Kernel k;
+	  k.items = n;
+	  k.bytes = n*sz;
+	  k.run = [p, buf, sz, n]()
+	  {
+#pragma omp parallel for
+	    for (int i=0; i<n; i++)
+	      (*p)[i]->writeBinaryMPI(&(*buf)[i*sz], sizeof(float), true);
+	  };
+	  return k;
+	}});
+
+    suite.add
+      ({"io/mpiio/unpack", "particles", true, {},
+	[&opt](int n)
+	{
+	  auto p = particles(opt, n);
+	  size_t sz = (*p)[0]->getMPIBufSize(sizeof(float), true);
+	  auto buf = std::make_shared<std::vector<char>>(n*sz);
+
+	  for (int i=0; i<n; i++)
+	    (*p)[i]->writeBinaryMPI(&(*buf)[i*sz], sizeof(float), true);
+
+	  Kernel k;
+	  k.items = n;
+	  k.bytes = n*sz;
+	  k.run = [p, buf, sz, n]()
+	  {
+#pragma omp parallel for
+	    for (int i=0; i<n; i++)
+	      (*p)[i]->readBinaryMPI(&(*buf)[i*sz], sizeof(float), true, i);
+	  };
+	  return k;
+	}});
+
+#ifdef EXP_BENCH_NBODY
+    // ParticleFerry packing for the interprocess particle exchange
+    //
+    suite.add
+      ({"io/ferry/pack", "particles", true, {},
+	[&opt](int n)
+	{
+	  auto p = particles(opt, n);
+	  auto f = std::make_shared<ParticleFerry>(niatr, ndatr);
+	  size_t sz = f->getBufsize();
+	  auto buf = std::make_shared<std::vector<char>>(n*sz);
+
+	  Kernel k;
+	  k.items = n;
+	  k.bytes = n*sz;
+	  k.run = [p, f, buf, sz, n]()
+	  {
+#pragma omp parallel for
+	    for (int i=0; i<n; i++) f->particlePack((*p)[i], &(*buf)[i*sz]);
+	  };
+	  return k;
+	}});
+
+    suite.add
+      ({"io/ferry/unpack", "particles", true, {},
+	[&opt](int n)
+	{
+	  auto p = particles(opt, n);
+	  auto f = std::make_shared<ParticleFerry>(niatr, ndatr);
+	  size_t sz = f->getBufsize();
+	  auto buf = std::make_shared<std::vector<char>>(n*sz);
+
+	  for (int i=0; i<n; i++) f->particlePack((*p)[i], &(*buf)[i*sz]);
+
+	  Kernel k;
+	  k.items = n;
+	  k.bytes = n*sz;
+	  k.run = [p, f, buf, sz, n]()
+	  {
+#pragma omp parallel for
+	    for (int i=0; i<n; i++) f->particleUnpack((*p)[i], &(*buf)[i*sz]);
+	  };
+	  return k;
+	}});
+#endif
+  }
+}
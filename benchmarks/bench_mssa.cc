@@ -0,0 +1,92 @@
+// Multichannel singular spectrum and Koopman decompositions of a
+// synthetic coefficient table
+
+#include <cmath>
+
+#include <Coefficients.H>
+#include <CoefContainer.H>
+#include <CounterRNG.H>
+#include <expMSSA.H>
+#include <Koopman.H>
+
+#include "Bench.H"
+
+namespace Bench
+{
+  // Number of channels, decomposition rank and the time series
+  // lengths
+  //
+  static const int nchan = 16, maxEV = 16;
+  static const std::vector<int> ntimes {256, 1024, 4096};
+
+  // A table of damped and undamped oscillations with noise, one
+  // channel per column
+  //
+  static MSSA::mssaConfig table(const Options& opt, int n)
+  {
+    std::vector<double> times(n);
+    std::vector<std::vector<double>> data(n, std::vector<double>(nchan));
+
+    CounterRNG rng(opt.seed, 0);
+
+    for (int t=0; t<n; t++) {
+      times[t] = 0.01*t;
+      for (int c=0; c<nchan; c++) {
+	double w = 1.0 + 0.37*c;
+	data[t][c] =
+	  cos(w*times[t] + c) + 0.5*exp(-0.1*times[t])*sin(2.3*w*times[t])
+	  + 0.1*(rng.uniform() - 0.5);
+      }
+    }
+
+    auto coefs = std::make_shared<CoefClasses::TableData>(times, data);
+
+    std::vector<MSSA::Key> keys;
+    for (unsigned c=0; c<nchan; c++) keys.push_back({c});
+
+    MSSA::mssaConfig config;
+    config["table"] = {coefs, keys, {}};
+
+    return config;
+  }
+
+  void addMSSA(Suite& suite)
+  {
+    const Options& opt = suite.options();
+
+    suite.add
+      ({"mssa/expmssa", "samples", true, ntimes,
+	[&opt](int n)
+	{
+	  auto config = std::make_shared<MSSA::mssaConfig>(table(opt, n));
+	  int window = n/2;
+
+	  Kernel k;
+	  k.items = n*nchan;
+	  k.bytes = static_cast<double>(window)*(n - window + 1)*nchan*sizeof(double);
+	  k.run = [config, window]()
+	  {
+	    MSSA::expMSSA mssa(*config, window, maxEV);
+	    mssa.eigenvalues();
+	  };
+	  return k;
+	}});
+
+    suite.add
+      ({"mssa/koopman", "samples", true, ntimes,
+	[&opt](int n)
+	{
+	  auto config = std::make_shared<MSSA::mssaConfig>(table(opt, n));
+
+	  Kernel k;
+	  k.items = n*nchan;
+	  k.bytes = static_cast<double>(n)*nchan*sizeof(double);
+	  k.run = [config]()
+	  {
+	    MSSA::Koopman koop(*config, maxEV);
+	    koop.eigenvalues();
+	  };
+	  return k;
+	}});
+  }
+}
@@ -0,0 +1,122 @@
+// Micro-benchmarks for the EXP basis, grid, I/O and MSSA kernels.
+// See README.md in this directory for usage.
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <omp.h>
+
+#include <libvars.H>		// EXP library globals
+#include <localmpi.H>		// MPI basics
+#include <cxxopts.H>		// Option parsing
+
+#include "Bench.H"
+
+int
+main(int argc, char** argv)
+{
+  //====================
+  // Parse command line
+  //====================
+
+  Bench::Options opt;
+  std::string output;
+
+  cxxopts::Options options(argv[0], "Time the EXP kernels over thread counts and problem sizes and write the results as JSON");
+
+  options.add_options()
+    ("h,help", "Print this help message")
+    ("l,list", "List the benchmark cases and exit")
+    ("f,filter", "Regular expression to select benchmark cases",
+     cxxopts::value<std::string>(opt.filter)->default_value(".*"))
+    ("t,threads", "List of thread counts (default: 1 and powers of two up to the maximum)",
+     cxxopts::value<std::vector<int>>(opt.threads))
+    ("n,sizes", "List of particle or point counts",
+     cxxopts::value<std::vector<int>>(opt.sizes)->default_value("10000,100000,1000000"))
+    ("r,repeat", "Number of timed calls per measurement",
+     cxxopts::value<int>(opt.repeat)->default_value("5"))
+    ("s,seed", "Random seed for the synthetic distributions",
+     cxxopts::value<uint64_t>(opt.seed)->default_value("11"))
+    ("c,cachedir", "Directory for the basis cache and model files",
+     cxxopts::value<std::string>(opt.cachedir)->default_value("."))
+    ("o,output", "JSON output file (default: stdout)",
+     cxxopts::value<std::string>(output))
+    ;
+
+  //===================
+  // MPI preliminaries
+  //===================
+
+  local_init_mpi(argc, argv);
+
+  cxxopts::ParseResult vm;
+
+  try {
+    vm = options.parse(argc, argv);
+  } catch (cxxopts::OptionException& e) {
+    if (myid==0) std::cout << "Option error: " << e.what() << std::endl;
+    MPI_Finalize();
+    return 2;
+  }
+
+  // Print help message and exit
+  //
+  if (vm.count("help")) {
+    if (myid == 0) {
+      std::cout << options.help() << std::endl << std::endl;
+    }
+    MPI_Finalize();
+    return 1;
+  }
+
+  // Default thread sweep
+  //
+  if (opt.threads.empty()) {
+    int nmax = omp_get_max_threads();
+    for (int t=1; t<nmax; t*=2) opt.threads.push_back(t);
+    opt.threads.push_back(nmax);
+  }
+
+  if (opt.repeat < 1) opt.repeat = 1;
+
+  //===================
+  // Register the cases
+  //===================
+
+  Bench::Suite suite(opt);
+
+  Bench::addBasis(suite);
+  Bench::addGrid (suite);
+  Bench::addIO   (suite);
+  Bench::addMSSA (suite);
+
+  if (vm.count("list")) {
+    if (myid==0) for (auto s : suite.names()) std::cout << s << std::endl;
+    MPI_Finalize();
+    return 0;
+  }
+
+  //===================
+  // Run
+  //===================
+
+  if (output.size()) {
+    std::ofstream out;
+    if (myid==0) {
+      out.open(output);
+      if (not out) {
+	std::cerr << "expbench: could not open <" << output << ">" << std::endl;
+	MPI_Abort(MPI_COMM_WORLD, 3);
+      }
+    }
+    suite.run(out);
+  } else {
+    suite.run(std::cout);
+  }
+
+  MPI_Finalize();
+
+  return 0;
+}
@@ -229,6 +229,46 @@ namespace BasisClasses
   {
     return crt_eval(x, y, z);
   }
+
+  void Basis::batch_eval(const double* x1, const double* x2, const double* x3,
+			 int n, const Coord ctype, double* out, int ldo)
+  {
+    size_t nf = getFieldLabels(ctype).size();
+
+    for (int i=0; i<n; i++) {
+      auto v = (*this)(x1[i], x2[i], x3[i], ctype);
+      for (size_t k=0; k<std::min<size_t>(nf, v.size()); k++)
+	out[i + ldo*k] = v[k];
+    }
+  }
+
+  Eigen::MatrixXd Basis::getFieldsBatch(const Eigen::VectorXd& x,
+					const Eigen::VectorXd& y,
+					const Eigen::VectorXd& z)
+  {
+    if (x.size() != y.size() or x.size() != z.size())
+      throw std::runtime_error("Basis::getFieldsBatch: coordinate arrays "
+			       "must have the same length");
+
+    int n = x.size();
+    Eigen::MatrixXd ret(n, getFieldLabels(Coord::Cartesian).size());
+
+    // Each thread evaluates contiguous blocks of points directly into
+    // the columns of the return matrix
+    //
+    const int block = 256;
+    int nblock = (n + block - 1)/block;
+
+#pragma omp parallel for schedule(dynamic)
+    for (int b=0; b<nblock; b++) {
+      int beg = b*block;
+      int num = std::min<int>(block, n - beg);
+      batch_eval(x.data()+beg, y.data()+beg, z.data()+beg, num,
+		 Coord::Cartesian, ret.data()+beg, n);
+    }
+
+    return ret;
+  }
     
   std::tuple<std::map<std::string, Eigen::VectorXd>, Eigen::VectorXd>
   Basis::getFieldsCoefs
@@ -212,6 +212,12 @@ namespace BasisClasses
     for (auto & v : dlegs ) v.resize(lmax+1, lmax+1);
     for (auto & v : d2legs) v.resize(lmax+1, lmax+1);
 
+    rsum.resize(nthrds);
+    trig.resize(nthrds);
+
+    for (auto & v : rsum) v.resize((lmax+1)*(lmax+1), 3);
+    for (auto & v : trig) v.resize(lmax+1, 2);
+
     expcoef.resize((lmax+1)*(lmax+1), nmax);
     expcoef.setZero();
       
@@ -272,8 +278,10 @@ namespace BasisClasses
 	 "reading a previously generated basis cache\n");
     }
 
-    // Set MPI flag in SLGridSph from MPI_Initialized
-    SLGridSph::mpi = use_mpi ? 1 : 0;
+    // Set MPI flag in SLGridSph from MPI_Initialized.  The MPI table
+    // build needs worker processes, so a single process computes the
+    // tables itself.
+    SLGridSph::mpi = use_mpi and numprocs>1 ? 1 : 0;
     
     // Instantiate to get min/max radius from the model
     mod = std::make_shared<SphericalModelTable>(model_file);
@@ -501,111 +509,184 @@ namespace BasisClasses
   
   std::vector<double>
   Spherical::sph_eval(double r, double costh, double phi)
+  {
+    std::vector<double> ret(9);
+    batch_eval(&r, &costh, &phi, 1, Coord::Spherical, ret.data(), 1);
+    return ret;
+  }
+
+
+  void Spherical::batch_eval(const double* x1, const double* x2,
+			     const double* x3, int num, const Coord ctype,
+			     double* out, int ldo)
   {
     // Get thread id
     int tid = omp_get_thread_num();
 
-    double fac1, cosm, sinm;
-    double sinth = -sqrt(fabs(1.0 - costh*costh));
-    
-    fac1 = factorial(0, 0);
-    
-    get_dens (dend[tid], r/scale);
-    get_pot  (potd[tid], r/scale);
-    get_force(dpot[tid], r/scale);
-    
-    legendre_R(lmax, costh, legs[tid], dlegs[tid]);
-    
-    double den0, pot0, potr;
+    auto & sum = rsum[tid];
+    auto & cs  = trig[tid];
 
-    if (NO_L0) {
-      den0 = 0.0;
-      pot0 = 0.0;
-      potr = 0.0;
-    } else {
-      den0 = fac1 * expcoef.row(0).dot(dend[tid].row(0));
-      pot0 = fac1 * expcoef.row(0).dot(potd[tid].row(0));
-      potr = fac1 * expcoef.row(0).dot(dpot[tid].row(0));
-    }
+    int nlo = std::max<int>(0, N1);
+    int nn  = std::min<int>(nmax-1, N2) - nlo + 1;
 
-    double den1 = 0.0;
-    double pot1 = 0.0;
-    double pott = 0.0;
-    double potp = 0.0;
-    
-    // L loop
-    for (int l=1, loffset=1; l<=lmax; loffset+=(2*l+1), l++) {
-      
-      // Check for even l
-      if (EVEN_L and l%2) continue;
-      
-      // No l=1
-      if (NO_L1 and l==1) continue;
-      
-      // M loop
-      for (int m=0, moffset=0; m<=l; m++) {
-	
-	if (M0_only and m) continue;
-	if (EVEN_M and m%2) continue;
-	
-	fac1 = factorial(l, m);
-	if (m==0) {
-	  double sumR=0.0, sumP=0.0, sumD=0.0;
-	  for (int n=std::max<int>(0, N1); n<=std::min<int>(nmax-1, N2); n++) {
-	    sumR += expcoef(loffset+moffset, n) * dend[tid](l, n);
-	    sumP += expcoef(loffset+moffset, n) * potd[tid](l, n);
-	    sumD += expcoef(loffset+moffset, n) * dpot[tid](l, n);
-	  }
-	  
-	  den1 += fac1*legs[tid] (l, m) * sumR;
-	  pot1 += fac1*legs[tid] (l, m) * sumP;
-	  potr += fac1*legs[tid] (l, m) * sumD;
-	  pott += fac1*dlegs[tid](l, m) * sumP;
-	  
-	  moffset++;
+    double densfac = 1.0/(scale*scale*scale) * 0.25/M_PI;
+    double potlfac = 1.0/scale;
+
+    // The radial sums, Legendre functions and azimuthal factors are
+    // only recomputed when the corresponding coordinate changes
+    // between consecutive points
+    //
+    double lastr = std::numeric_limits<double>::quiet_NaN();
+    double lastc = lastr, lastp = lastr;
+
+    for (int i=0; i<num; i++) {
+
+      double r, costh, phi, R, z;
+
+      if (ctype == Coord::Cylindrical) {
+	R     = x1[i];
+	z     = x2[i];
+	phi   = x3[i];
+	r     = sqrt(R*R + z*z) + 1.0e-18;
+	costh = z/r;
+      } else if (ctype == Coord::Cartesian) {
+	R     = sqrt(x1[i]*x1[i] + x2[i]*x2[i]);
+	z     = x3[i];
+	phi   = atan2(x2[i], x1[i]);
+	r     = sqrt(R*R + z*z) + 1.0e-18;
+	costh = z/r;
+      } else {
+	r     = x1[i];
+	costh = x2[i];
+	phi   = x3[i];
+      }
+
+      // Coefficients contracted with the radial functions, one row
+      // per (l, m) and columns for density, potential and force
+      //
+      if (r != lastr) {
+	get_dens (dend[tid], r/scale);
+	get_pot  (potd[tid], r/scale);
+	get_force(dpot[tid], r/scale);
+
+	sum.setZero();
+
+	for (int l=0, loffset=0; l<=lmax; loffset+=(2*l+1), l++) {
+	  // The monopole uses all radial orders
+	  int n0 = l ? nlo : 0;
+	  int nt = l ? nn  : nmax;
+	  if (nt<=0) continue;
+
+	  auto E = expcoef.block(loffset, n0, 2*l+1, nt);
+	  sum.block(loffset, 0, 2*l+1, 1) =
+	    E * dend[tid].row(l).segment(n0, nt).transpose();
+	  sum.block(loffset, 1, 2*l+1, 1) =
+	    E * potd[tid].row(l).segment(n0, nt).transpose();
+	  sum.block(loffset, 2, 2*l+1, 1) =
+	    E * dpot[tid].row(l).segment(n0, nt).transpose();
 	}
-	else {
-	  cosm = cos(phi*m);
-	  sinm = sin(phi*m);
-	  
-	  double sumR0=0.0, sumP0=0.0, sumD0=0.0;
-	  double sumR1=0.0, sumP1=0.0, sumD1=0.0;
-	  for (int n=std::max<int>(0, N1); n<=std::min<int>(nmax-1, N2); n++) {
-	    sumR0 += expcoef(loffset+moffset+0, n) * dend[tid](l, n);
-	    sumP0 += expcoef(loffset+moffset+0, n) * potd[tid](l, n);
-	    sumD0 += expcoef(loffset+moffset+0, n) * dpot[tid](l, n);
-	    sumR1 += expcoef(loffset+moffset+1, n) * dend[tid](l, n);
-	    sumP1 += expcoef(loffset+moffset+1, n) * potd[tid](l, n);
-	    sumD1 += expcoef(loffset+moffset+1, n) * dpot[tid](l, n);
+
+	lastr = r;
+      }
+
+      if (costh != lastc) {
+	legendre_R(lmax, costh, legs[tid], dlegs[tid]);
+	lastc = costh;
+      }
+
+      if (phi != lastp) {
+	for (int m=0; m<=lmax; m++) {
+	  cs(m, 0) = cos(phi*m);
+	  cs(m, 1) = sin(phi*m);
+	}
+	lastp = phi;
+      }
+
+      double den0 = 0.0, pot0 = 0.0, potr = 0.0;
+
+      if (not NO_L0) {
+	double fac1 = factorial(0, 0);
+	den0 = fac1 * sum(0, 0);
+	pot0 = fac1 * sum(0, 1);
+	potr = fac1 * sum(0, 2);
+      }
+
+      double den1 = 0.0;
+      double pot1 = 0.0;
+      double pott = 0.0;
+      double potp = 0.0;
+
+      // L loop
+      for (int l=1, loffset=1; l<=lmax; loffset+=(2*l+1), l++) {
+
+	// Check for even l
+	if (EVEN_L and l%2) continue;
+
+	// No l=1
+	if (NO_L1 and l==1) continue;
+
+	// M loop
+	for (int m=0, moffset=0; m<=l; moffset+=(m ? 2 : 1), m++) {
+
+	  if (M0_only and m) break;
+	  if (EVEN_M and m%2) continue;
+
+	  double fac1 = factorial(l, m);
+	  double leg  = fac1 * legs[tid] (l, m);
+	  double dleg = fac1 * dlegs[tid](l, m);
+	  int k = loffset + moffset;
+
+	  if (m==0) {
+	    den1 += leg  * sum(k, 0);
+	    pot1 += leg  * sum(k, 1);
+	    potr += leg  * sum(k, 2);
+	    pott += dleg * sum(k, 1);
 	  }
-	  
-	  den1 += fac1 * legs[tid] (l, m) *  ( sumR0*cosm + sumR1*sinm );
-	  pot1 += fac1 * legs[tid] (l, m) *  ( sumP0*cosm + sumP1*sinm );
-	  potr += fac1 * legs[tid] (l, m) *  ( sumD0*cosm + sumD1*sinm );
-	  pott += fac1 * dlegs[tid](l, m) *  ( sumP0*cosm + sumP1*sinm );
-	  potp += fac1 * legs[tid] (l, m) *  (-sumP0*sinm + sumP1*cosm ) * m;
-	  
-	  moffset +=2;
+	  else {
+	    double cosm = cs(m, 0), sinm = cs(m, 1);
+
+	    den1 += leg  * ( sum(k, 0)*cosm + sum(k+1, 0)*sinm );
+	    pot1 += leg  * ( sum(k, 1)*cosm + sum(k+1, 1)*sinm );
+	    potr += leg  * ( sum(k, 2)*cosm + sum(k+1, 2)*sinm );
+	    pott += dleg * ( sum(k, 1)*cosm + sum(k+1, 1)*sinm );
+	    potp += leg  * (-sum(k, 1)*sinm + sum(k+1, 1)*cosm ) * m;
+	  }
+	}
+      }
+
+      // Return force not potential gradient
+      //
+      double v[9] =
+	{den0 * densfac,
+	 den1 * densfac,
+	 (den0 + den1) * densfac,
+	 pot0 * potlfac,
+	 pot1 * potlfac,
+	 (pot0 + pot1) * potlfac,
+	 potr * (-potlfac)/scale,
+	 pott * (-potlfac),
+	 potp * (-potlfac)};
+
+      // Force components in the requested coordinates
+      //
+      if (ctype == Coord::Cylindrical or ctype == Coord::Cartesian) {
+	double sinth = R/r;
+	double potR  = v[6]*sinth + v[7]*costh;
+	double potz  = v[6]*costh - v[7]*sinth;
+
+	if (ctype == Coord::Cylindrical) {
+	  v[6] = potR;
+	  v[7] = potz;
+	} else {
+	  double x = x1[i], y = x2[i];
+	  v[6] = potR*x/R - v[8]*y/R;
+	  v[7] = potR*y/R + v[8]*x/R;
+	  v[8] = potz;
 	}
       }
+
+      for (int k=0; k<9; k++) out[i + ldo*k] = v[k];
     }
-    
-    double densfac = 1.0/(scale*scale*scale) * 0.25/M_PI;
-    double potlfac = 1.0/scale;
-    
-    return
-      {den0 * densfac,		// 0
-       den1 * densfac,		// 1
-       (den0 + den1) * densfac,	// 2
-       pot0 * potlfac,		// 3
-       pot1 * potlfac,		// 4
-       (pot0 + pot1) * potlfac,	// 5
-       potr * (-potlfac)/scale,	// 6
-       pott * (-potlfac),	// 7
-       potp * (-potlfac)};	// 8
-    //         ^
-    //         |
-    // Return force not potential gradient
   }
 
 
@@ -1327,63 +1408,79 @@ namespace BasisClasses
   // Evaluate in spherical coordinates
   std::vector<double> Cylindrical::sph_eval(double r, double cth, double phi)
   {
-    double sth = sqrt(1.0 - cth*cth);
-    double R   = r*sth;
-    double z   = r*cth;
-    
-    double tdens0, tdens, tpotl0, tpotl, tpotR, tpotz, tpotp;
-    
-    sl->accumulated_eval(R, z, phi, tpotl0, tpotl, tpotR, tpotz, tpotp);
-    
-    tdens = sl->accumulated_dens_eval(R, z, phi, tdens0);
-
-    double tpotr = tpotR*R/r + tpotz*z/R ;
-    double tpott = tpotR*z/r - tpotz*R/r ;
-
-    return
-      {tdens0, tdens-tdens0, tdens,
-       tpotl0, tpotl-tpotl0, tpotl, tpotr, tpott, tpotp};
+    std::vector<double> ret(9);
+    batch_eval(&r, &cth, &phi, 1, Coord::Spherical, ret.data(), 1);
+    return ret;
   }
   
   // Evaluate in cartesian coordinates
   std::vector<double> Cylindrical::crt_eval(double x, double y, double z)
   {
-    double R = sqrt(x*x + y*y);
-    double phi = atan2(y, x);
-
-    double tdens0, tdens, tpotl0, tpotl, tpotR, tpotz, tpotp;
-
-    sl->accumulated_eval(R, z, phi, tpotl0, tpotl, tpotR, tpotz, tpotp);
-    
-    tdens = sl->accumulated_dens_eval(R, z, phi, tdens0);
-
-    double tpotx = tpotR*x/R - tpotp*y/R ;
-    double tpoty = tpotR*y/R + tpotp*x/R ;
-
-    return
-      {tdens0, tdens - tdens0, tdens,
-       tpotl0, tpotl - tpotl0, tpotl, tpotx, tpoty, tpotz};
+    std::vector<double> ret(9);
+    batch_eval(&x, &y, &z, 1, Coord::Cartesian, ret.data(), 1);
+    return ret;
   }
   
   // Evaluate in cylindrical coordinates
   std::vector<double> Cylindrical::cyl_eval(double R, double z, double phi)
   {
-    double tdens0, tdens, tpotl0, tpotl, tpotR, tpotz, tpotp, height;
+    std::vector<double> ret(midplane ? 10 : 9);
+    batch_eval(&R, &z, &phi, 1, Coord::Cylindrical, ret.data(), 1);
+    return ret;
+  }
+  
+  // Evaluate at many points, writing directly into the output arrays
+  void Cylindrical::batch_eval(const double* x1, const double* x2,
+			       const double* x3, int num, const Coord ctype,
+			       double* out, int ldo)
+  {
+    for (int i=0; i<num; i++) {
+
+      double R, z, phi, r = 0.0;
+
+      if (ctype == Coord::Spherical) {
+	double cth = x2[i];
+	double sth = sqrt(1.0 - cth*cth);
+	r   = x1[i];
+	R   = r*sth;
+	z   = r*cth;
+	phi = x3[i];
+      } else if (ctype == Coord::Cartesian) {
+	R   = sqrt(x1[i]*x1[i] + x2[i]*x2[i]);
+	z   = x3[i];
+	phi = atan2(x2[i], x1[i]);
+      } else {
+	R   = x1[i];
+	z   = x2[i];
+	phi = x3[i];
+      }
 
-    sl->accumulated_eval(R, z, phi, tpotl0, tpotl, tpotR, tpotz, tpotp);
-    tdens = sl->accumulated_dens_eval(R, z, phi, tdens0);
+      double tdens0, tdens, tpotl0, tpotl, tpotR, tpotz, tpotp;
 
-    if (midplane) {
-      height = sl->accumulated_midplane_eval(R, -colh*hcyl, colh*hcyl, phi);
-      return
-	{tdens0, tdens - tdens0, tdens,
-	 tpotl0, tpotl - tpotl0, tpotl,
-	 tpotR, tpotz, tpotp, height};
-    } else {
-      return
+      sl->accumulated_eval(R, z, phi, tpotl0, tpotl, tpotR, tpotz, tpotp);
+      tdens = sl->accumulated_dens_eval(R, z, phi, tdens0);
+
+      double v[10] =
 	{tdens0, tdens - tdens0, tdens,
 	 tpotl0, tpotl - tpotl0, tpotl,
-	 tpotR, tpotz, tpotp};
+	 tpotR, tpotz, tpotp, 0.0};
+
+      int nf = 9;
+
+      if (ctype == Coord::Spherical) {
+	v[6] = tpotR*R/r + tpotz*z/r;
+	v[7] = tpotR*z/r - tpotz*R/r;
+      } else if (ctype == Coord::Cartesian) {
+	double x = x1[i], y = x2[i];
+	v[6] = tpotR*x/R - tpotp*y/R;
+	v[7] = tpotR*y/R + tpotp*x/R;
+	v[8] = tpotz;
+      } else if (midplane) {
+	v[9] = sl->accumulated_midplane_eval(R, -colh*hcyl, colh*hcyl, phi);
+	nf = 10;
+      }
+
+      for (int k=0; k<nf; k++) out[i + ldo*k] = v[k];
     }
   }
   
@@ -1660,6 +1757,12 @@ namespace BasisClasses
     for (auto & v : potZ) v.resize(mmax+1, nmax);
     for (auto & v : dend) v.resize(mmax+1, nmax);
 
+    rsum.resize(nthrds);
+    trig.resize(nthrds);
+
+    for (auto & v : rsum) v.resize(2*mmax+1, 4);
+    for (auto & v : trig) v.resize(mmax+1, 2);
+
     expcoef.resize(2*mmax+1, nmax);
     expcoef.setZero();
       
@@ -1767,7 +1870,7 @@ namespace BasisClasses
     //======================
     
     double R2 = x*x + y*y;
-    double R  = sqrt(R);
+    double R  = sqrt(R2);
     
     // Get thread id
     int tid = omp_get_thread_num();
@@ -1822,135 +1925,177 @@ namespace BasisClasses
   }
   
   std::vector<double>FlatDisk::cyl_eval(double R, double z, double phi)
+  {
+    std::vector<double> ret(9);
+    batch_eval(&R, &z, &phi, 1, Coord::Cylindrical, ret.data(), 1);
+    return ret;
+  }
+
+
+  std::vector<double> FlatDisk::sph_eval(double r, double costh, double phi)
+  {
+    std::vector<double> ret(9);
+    batch_eval(&r, &costh, &phi, 1, Coord::Spherical, ret.data(), 1);
+    return ret;
+  }
+
+  std::vector<double> FlatDisk::crt_eval(double x, double y, double z)
+  {
+    std::vector<double> ret(9);
+    batch_eval(&x, &y, &z, 1, Coord::Cartesian, ret.data(), 1);
+    return ret;
+  }
+
+  void FlatDisk::batch_eval(const double* x1, const double* x2,
+			    const double* x3, int num, const Coord ctype,
+			    double* out, int ldo)
   {
     // Get thread id
     int tid = omp_get_thread_num();
 
+    auto & sum = rsum[tid];
+    auto & cs  = trig[tid];
+
     // Fixed values
     constexpr double norm0 = 0.5*M_2_SQRTPI/M_SQRT2;
     constexpr double norm1 = 0.5*M_2_SQRTPI;
 
-    double den0=0, den1=0, pot0=0, pot1=0, rpot=0, zpot=0, ppot=0;
-
-    // Off grid evaluation
-    if (R>ortho->getRtable() or fabs(z)>ortho->getRtable()) {
-      double r2 = R*R + z*z;
-      double r  = sqrt(r2);
-      pot0 = -totalMass/r;
-      rpot = -totalMass*R/(r*r2 + 10.0*std::numeric_limits<double>::min());
-      zpot = -totalMass*z/(r*r2 + 10.0*std::numeric_limits<double>::min());
-      
-      return {den0, den1, den0+den1, pot0, pot1, pot0+pot1, rpot, zpot, ppot};
-    }
+    int nlo = std::max<int>(0, N1);
+    int nn  = std::min<int>(nmax-1, N2) - nlo + 1;
 
-    // Get the basis fields
+    // The radial sums are recomputed when (R, z) changes and the
+    // azimuthal factors when phi changes between consecutive points
     //
-    ortho->get_dens   (dend[tid],  R, z);
-    ortho->get_pot    (potd[tid],  R, z);
-    ortho->get_rforce (potR[tid],  R, z);
-    ortho->get_zforce (potZ[tid],  R, z);
-    
-    // m loop
-    //
-    for (int m=0, moffset=0; m<=mmax; m++) {
-      
-      if (m==0 and NO_M0)        { moffset++;    continue; }
-      if (m==1 and NO_M1)        { moffset += 2; continue; }
-      if (EVEN_M and m/2*2 != m) { moffset += 2; continue; }
-      if (m>0 and M0_only)       break;
-
-      if (m==0) {
-	for (int n=std::max<int>(0, N1); n<=std::min<int>(nmax-1, N2); n++) {
-	  den0 += expcoef(0, n) * dend[tid](0, n) * norm0;
-	  pot0 += expcoef(0, n) * potd[tid](0, n) * norm0;
-	  rpot += expcoef(0, n) * potR[tid](0, n) * norm0;
-	  zpot += expcoef(0, n) * potZ[tid](0, n) * norm0;
-	}
-	
-	moffset++;
-      } else {
-	double cosm = cos(phi*m), sinm = sin(phi*m);
-	double vc, vs;
+    double lastR = std::numeric_limits<double>::quiet_NaN();
+    double lastz = lastR, lastp = lastR;
 
-	vc = vs = 0.0;
-	for (int n=std::max<int>(0, N1); n<=std::min<int>(nmax-1, N2); n++) {
-	  vc += expcoef(moffset+0, n) * dend[tid](m, n);
-	  vs += expcoef(moffset+1, n) * dend[tid](m, n);
-	}
-	
-	den1 += (vc*cosm + vs*sinm) * norm1;
-      
-	vc = vs = 0.0;
-	for (int n=std::max<int>(0, N1); n<=std::min<int>(nmax-1, N2); n++) {
-	  vc += expcoef(moffset+0, n) * potd[tid](m, n);
-	  vs += expcoef(moffset+1, n) * potd[tid](m, n);
-	}
-	
-	pot1 += ( vc*cosm + vs*sinm) * norm1;
-	ppot += (-vc*sinm + vs*cosm) * m * norm1;
+    for (int i=0; i<num; i++) {
 
-	vc = vs = 0.0;
-	for (int n=std::max<int>(0, N1); n<=std::min<int>(nmax-1, N2); n++) {
-	  vc += expcoef(moffset+0, n) * potR[tid](m, n);
-	  vs += expcoef(moffset+1, n) * potR[tid](m, n);
-	}
+      double R, z, phi, sinth = 0.0, costh = 0.0;
 
-	rpot += (vc*cosm + vs*sinm) * norm1;
-	
-	vc = vs = 0.0;
-	for (int n=std::max<int>(0, N1); n<=std::min<int>(nmax-1, N2); n++) {
-	  vc += expcoef(moffset+0, n) * potZ[tid](m, n);
-	  vs += expcoef(moffset+1, n) * potZ[tid](m, n);
-	}
+      if (ctype == Coord::Spherical) {
+	costh = x2[i];
+	sinth = sqrt(fabs(1.0 - costh*costh));
+	R     = x1[i]*sinth;
+	z     = x1[i]*costh;
+	phi   = x3[i];
+      } else if (ctype == Coord::Cartesian) {
+	R     = sqrt(x1[i]*x1[i] + x2[i]*x2[i]) + 1.0e-18;
+	z     = x3[i];
+	phi   = atan2(x2[i], x1[i]);
+      } else {
+	R     = x1[i];
+	z     = x2[i];
+	phi   = x3[i];
+      }
 
-	zpot += (vc*cosm + vs*sinm) * norm1;
+      double den0=0, den1=0, pot0=0, pot1=0, rpot=0, zpot=0, ppot=0;
 
-	moffset +=2;
+      // Off grid evaluation
+      if (R>ortho->getRtable() or fabs(z)>ortho->getRtable()) {
+	double r2 = R*R + z*z;
+	double r  = sqrt(r2);
+	pot0 = -totalMass/r;
+	rpot = -totalMass*R/(r*r2 + 10.0*std::numeric_limits<double>::min());
+	zpot = -totalMass*z/(r*r2 + 10.0*std::numeric_limits<double>::min());
       }
-    }
+      else {
 
-    den0 *= -1.0;
-    den1 *= -1.0;
-    pot0 *= -1.0;
-    pot1 *= -1.0;
-    rpot *= -1.0;
-    zpot *= -1.0;
-    ppot *= -1.0;
+	// Coefficients contracted with the basis fields, one row per
+	// (m, cos/sin) and columns for density, potential, radial and
+	// vertical force
+	//
+	if (R != lastR or z != lastz) {
+	  ortho->get_dens   (dend[tid],  R, z);
+	  ortho->get_pot    (potd[tid],  R, z);
+	  ortho->get_rforce (potR[tid],  R, z);
+	  ortho->get_zforce (potZ[tid],  R, z);
+
+	  sum.setZero();
+
+	  if (nn>0) {
+	    for (int m=0, moffset=0; m<=mmax; moffset+=(m ? 2 : 1), m++) {
+	      int rows = m ? 2 : 1;
+	      auto E = expcoef.block(moffset, nlo, rows, nn);
+	      sum.block(moffset, 0, rows, 1) =
+		E * dend[tid].row(m).segment(nlo, nn).transpose();
+	      sum.block(moffset, 1, rows, 1) =
+		E * potd[tid].row(m).segment(nlo, nn).transpose();
+	      sum.block(moffset, 2, rows, 1) =
+		E * potR[tid].row(m).segment(nlo, nn).transpose();
+	      sum.block(moffset, 3, rows, 1) =
+		E * potZ[tid].row(m).segment(nlo, nn).transpose();
+	    }
+	  }
 
-    return {den0, den1, den0+den1, pot0, pot1, pot0+pot1, rpot, zpot, ppot};
-  }
+	  lastR = R;
+	  lastz = z;
+	}
 
+	if (phi != lastp) {
+	  for (int m=0; m<=mmax; m++) {
+	    cs(m, 0) = cos(phi*m);
+	    cs(m, 1) = sin(phi*m);
+	  }
+	  lastp = phi;
+	}
 
-  std::vector<double> FlatDisk::sph_eval(double r, double costh, double phi)
-  {
-    // Cylindrical coords
-    //
-    double sinth = sqrt(fabs(1.0 - costh*costh));
-    double R = r*sinth, z = r*costh;
+	// m loop
+	//
+	for (int m=0, moffset=0; m<=mmax; m++) {
 
-    auto v = cyl_eval(R, z, phi);
-  
-    // Spherical force element converstion
-    //
-    double potr = v[6]*sinth + v[7]*costh;
-    double pott = v[6]*costh - v[7]*sinth;
+	  if (m==0 and NO_M0)        { moffset++;    continue; }
+	  if (m==1 and NO_M1)        { moffset += 2; continue; }
+	  if (EVEN_M and m/2*2 != m) { moffset += 2; continue; }
+	  if (m>0 and M0_only)       break;
 
-    return {v[0], v[1], v[2], v[3], v[4], v[5], potr, pott, v[8]};
-  }
+	  if (m==0) {
+	    den0 += sum(0, 0) * norm0;
+	    pot0 += sum(0, 1) * norm0;
+	    rpot += sum(0, 2) * norm0;
+	    zpot += sum(0, 3) * norm0;
 
-  std::vector<double> FlatDisk::crt_eval(double x, double y, double z)
-  {
-    // Cylindrical coords from Cartesian
-    //
-    double R = sqrt(x*x + y*y) + 1.0e-18;
-    double phi = atan2(y, x);
+	    moffset++;
+	  } else {
+	    double cosm = cs(m, 0), sinm = cs(m, 1);
+	    int k = moffset;
 
-    auto v = cyl_eval(R, z, phi);
+	    den1 += ( sum(k, 0)*cosm + sum(k+1, 0)*sinm) * norm1;
+	    pot1 += ( sum(k, 1)*cosm + sum(k+1, 1)*sinm) * norm1;
+	    ppot += (-sum(k, 1)*sinm + sum(k+1, 1)*cosm) * m * norm1;
+	    rpot += ( sum(k, 2)*cosm + sum(k+1, 2)*sinm) * norm1;
+	    zpot += ( sum(k, 3)*cosm + sum(k+1, 3)*sinm) * norm1;
+
+	    moffset +=2;
+	  }
+	}
+
+	den0 *= -1.0;
+	den1 *= -1.0;
+	pot0 *= -1.0;
+	pot1 *= -1.0;
+	rpot *= -1.0;
+	zpot *= -1.0;
+	ppot *= -1.0;
+      }
 
-    double potx = v[4]*x/R - v[8]*y/R;
-    double poty = v[4]*y/R + v[8]*x/R;
+      double v[9] = {den0, den1, den0+den1, pot0, pot1, pot0+pot1,
+		     rpot, zpot, ppot};
 
-    return {v[0], v[1], v[2], v[3], v[4], v[5], potx, poty, v[7]};
+      // Force components in the requested coordinates
+      //
+      if (ctype == Coord::Spherical) {
+	v[6] = rpot*sinth + zpot*costh;
+	v[7] = rpot*costh - zpot*sinth;
+      } else if (ctype == Coord::Cartesian) {
+	double x = x1[i], y = x2[i];
+	v[6] = rpot*x/R - ppot*y/R;
+	v[7] = rpot*y/R + ppot*x/R;
+	v[8] = zpot;
+      }
+
+      for (int k=0; k<9; k++) out[i + ldo*k] = v[k];
+    }
   }
 
   std::vector<Eigen::MatrixXd> FlatDisk::orthoCheck()
@@ -2102,6 +2247,18 @@ namespace BasisClasses
     imy = 2*nmaxy + 1;		// y wave numbers
     imz = nmaxz;		// z basis count
 
+    // Vertical basis tables, one row per wave number pair kx >= ky
+    //
+    int npair = (nnmax+1)*(nnmax+2)/2;
+
+    vpot.resize(nthrds);
+    vfrc.resize(nthrds);
+    vden.resize(nthrds);
+
+    for (auto & v : vpot) v.resize(npair, nmaxz);
+    for (auto & v : vfrc) v.resize(npair, nmaxz);
+    for (auto & v : vden) v.resize(npair, nmaxz);
+
     // Coefficient tensor
     //
     expcoef.resize(imx, imy, imz);
@@ -2243,8 +2400,29 @@ namespace BasisClasses
     }
   }
   
+  void Slab::tabulate(double z, int tid)
+  {
+    int nnmax = std::max<int>(nmaxx, nmaxy);
+
+    auto & tpot = vpot[tid];
+    auto & tfrc = vfrc[tid];
+    auto & tden = vden[tid];
+
+    Eigen::VectorXd work(nmaxz);
+
+    // One row per wave number pair with kx >= ky
+    //
+    for (int kx=0, l=0; kx<=nnmax; kx++) {
+      for (int ky=0; ky<=kx; ky++, l++) {
+	ortho->get_pot  (work, z, kx, ky); tpot.row(l) = work;
+	ortho->get_force(work, z, kx, ky); tfrc.row(l) = work;
+	ortho->get_dens (work, z, kx, ky); tden.row(l) = work;
+      }
+    }
+  }
+
   std::tuple<double, double, double, double, double>
-  Slab::eval(double x, double y, double z)
+  Slab::eval(double x, double y, int tid)
   {
     // Loop indices
     //
@@ -2268,8 +2446,6 @@ namespace BasisClasses
     std::complex<double> startx = exp(-static_cast<double>(nmaxx)*kfac*x);
     std::complex<double> starty = exp(-static_cast<double>(nmaxy)*kfac*y);
     
-    Eigen::VectorXd vpot(nmaxz), vfrc(nmaxz), vden(nmaxz);
-
     for (facx=startx, ix=0; ix<imx; ix++, facx*=stepx) {
       
       // Compute wavenumber; recall that the coefficients are stored
@@ -2283,34 +2459,20 @@ namespace BasisClasses
 	int jj = iy - nmaxy;
 	int iiy = abs(jj);
 	
-	if (iix > nmaxx) {
-	  std::cerr << "Out of bounds: ii=" << ii << std::endl;
-	}
-	if (iiy > nmaxy) {
-	  std::cerr << "Out of bounds: jj=" << jj << std::endl;
-	}
-	
-	if (iix>=iiy) {
-	  ortho->get_pot  (vpot, z, iix, iiy);
-	  ortho->get_force(vfrc, z, iix, iiy);
-	  ortho->get_dens (vden, z, iix, iiy);
-	}
-	else {
-	  ortho->get_pot  (vpot, z, iiy, iix);
-	  ortho->get_force(vfrc, z, iiy, iix);
-	  ortho->get_dens (vden, z, iiy, iix);
-	}
+	// Limit to minimum wave number
+	//
+	if (iix<nminx || iiy<nminy) continue;
+
+	// Table row for the wave number pair
+	//
+	int kx = std::max<int>(iix, iiy), ky = std::min<int>(iix, iiy);
+	int l  = kx*(kx+1)/2 + ky;
 
-	
 	for (int iz=0; iz<imz; iz++) {
 	  
-	  fac  = facx*facy*vpot[iz]*expcoef(ix, iy, iz);
-	  facf = facx*facy*vfrc[iz]*expcoef(ix, iy, iz);
-	  facd = facx*facy*vden[iz]*expcoef(ix, iy, iz);
-	  
-	  // Limit to minimum wave number
-	  //
-	  if (abs(ii)<nminx || abs(jj)<nminy) continue;
+	  fac  = facx*facy*vpot[tid](l, iz)*expcoef(ix, iy, iz);
+	  facf = facx*facy*vfrc[tid](l, iz)*expcoef(ix, iy, iz);
+	  facd = facx*facy*vden[tid](l, iz)*expcoef(ix, iy, iz);
 	  
 	  potl +=  fac;
 	  dens +=  facd;
@@ -2326,58 +2488,87 @@ namespace BasisClasses
   }
 
 
-
   std::vector<double> Slab::crt_eval(double x, double y, double z)
   {
-    // Get thread id
-    int tid = omp_get_thread_num();
-
-    auto [pot, den, frcx, frcy, frcz] = eval(x, y, z);
-
-    return {0, den, den, 0, pot, pot, frcx, frcy, frcz};
+    std::vector<double> ret(9);
+    batch_eval(&x, &y, &z, 1, Coord::Cartesian, ret.data(), 1);
+    return ret;
   }
 
   std::vector<double> Slab::cyl_eval(double R, double z, double phi)
   {
-    // Get thread id
-    int tid = omp_get_thread_num();
-
-    // Cartesian from Cylindrical coordinates
-    double x = R*cos(phi), y = R*sin(phi);
-
-    auto [pot, den, frcx, frcy, frcz] = eval(x, y, z);
-
-    double potR =  frcx*cos(phi) + frcy*sin(phi);
-    double potp = -frcx*sin(phi) + frcy*cos(phi);
-    double potz =  frcz;
-
-    potR *= -1;
-    potp *= -1;
-    potz *= -1;
-
-    return {0, den, den, 0, pot, pot, potR, potz, potp};
+    std::vector<double> ret(9);
+    batch_eval(&R, &z, &phi, 1, Coord::Cylindrical, ret.data(), 1);
+    return ret;
   }
 
   std::vector<double> Slab::sph_eval(double r, double costh, double phi)
+  {
+    std::vector<double> ret(9);
+    batch_eval(&r, &costh, &phi, 1, Coord::Spherical, ret.data(), 1);
+    return ret;
+  }
+
+  void Slab::batch_eval(const double* x1, const double* x2,
+			const double* x3, int num, const Coord ctype,
+			double* out, int ldo)
   {
     // Get thread id
     int tid = omp_get_thread_num();
 
-    // Spherical from Cylindrical coordinates
-    double sinth = sqrt(fabs(1.0 - costh*costh));
-    double x = r*cos(phi)*sinth, y = r*sin(phi)*sinth, z = r*costh;
+    // The vertical basis tables are only recomputed when z changes
+    // between consecutive points, e.g. along each row of a slice at
+    // fixed height
+    //
+    double lastz = std::numeric_limits<double>::quiet_NaN();
+
+    for (int i=0; i<num; i++) {
+
+      double x, y, z, cosp = 0.0, sinp = 0.0, costh = 0.0, sinth = 0.0;
+
+      if (ctype == Coord::Spherical) {
+	// Cartesian from spherical coordinates
+	costh = x2[i];
+	sinth = sqrt(fabs(1.0 - costh*costh));
+	cosp  = cos(x3[i]);
+	sinp  = sin(x3[i]);
+	x = x1[i]*cosp*sinth;
+	y = x1[i]*sinp*sinth;
+	z = x1[i]*costh;
+      } else if (ctype == Coord::Cylindrical) {
+	// Cartesian from cylindrical coordinates
+	cosp = cos(x3[i]);
+	sinp = sin(x3[i]);
+	x = x1[i]*cosp;
+	y = x1[i]*sinp;
+	z = x2[i];
+      } else {
+	x = x1[i];
+	y = x2[i];
+	z = x3[i];
+      }
 
-    auto [pot, den, frcx, frcy, frcz] = eval(x, y, z);
+      if (z != lastz) {
+	tabulate(z, tid);
+	lastz = z;
+      }
 
-    double potr =  frcx*cos(phi)*sinth + frcy*sin(phi)*sinth + frcz*costh;
-    double pott =  frcx*cos(phi)*costh + frcy*sin(phi)*costh - frcz*sinth;
-    double potp = -frcx*sin(phi)       + frcy*cos(phi);
+      auto [pot, den, frcx, frcy, frcz] = eval(x, y, tid);
 
-    potr *= -1;
-    pott *= -1;
-    potp *= -1;
-    
-    return {0, den, den, 0, pot, pot, potr, pott, potp};
+      double v[9] = {0, den, den, 0, pot, pot, frcx, frcy, frcz};
+
+      if (ctype == Coord::Spherical) {
+	v[6] = -(frcx*cosp*sinth + frcy*sinp*sinth + frcz*costh);
+	v[7] = -(frcx*cosp*costh + frcy*sinp*costh - frcz*sinth);
+	v[8] = -(-frcx*sinp      + frcy*cosp);
+      } else if (ctype == Coord::Cylindrical) {
+	v[6] = -( frcx*cosp + frcy*sinp);
+	v[7] = -frcz;
+	v[8] = -(-frcx*sinp + frcy*cosp);
+      }
+
+      for (int k=0; k<9; k++) out[i + ldo*k] = v[k];
+    }
   }
 
 
@@ -2665,86 +2856,80 @@ namespace BasisClasses
   
   std::vector<double> Cube::crt_eval(double x, double y, double z)
   {
-    // Get thread id
-    int tid = omp_get_thread_num();
-
-    // Position vector
-    Eigen::Vector3d pos {x, y, z};
-
-    // Get the basis fields
-    double den1 = ortho->get_dens(expcoef, pos).real();
-    double pot1 = ortho->get_pot (expcoef, pos).real();
-
-    auto frc = ortho->get_force(expcoef, pos);
-    
-    double frcx = -frc(0).real();
-    double frcy = -frc(1).real();
-    double frcz = -frc(2).real();
-
-    return {0, den1, den1, 0, pot1, pot1, frcx, frcy, frcz};
+    std::vector<double> ret(9);
+    batch_eval(&x, &y, &z, 1, Coord::Cartesian, ret.data(), 1);
+    return ret;
   }
 
   std::vector<double> Cube::cyl_eval(double R, double z, double phi)
   {
-    // Get thread id
-    int tid = omp_get_thread_num();
-
-    // Cartesian from Cylindrical coordinates
-    double x = R*cos(phi), y = R*sin(phi);
-
-    // Position vector
-    Eigen::Vector3d pos {x, y, z};
-
-    // Get the basis fields
-    double den1 = ortho->get_dens(expcoef, pos).real();
-    double pot1 = ortho->get_pot (expcoef, pos).real();
-
-    auto frc = ortho->get_force(expcoef, pos);
-    
-    double frcx = frc(0).real(), frcy = frc(1).real(), frcz = frc(2).real();
-
-    double potR =  frcx*cos(phi) + frcy*sin(phi);
-    double potp = -frcx*sin(phi) + frcy*cos(phi);
-    double potz =  frcz;
-
-    potR *= -1;
-    potp *= -1;
-    potz *= -1;
-
-    return {0, den1, den1, 0, pot1, pot1, potR, potz, potp};
+    std::vector<double> ret(9);
+    batch_eval(&R, &z, &phi, 1, Coord::Cylindrical, ret.data(), 1);
+    return ret;
   }
 
   std::vector<double> Cube::sph_eval(double r, double costh, double phi)
   {
-    // Get thread id
-    int tid = omp_get_thread_num();
-
-    // Spherical from Cylindrical coordinates
-    double sinth = sqrt(fabs(1.0 - costh*costh));
-    double x = r*cos(phi)*sinth, y = r*sin(phi)*sinth, z = r*costh;
-
-    // Position vector
-    Eigen::Vector3d pos {x, y, z};
-
-    // Get the basis fields
-    double den1 = ortho->get_dens(expcoef, pos).real();
-    double pot1 = ortho->get_pot (expcoef, pos).real();
+    std::vector<double> ret(9);
+    batch_eval(&r, &costh, &phi, 1, Coord::Spherical, ret.data(), 1);
+    return ret;
+  }
 
-    auto frc = ortho->get_force(expcoef, pos);
-    
-    double frcx = frc(0).real();
-    double frcy = frc(1).real();
-    double frcz = frc(2).real();
+  void Cube::batch_eval(const double* x1, const double* x2,
+			const double* x3, int num, const Coord ctype,
+			double* out, int ldo)
+  {
+    std::complex<double> pot, den;
+    Eigen::Vector3cd frc;
+
+    for (int i=0; i<num; i++) {
+
+      double x, y, z, cosp = 0.0, sinp = 0.0, costh = 0.0, sinth = 0.0;
+
+      if (ctype == Coord::Spherical) {
+	// Cartesian from spherical coordinates
+	costh = x2[i];
+	sinth = sqrt(fabs(1.0 - costh*costh));
+	cosp  = cos(x3[i]);
+	sinp  = sin(x3[i]);
+	x = x1[i]*cosp*sinth;
+	y = x1[i]*sinp*sinth;
+	z = x1[i]*costh;
+      } else if (ctype == Coord::Cylindrical) {
+	// Cartesian from cylindrical coordinates
+	cosp = cos(x3[i]);
+	sinp = sin(x3[i]);
+	x = x1[i]*cosp;
+	y = x1[i]*sinp;
+	z = x2[i];
+      } else {
+	x = x1[i];
+	y = x2[i];
+	z = x3[i];
+      }
 
-    double potr =  frcx*cos(phi)*sinth + frcy*sin(phi)*sinth + frcz*costh;
-    double pott =  frcx*cos(phi)*costh + frcy*sin(phi)*costh - frcz*sinth;
-    double potp = -frcx*sin(phi)       + frcy*cos(phi);
+      // All fields from one pass over the coefficients
+      //
+      Eigen::Vector3d pos {x, y, z};
+      ortho->get_fields(expcoef, pos, pot, den, frc);
+
+      double den1 = den.real(), pot1 = pot.real();
+      double frcx = frc(0).real(), frcy = frc(1).real(), frcz = frc(2).real();
+
+      double v[9] = {0, den1, den1, 0, pot1, pot1, -frcx, -frcy, -frcz};
+
+      if (ctype == Coord::Spherical) {
+	v[6] = -(frcx*cosp*sinth + frcy*sinp*sinth + frcz*costh);
+	v[7] = -(frcx*cosp*costh + frcy*sinp*costh - frcz*sinth);
+	v[8] = -(-frcx*sinp      + frcy*cosp);
+      } else if (ctype == Coord::Cylindrical) {
+	v[6] = -( frcx*cosp + frcy*sinp);
+	v[7] = -frcz;
+	v[8] = -(-frcx*sinp + frcy*cosp);
+      }
 
-    potr *= -1;
-    pott *= -1;
-    potp *= -1;
-    
-    return {0, den1, den1, 0, pot1, pot1, potr, pott, potp};
+      for (int k=0; k<9; k++) out[i + ldo*k] = v[k];
+    }
   }
 
   Eigen::MatrixXcd Cube::orthoCheck()
@@ -97,6 +97,39 @@ namespace CoefClasses
     bool H5back = true;
     if (file.hasAttribute("CoefficientOutputVersion")) H5back = false;
 
+    // Pack the data into the coefficient variable
+    //
+    auto pack = [&](double Time, const std::vector<double>& ctr,
+		    const Eigen::MatrixXcd& in)
+    {
+      auto coef = std::make_shared<SphStruct>();
+      
+      if (ctr.size()) coef->ctr = ctr;
+
+      coef->lmax  = Lmax;
+      coef->nmax  = Nmax;
+      coef->time  = Time;
+      coef->scale = scale;
+      coef->geom  = geometry;
+      coef->id    = forceID;
+
+      coef->allocate();
+      *coef->coefs = in;
+      
+      coefs[roundTime(Time)] = coef;
+    };
+
+    // Time-contiguous layout
+    //
+    if (isH5Chunked(file)) {
+      for (auto & v : ReadH5Chunked(file, stride, Tmin, Tmax))
+	pack(std::get<0>(v), std::get<1>(v), std::get<2>(v));
+
+      times.clear();
+      for (auto t : coefs) times.push_back(t.first);
+      return;
+    }
+
     // Open the snapshot group
     //
     auto snaps = file.getGroup("snapshots");
@@ -137,23 +170,7 @@ namespace CoefClasses
 	}
       }
       
-      // Pack the data into the coefficient variable
-      //
-      auto coef = std::make_shared<SphStruct>();
-      
-      if (ctr.size()) coef->ctr = ctr;
-
-      coef->lmax  = Lmax;
-      coef->nmax  = Nmax;
-      coef->time  = Time;
-      coef->scale = scale;
-      coef->geom  = geometry;
-      coef->id    = forceID;
-
-      coef->allocate();
-      *coef->coefs = in;
-      
-      coefs[roundTime(Time)] = coef;
+      pack(Time, ctr, in);
     }
 
     times.clear();
@@ -804,6 +821,36 @@ namespace CoefClasses
     bool H5back = true;
     if (file.hasAttribute("CoefficientOutputVersion")) H5back = false;
 
+    // Pack the data into the coefficient variable
+    //
+    auto pack = [&](double Time, const std::vector<double>& ctr,
+		    Eigen::MatrixXcd& in)
+    {
+      // Work around for previous unitiaized data bug; enforces real data
+      //
+      for (int n=0; n<Nmax; n++) in(0, n) = std::real(in(0, n));
+
+      auto coef = std::make_shared<CylStruct>();
+      
+      if (ctr.size()) coef->ctr = ctr;
+
+      coef->assign(in, Mmax, Nmax);
+      coef->time = Time;
+      
+      coefs[roundTime(Time)] = coef;
+    };
+
+    // Time-contiguous layout
+    //
+    if (isH5Chunked(file)) {
+      for (auto & v : ReadH5Chunked(file, stride, Tmin, Tmax))
+	pack(std::get<0>(v), std::get<1>(v), std::get<2>(v));
+
+      times.clear();
+      for (auto t : coefs) times.push_back(t.first);
+      return;
+    }
+
     // Open the snapshot group
     //
     auto snaps = file.getGroup("snapshots");
@@ -844,20 +891,7 @@ namespace CoefClasses
 	}
       }
       
-      // Work around for previous unitiaized data bug; enforces real data
-      //
-      for (int n=0; n<Nmax; n++) in(0, n) = std::real(in(0, n));
-
-      // Pack the data into the coefficient variable
-      //
-      auto coef = std::make_shared<CylStruct>();
-      
-      if (ctr.size()) coef->ctr = ctr;
-
-      coef->assign(in, Mmax, Nmax);
-      coef->time = Time;
-      
-      coefs[roundTime(Time)] = coef;
+      pack(Time, ctr, in);
     }
 
     times.clear();
@@ -2297,7 +2331,9 @@ namespace CoefClasses
       
       // Write the Version string
       //
-      file.createAttribute<std::string>("CoefficientOutputVersion", HighFive::DataSpace::From(CoefficientOutputVersion)).write(CoefficientOutputVersion);
+      bool chunked = H5chunked and H5Shape().size()==2;
+      const std::string & version = chunked ? CoefficientChunkedVersion : CoefficientOutputVersion;
+      file.createAttribute<std::string>("CoefficientOutputVersion", HighFive::DataSpace::From(version)).write(version);
 
       // We write the coefficient file geometry
       //
@@ -2321,20 +2357,28 @@ namespace CoefClasses
       unsigned count = 0;
       HighFive::DataSet dataset = file.createDataSet("count", count);
       
-      // Create a new group for coefficient snapshots
-      //
-      HighFive::Group group = file.createGroup("snapshots");
+      if (chunked) {
+	// Write the time-contiguous datasets
+	//
+	WriteH5Chunked(file);
+	count = Times().size();
+      } else {
+	// Create a new group for coefficient snapshots
+	//
+	HighFive::Group group = file.createGroup("snapshots");
       
-      // Write the coefficients
-      //
-      count = WriteH5Times(group, count);
+	// Write the coefficients
+	//
+	count = WriteH5Times(group, count);
+      }
       
       // Update the count
       //
       dataset.write(count);
       
     } catch (HighFive::Exception& err) {
-      std::cerr << err.what() << std::endl;
+      throw std::runtime_error("Coefs::WriteH5Coefs: error writing <" +
+			       prefix + ">, " + err.what());
     }
     
   }
@@ -2352,21 +2396,259 @@ namespace CoefClasses
       unsigned count;
       dataset.read(count);
       
-      HighFive::Group group = file.getGroup("snapshots");
+      if (isH5Chunked(file)) {
+	// Append to the time-contiguous datasets
+	//
+	WriteH5Chunked(file);
+	count += Times().size();
+      } else {
+	HighFive::Group group = file.getGroup("snapshots");
       
-      // Write the coefficients
-      //
-      count = WriteH5Times(group, count);
+	// Write the coefficients
+	//
+	count = WriteH5Times(group, count);
+      }
       
       // Update the count
       //
       dataset.write(count);
       
     } catch (HighFive::Exception& err) {
-      std::cerr << err.what() << std::endl;
+      throw std::runtime_error("Coefs::ExtendH5Coefs: error extending <" +
+			       prefix + ">, " + err.what());
     }
     
+  }  
+
+  bool Coefs::isH5Chunked(HighFive::File& file)
+  {
+    if (not file.hasAttribute("CoefficientOutputVersion")) return false;
+
+    std::string version;
+    file.getAttribute("CoefficientOutputVersion").read(version);
+
+    return version == CoefficientChunkedVersion;
+  }
+
+  void Coefs::WriteH5Chunked(HighFive::File& file)
+  {
+    auto shape = H5Shape();
+    if (shape.size() != 2)
+      throw CoefsError("Coefs::WriteH5Chunked: geometry <" + geometry +
+		       "> does not support the chunked layout");
+
+    const size_t H = shape[0], N = shape[1];
+
+    auto T = Times();
+
+    if (not file.exist("coefficients")) {
+      // Extendible in time, one chunk per H5chunkT snapshots
+      //
+      const size_t U = HighFive::DataSpace::UNLIMITED;
+
+      HighFive::DataSetCreateProps cprops;
+      cprops.add(HighFive::Chunking(std::vector<hsize_t>{H5chunkT, H, N}));
+      if (H5compress>0) {
+	cprops.add(HighFive::Shuffle());
+	cprops.add(HighFive::Deflate(H5compress));
+      }
+
+      file.createDataSet<std::complex<double>>
+	("coefficients", HighFive::DataSpace({0, H, N}, {U, H, N}), cprops);
+
+      HighFive::DataSetCreateProps tprops;
+      tprops.add(HighFive::Chunking(std::vector<hsize_t>{1024}));
+
+      file.createDataSet<double>
+	("times", HighFive::DataSpace({0}, {U}), tprops);
+
+      // Centers are stored if the first snapshot has one
+      //
+      if (T.size() and getCoefStruct(T[0])->ctr.size()==3) {
+	HighFive::DataSetCreateProps pprops;
+	pprops.add(HighFive::Chunking(std::vector<hsize_t>{1024, 3}));
+	file.createDataSet<double>
+	  ("centers", HighFive::DataSpace({0, 3}, {U, 3}), pprops);
+      }
+    }
+
+    auto coefs  = file.getDataSet("coefficients");
+    auto times  = file.getDataSet("times");
+    bool hasCtr = file.exist("centers");
+
+    auto dims = coefs.getDimensions();
+    if (dims[1] != H or dims[2] != N)
+      throw CoefsError("Coefs::WriteH5Chunked: snapshot dimensions do not "
+		       "match the existing file");
+
+    if (T.size()==0) return;
+
+    const size_t T0 = times.getDimensions()[0], nT = T.size();
+
+    coefs.resize({T0+nT, H, N});
+    times.resize({T0+nT});
+    if (hasCtr) file.getDataSet("centers").resize({T0+nT, 3});
+
+    // Write in blocks of whole chunks
+    //
+    using Vec3 = std::vector<std::vector<std::vector<std::complex<double>>>>;
+
+    for (size_t b=0; b<nT; b+=H5chunkT) {
+      size_t nb = std::min<size_t>(H5chunkT, nT-b);
+
+      Vec3 buf(nb, std::vector<std::vector<std::complex<double>>>
+	       (H, std::vector<std::complex<double>>(N)));
+      std::vector<double> tbuf(nb);
+      std::vector<std::vector<double>> cbuf(nb, std::vector<double>(3, 0.0));
+
+      for (size_t i=0; i<nb; i++) {
+	auto C = getCoefStruct(T[b+i]);
+	tbuf[i] = C->time;
+	// The store is column major (harmonic x radial)
+	for (size_t n=0; n<N; n++) {
+	  for (size_t h=0; h<H; h++) buf[i][h][n] = C->store(h + H*n);
+	}
+	if (C->ctr.size()==3) cbuf[i] = C->ctr;
+      }
+
+      coefs.select({T0+b, 0, 0}, {nb, H, N}).write(buf);
+      times.select({T0+b}, {nb}).write(tbuf);
+      if (hasCtr)
+	file.getDataSet("centers").select({T0+b, 0}, {nb, 3}).write(cbuf);
+    }
   }
+
+  // Index range of the snapshots in [tmin, tmax].  Times are written
+  // in increasing order so the window is contiguous.
+  //
+  static std::pair<size_t, size_t>
+  timeWindow(const std::vector<double>& T, double tmin, double tmax)
+  {
+    size_t i0 = 0, i1 = T.size();
+    while (i0<i1 and T[i0]   < tmin) i0++;
+    while (i1>i0 and T[i1-1] > tmax) i1--;
+    return {i0, i1};
+  }
+
+  std::vector<Coefs::H5Snap>
+  Coefs::ReadH5Chunked(HighFive::File& file, int stride,
+		       double tmin, double tmax)
+  {
+    std::vector<double> T;
+    file.getDataSet("times").read(T);
+
+    auto coefs = file.getDataSet("coefficients");
+    auto dims  = coefs.getDimensions();
+    const size_t H = dims[1], N = dims[2];
+
+    bool hasCtr = file.exist("centers");
+
+    if (stride<1) stride = 1;
+
+    auto [i0, i1] = timeWindow(T, tmin, tmax);
+
+    std::vector<H5Snap> ret;
+
+    using Vec3 = std::vector<std::vector<std::vector<std::complex<double>>>>;
+
+    for (size_t b=i0; b<i1; b+=H5chunkT) {
+      size_t nb = std::min<size_t>(H5chunkT, i1-b);
+
+      Vec3 buf;
+      coefs.select({b, 0, 0}, {nb, H, N}).read(buf);
+
+      std::vector<std::vector<double>> cbuf;
+      if (hasCtr)
+	file.getDataSet("centers").select({b, 0}, {nb, 3}).read(cbuf);
+
+      for (size_t i=0; i<nb; i++) {
+	size_t n = b + i;
+	if (n % stride) continue;
+
+	Eigen::MatrixXcd mat(H, N);
+	for (size_t h=0; h<H; h++) {
+	  for (size_t k=0; k<N; k++) mat(h, k) = buf[i][h][k];
+	}
+
+	std::vector<double> ctr;
+	if (hasCtr) ctr = cbuf[i];
+
+	ret.emplace_back(T[n], ctr, mat);
+      }
+    }
+
+    return ret;
+  }
+
+  std::tuple<std::vector<double>, E3d>
+  Coefs::ReadH5Window(const std::string& file, double tmin, double tmax,
+		      const std::vector<unsigned>& harmonics,
+		      const std::vector<unsigned>& radial)
+  {
+    HighFive::File h5file(file, HighFive::File::ReadOnly);
+
+    if (not isH5Chunked(h5file))
+      throw CoefsError("Coefs::ReadH5Window: <" + file + "> does not use "
+		       "the chunked layout; use Coefs::factory");
+
+    std::vector<double> T;
+    h5file.getDataSet("times").read(T);
+
+    auto coefs = h5file.getDataSet("coefficients");
+    auto dims  = coefs.getDimensions();
+    const size_t H = dims[1], N = dims[2];
+
+    // Requested channels
+    //
+    std::vector<unsigned> rows(harmonics), cols(radial);
+    if (rows.empty()) for (size_t h=0; h<H; h++) rows.push_back(h);
+    if (cols.empty()) for (size_t n=0; n<N; n++) cols.push_back(n);
+
+    for (auto h : rows)
+      if (h>=H) throw CoefsError("Coefs::ReadH5Window: harmonic index out of range");
+    for (auto n : cols)
+      if (n>=N) throw CoefsError("Coefs::ReadH5Window: radial index out of range");
+
+    auto [i0, i1] = timeWindow(T, tmin, tmax);
+    const size_t nt = i1 - i0;
+
+    std::vector<double> times(T.begin()+i0, T.begin()+i1);
+    E3d ret(nt, rows.size(), cols.size());
+
+    using Vec3 = std::vector<std::vector<std::vector<std::complex<double>>>>;
+
+    if (nt) {
+      if (harmonics.empty()) {
+	// All harmonics: read whole chunks
+	//
+	for (size_t b=i0; b<i1; b+=H5chunkT) {
+	  size_t nb = std::min<size_t>(H5chunkT, i1-b);
+	  Vec3 buf;
+	  coefs.select({b, 0, 0}, {nb, H, N}).read(buf);
+	  for (size_t i=0; i<nb; i++) {
+	    for (size_t r=0; r<rows.size(); r++) {
+	      for (size_t c=0; c<cols.size(); c++)
+		ret(b-i0+i, r, c) = buf[i][rows[r]][cols[c]];
+	    }
+	  }
+	}
+      } else {
+	// One hyperslab per requested harmonic
+	//
+	for (size_t r=0; r<rows.size(); r++) {
+	  Vec3 buf;
+	  coefs.select({i0, rows[r], 0}, {nt, 1, N}).read(buf);
+	  for (size_t i=0; i<nt; i++) {
+	    for (size_t c=0; c<cols.size(); c++)
+	      ret(i, r, c) = buf[i][0][cols[c]];
+	  }
+	}
+      }
+    }
+
+    return {times, ret};
+  }
+
   
   void CylCoefs::add(CoefStrPtr coef)
   {
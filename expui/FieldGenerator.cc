@@ -83,6 +83,36 @@ namespace Field
     }
   }
   
+  void FieldGenerator::eval_block(BasisClasses::BasisPtr basis,
+				  BasisClasses::Basis::Coord ctype,
+				  double* x, double* y, double* z, int n,
+				  double* out)
+  {
+    if (ctype == BasisClasses::Basis::Coord::Spherical) {
+      for (int i=0; i<n; i++) {
+	double r     = sqrt(x[i]*x[i] + y[i]*y[i] + z[i]*z[i]) + 1.0e-18;
+	double costh = z[i]/r;
+	double phi   = atan2(y[i], x[i]);
+	x[i] = r;
+	y[i] = costh;
+	z[i] = phi;
+      }
+    } else if (ctype == BasisClasses::Basis::Coord::Cylindrical) {
+      for (int i=0; i<n; i++) {
+	double R     = sqrt(x[i]*x[i] + y[i]*y[i]) + 1.0e-18;
+	double phi   = atan2(y[i], x[i]);
+	double zz    = z[i];
+	x[i] = R;
+	y[i] = zz;
+	z[i] = phi;
+      }
+    } else {
+      ctype = BasisClasses::Basis::Coord::Cartesian;
+    }
+
+    basis->batch_eval(x, y, z, n, ctype, out, n);
+  }
+
   std::map<double, std::map<std::string, Eigen::VectorXf>>
   FieldGenerator::lines
   (BasisClasses::BasisPtr basis, CoefClasses::CoefsPtr coefs,
@@ -137,38 +167,39 @@ namespace Field
 
 	basis->set_coefs(coefs->getCoefStruct(T));
 
-	double r, phi, costh, R;
-	double p0, p1, d0, d1, f1, f2, f3;
-      
-#pragma omp parallel for
-	for (int ncnt=0; ncnt<num; ncnt++) {
+	int nblock = (num + block - 1)/block;
+	int nfield = std::max<int>(labels.size(), 10);
 
-	  double x = beg[0] + dd[0]*ncnt;
-	  double y = beg[1] + dd[1]*ncnt;
-	  double z = beg[2] + dd[2]*ncnt;
-	  
-	  std::vector<double> v;
-
-	  if (ctype == BasisClasses::Basis::Coord::Spherical) {
-	    r     = sqrt(x*x + y*y + z*z) + 1.0e-18;
-	    costh = z/r;
-	    phi   = atan2(y, x);
-	    v = (*basis)(r, costh, phi, ctype);
-	  } else if (ctype == BasisClasses::Basis::Coord::Cylindrical) {
-	    R     = sqrt(x*x + y*y) + 1.0e-18;
-	    phi   = atan2(y, x);
-	    v = (*basis)(R, z, phi, ctype);
-	  } else {		// A default
-	    ctype = BasisClasses::Basis::Coord::Cartesian;
-	    v = (*basis)(x, y, z, ctype);
-	  }
-	  
-	  frame["x"      ](ncnt) = x;
-	  frame["y"      ](ncnt) = y;
-	  frame["z"      ](ncnt) = z;
-	  frame["arc"    ](ncnt) = dlen*ncnt;
+#pragma omp parallel
+	{
+	  std::vector<double> x(block), y(block), z(block), v(block*nfield);
+
+#pragma omp for schedule(dynamic)
+	  for (int b=0; b<nblock; b++) {
+
+	    int n0 = b*block;
+	    int cnt = std::min<int>(block, num - n0);
+
+	    for (int i=0; i<cnt; i++) {
+	      int ncnt = n0 + i;
+
+	      x[i] = beg[0] + dd[0]*ncnt;
+	      y[i] = beg[1] + dd[1]*ncnt;
+	      z[i] = beg[2] + dd[2]*ncnt;
 
-	  for (int n=0; n<labels.size(); n++) frame[labels[n]](ncnt) = v[n];
+	      frame["x"  ](ncnt) = x[i];
+	      frame["y"  ](ncnt) = y[i];
+	      frame["z"  ](ncnt) = z[i];
+	      frame["arc"](ncnt) = dlen*ncnt;
+	    }
+
+	    eval_block(basis, ctype, x.data(), y.data(), z.data(), cnt, v.data());
+
+	    for (int n=0; n<labels.size(); n++) {
+	      auto & f = frame[labels[n]];
+	      for (int i=0; i<cnt; i++) f(n0+i) = v[i + cnt*n];
+	    }
+	  }
 	}
 
 	ret[T] = frame;
@@ -381,53 +412,39 @@ namespace Field
 
       basis->set_coefs(coefs->getCoefStruct(T));
 
-      int totpix = grid[i1] * grid[i2];
+      int nrow   = grid[i2];
+      int nfield = std::max<int>(labels.size(), 10);
 
-#pragma omp parallel for
-      for (int k=0; k<totpix; k++) {
+      // Evaluate one row of the slice at a time
+      //
+#pragma omp parallel
+      {
+	std::vector<double> x(nrow), y(nrow), z(nrow), v(nrow*nfield);
+	std::vector<double> pp(pos);
 
-	// Create the pair of indices from the pixel number
-	//
-	int i = k/grid[i2];
-	int j = k - i*grid[i2];
+#pragma omp for schedule(dynamic)
+	for (int i=0; i<grid[i1]; i++) {
 
-	// Compute the coordinates from the indices
-	//
-	std::vector<double> pp(pos);
+	  // Compute the coordinates from the indices
+	  //
+	  pp[i1] = pmin[i1] + del[i1]*i;
+
+	  for (int j=0; j<nrow; j++) {
+	    pp[i2] = pmin[i2] + del[i2]*j;
+	    x[j] = pp[0];
+	    y[j] = pp[1];
+	    z[j] = pp[2];
+	  }
 
-	pp[i1] = pmin[i1] + del[i1]*i;
-	pp[i2] = pmin[i2] + del[i2]*j;
+	  eval_block(basis, ctype, x.data(), y.data(), z.data(), nrow, v.data());
 
-	// Cartesian to spherical for all_eval
-	//
-	double x = pp[0];
-	double y = pp[1];
-	double z = pp[2];
-
-	// Coordinate values
-	double r, costh, phi, R;
-
-	// Return values
-	double p0, p1, d0, d1, f1, f2, f3;
-	std::vector<double> v;
-
-	if (ctype == BasisClasses::Basis::Coord::Spherical) {
-	  r     = sqrt(x*x + y*y + z*z) + 1.0e-18;
-	  costh = z/r;
-	  phi   = atan2(y, x);
-	  v = (*basis)(r, costh, phi, ctype);
-	} else if (ctype == BasisClasses::Basis::Coord::Cylindrical) {
-	  R     = sqrt(x*x + y*y) + 1.0e-18;
-	  phi   = atan2(y, x);
-	  v = (*basis)(R, z, phi, ctype);
-	} else {
-	  v = (*basis)(x, y, z, BasisClasses::Basis::Coord::Cartesian);
+	  // Pack the frame structure
+	  //
+	  for (int n=0; n<labels.size(); n++) {
+	    auto & f = frame[labels[n]];
+	    for (int j=0; j<nrow; j++) f(i, j) = v[j + nrow*n];
+	  }
 	}
-	
-	// Pack the frame structure
-	//
-	for (int n=0; n<labels.size(); n++)
-	  frame[labels[n]](i, j) = v[n];
       }
 
       ret[T] = frame;
@@ -581,43 +598,42 @@ namespace Field
 
       basis->set_coefs(coefs->getCoefStruct(T));
 
-      int totpix = grid[0] * grid[1] * grid[2];
+      int nrow   = grid[1];
+      int totrow = grid[0] * grid[2];
+      int nfield = std::max<int>(labels.size(), 10);
 
-#pragma omp parallel for
-      for (int n=0; n<totpix; n++) {
+      // Evaluate rows in y at fixed (x, z) so that bases which
+      // tabulate in z can reuse their vertical functions
+      //
+#pragma omp parallel
+      {
+	std::vector<double> x(nrow), y(nrow), z(nrow), v(nrow*nfield);
 
-	// Unpack the index triple by integer division
-	//
-	int i = n/(grid[1]*grid[2]);
-	int j = (n - i*grid[1]*grid[2])/grid[2];
-	int k = n - (i*grid[1] + j)*grid[2];
+#pragma omp for schedule(dynamic)
+	for (int n=0; n<totrow; n++) {
 
-	// Compute the coordinates from the indices
-	//
-	double x = pmin[0] + del[0]*i;
-	double y = pmin[1] + del[1]*j;
-	double z = pmin[2] + del[2]*k;
-	    
-	std::vector<double> v;
-
-	if (ctype == BasisClasses::Basis::Coord::Spherical) {
-	  double r     = sqrt(x*x + y*y + z*z) + 1.0e-18;
-	  double costh = z/r;
-	  double phi   = atan2(y, x);
-	  v = (*basis)(r, costh, phi, ctype);
-	} else if (ctype == BasisClasses::Basis::Coord::Cylindrical) {
-	  double R     = sqrt(x*x + y*y) + 1.0e-18;
-	  double phi   = atan2(y, x);
-	  v = (*basis)(R, z, phi, ctype);
-	} else {
-	  ctype = BasisClasses::Basis::Coord::Cartesian;
-	  v = (*basis)(x, y, z, ctype);
-	}
+	  // Unpack the index pair by integer division
+	  //
+	  int i = n/grid[2];
+	  int k = n - i*grid[2];
 
-	// Pack the frame structure
-	//
-	for (int n=0; n<labels.size(); n++)
-	  frame[labels[n]](i, j, k) = v[n];
+	  // Compute the coordinates from the indices
+	  //
+	  for (int j=0; j<nrow; j++) {
+	    x[j] = pmin[0] + del[0]*i;
+	    y[j] = pmin[1] + del[1]*j;
+	    z[j] = pmin[2] + del[2]*k;
+	  }
+
+	  eval_block(basis, ctype, x.data(), y.data(), z.data(), nrow, v.data());
+
+	  // Pack the frame structure
+	  //
+	  for (int l=0; l<labels.size(); l++) {
+	    auto & f = frame[labels[l]];
+	    for (int j=0; j<nrow; j++) f(i, j, k) = v[j + nrow*l];
+	  }
+	}
       }
 
       ret[T] = frame;
@@ -940,39 +956,35 @@ namespace Field
 
       basis->set_coefs(coefs->getCoefStruct(T));
 
-#pragma omp parallel for
-      for (int k=0; k<mesh.rows(); k++) {
+      int npts   = mesh.rows();
+      int nblock = (npts + block - 1)/block;
+      int nfield = std::max<int>(labels.size(), 10);
 
-	// Cartesian to spherical for all_eval
-	//
-	double x = mesh(k, 0);
-	double y = mesh(k, 1);
-	double z = mesh(k, 2);
-
-	// Coordinate values
-	double r, costh, phi, R;
-
-	// Return values
-	double p0, p1, d0, d1, f1, f2, f3;
-	std::vector<double> v;
-
-	if (ctype == BasisClasses::Basis::Coord::Spherical) {
-	  r     = sqrt(x*x + y*y + z*z) + 1.0e-18;
-	  costh = z/r;
-	  phi   = atan2(y, x);
-	  v = (*basis)(r, costh, phi, ctype);
-	} else if (ctype == BasisClasses::Basis::Coord::Cylindrical) {
-	  R     = sqrt(x*x + y*y) + 1.0e-18;
-	  phi   = atan2(y, x);
-	  v = (*basis)(R, z, phi, ctype);
-	} else {
-	  v = (*basis)(x, y, z, BasisClasses::Basis::Coord::Cartesian);
+#pragma omp parallel
+      {
+	std::vector<double> x(block), y(block), z(block), v(block*nfield);
+
+#pragma omp for schedule(dynamic)
+	for (int b=0; b<nblock; b++) {
+
+	  int n0  = b*block;
+	  int cnt = std::min<int>(block, npts - n0);
+
+	  for (int i=0; i<cnt; i++) {
+	    x[i] = mesh(n0+i, 0);
+	    y[i] = mesh(n0+i, 1);
+	    z[i] = mesh(n0+i, 2);
+	  }
+
+	  eval_block(basis, ctype, x.data(), y.data(), z.data(), cnt, v.data());
+
+	  // Pack the frame structure
+	  //
+	  for (int n=0; n<labels.size(); n++) {
+	    auto & f = frame[labels[n]];
+	    for (int i=0; i<cnt; i++) f(n0+i) = v[i + cnt*n];
+	  }
 	}
-	
-	// Pack the frame structure
-	//
-	for (int n=0; n<labels.size(); n++)
-	  frame[labels[n]](k) = v[n];
       }
 
       ret[T] = frame;
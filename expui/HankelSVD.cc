@@ -0,0 +1,247 @@
+#include <algorithm>
+#include <random>
+#include <cmath>
+
+#include <omp.h>
+
+#include <HankelSVD.H>
+
+namespace MSSA
+{
+  // Smallest integer >= n with no prime factors other than 2, 3, 5
+  //
+  static int fftSize(int n)
+  {
+    for (int m=std::max<int>(n, 1); ; m++) {
+      int r = m;
+      for (int p : {2, 3, 5}) while (r % p == 0) r /= p;
+      if (r==1) return m;
+    }
+  }
+
+  // Thin orthonormal basis for the columns of A
+  //
+  static Eigen::MatrixXd orthonormal(const Eigen::MatrixXd& A)
+  {
+    Eigen::HouseholderQR<Eigen::MatrixXd> qr(A);
+    return qr.householderQ() * Eigen::MatrixXd::Identity(A.rows(), A.cols());
+  }
+
+  HankelSVD::HankelSVD(const std::vector<const std::vector<double>*>& channels,
+		       int numW) : numW(numW)
+  {
+    nkeys = channels.size();
+    numT  = nkeys ? channels[0]->size() : 0;
+    numK  = numT - numW + 1;
+
+    if (nkeys==0 or numW<1 or numK<1)
+      throw std::runtime_error("HankelSVD: no channels or bad window length");
+
+    // A transform of length >= numT has no wrap around for the
+    // correlations and convolutions below
+    //
+    nfft  = fftSize(numT);
+    nfreq = nfft/2 + 1;
+
+    std::vector<double> work(nfft);
+    std::vector<std::complex<double>> freq(nfreq);
+
+    fwd = fftw_plan_dft_r2c_1d(nfft, work.data(),
+			       reinterpret_cast<fftw_complex*>(freq.data()),
+			       FFTW_ESTIMATE | FFTW_UNALIGNED);
+
+    bwd = fftw_plan_dft_c2r_1d(nfft,
+			       reinterpret_cast<fftw_complex*>(freq.data()),
+			       work.data(),
+			       FFTW_ESTIMATE | FFTW_UNALIGNED);
+
+    // Transform the channels and compute the Frobenius norm: x_n[m]
+    // appears once on each of the min(m+1, numT-m, numW, numK)
+    // antidiagonal elements
+    //
+    X.resize(nkeys);
+    norm2 = 0.0;
+
+    for (int n=0; n<nkeys; n++) {
+      const auto & x = *channels[n];
+      if (x.size() != static_cast<size_t>(numT))
+	throw std::runtime_error("HankelSVD: channels differ in length");
+
+      X[n].resize(nfreq);
+      forward(x.data(), numT, X[n].data(), work);
+
+      for (int m=0; m<numT; m++) {
+	int cnt = std::min<int>({m+1, numT-m, numW, numK});
+	norm2 += x[m]*x[m]*cnt;
+      }
+    }
+  }
+
+  HankelSVD::~HankelSVD()
+  {
+    fftw_destroy_plan(fwd);
+    fftw_destroy_plan(bwd);
+  }
+
+  void HankelSVD::forward(const double* x, int n, std::complex<double>* out,
+			  std::vector<double>& work)
+  {
+    std::copy(x, x+n, work.begin());
+    std::fill(work.begin()+n, work.end(), 0.0);
+    fftw_execute_dft_r2c(fwd, work.data(),
+			 reinterpret_cast<fftw_complex*>(out));
+  }
+
+  void HankelSVD::backward(std::vector<std::complex<double>>& in, double* out)
+  {
+    fftw_execute_dft_c2r(bwd, reinterpret_cast<fftw_complex*>(in.data()), out);
+  }
+
+  Eigen::MatrixXd HankelSVD::multiply(const Eigen::MatrixXd& V)
+  {
+    if (V.rows() != cols())
+      throw std::runtime_error("HankelSVD::multiply: dimension mismatch");
+
+    Eigen::MatrixXd ret(numK, V.cols());
+
+    // (Y*V)(i, c) = sum_n sum_j x_n[i+j] V(numW*n+j, c) is a sum of
+    // correlations, so the spectra are summed before the inverse
+    //
+#pragma omp parallel
+    {
+      std::vector<double> work(nfft);
+      std::vector<std::complex<double>> freq(nfreq), sum(nfreq);
+
+#pragma omp for
+      for (int c=0; c<V.cols(); c++) {
+	std::fill(sum.begin(), sum.end(), 0.0);
+
+	for (int n=0; n<nkeys; n++) {
+	  Eigen::VectorXd v = V.block(numW*n, c, numW, 1);
+	  forward(v.data(), numW, freq.data(), work);
+	  for (int k=0; k<nfreq; k++) sum[k] += X[n][k]*std::conj(freq[k]);
+	}
+
+	backward(sum, work.data());
+	for (int i=0; i<numK; i++) ret(i, c) = work[i]/nfft;
+      }
+    }
+
+    return ret;
+  }
+
+  Eigen::MatrixXd HankelSVD::adjoint(const Eigen::MatrixXd& W)
+  {
+    if (W.rows() != numK)
+      throw std::runtime_error("HankelSVD::adjoint: dimension mismatch");
+
+    Eigen::MatrixXd ret(cols(), W.cols());
+
+    // (Y^T*W)(numW*n+j, c) = sum_i x_n[i+j] W(i, c)
+    //
+#pragma omp parallel
+    {
+      std::vector<double> work(nfft);
+      std::vector<std::complex<double>> wfreq(nfreq), prod(nfreq);
+
+#pragma omp for
+      for (int c=0; c<W.cols(); c++) {
+	Eigen::VectorXd w = W.col(c);
+	forward(w.data(), numK, wfreq.data(), work);
+
+	for (int n=0; n<nkeys; n++) {
+	  for (int k=0; k<nfreq; k++) prod[k] = X[n][k]*std::conj(wfreq[k]);
+	  backward(prod, work.data());
+	  for (int j=0; j<numW; j++) ret(numW*n+j, c) = work[j]/nfft;
+	}
+      }
+    }
+
+    return ret;
+  }
+
+  std::tuple<Eigen::VectorXd, Eigen::MatrixXd>
+  HankelSVD::svd(int rank, int oversample, int iter)
+  {
+    int l = std::min<int>({rank + oversample, rows(), cols()});
+    int r = std::min<int>(rank, l);
+
+    // Gaussian test matrix with a fixed seed so that repeated
+    // analyses give the same result
+    //
+    std::mt19937 gen(11);
+    std::normal_distribution<double> norm;
+
+    Eigen::MatrixXd Omega(numK, l);
+    for (int j=0; j<l; j++)
+      for (int i=0; i<numK; i++) Omega(i, j) = norm(gen);
+
+    // Range of Y^T with power iterations to sharpen the spectrum
+    //
+    Eigen::MatrixXd Q = orthonormal(adjoint(Omega));
+
+    for (int it=0; it<iter; it++)
+      Q = orthonormal(adjoint(orthonormal(multiply(Q))));
+
+    // Y ~ (Y*Q)*Q^T, so the right singular vectors are Q times those
+    // of the small matrix Y*Q
+    //
+    Eigen::MatrixXd B = multiply(Q);
+    Eigen::BDCSVD<Eigen::MatrixXd> svd(B, Eigen::ComputeThinV);
+
+    Eigen::VectorXd S = svd.singularValues().head(r);
+    Eigen::MatrixXd V = Q * svd.matrixV().leftCols(r);
+
+    return {S, V};
+  }
+
+  void HankelSVD::setPC(const Eigen::MatrixXd& PC)
+  {
+    P.resize(PC.cols());
+
+#pragma omp parallel
+    {
+      std::vector<double> work(nfft);
+
+#pragma omp for
+      for (int w=0; w<PC.cols(); w++) {
+	Eigen::VectorXd pc = PC.col(w);
+	P[w].resize(nfreq);
+	forward(pc.data(), numK, P[w].data(), work);
+      }
+    }
+  }
+
+  Eigen::MatrixXd HankelSVD::diagonalAverage(const Eigen::MatrixXd& rho)
+  {
+    int ncomp = std::min<int>(rho.cols(), P.size());
+
+    Eigen::MatrixXd ret(numT, rho.cols());
+    ret.setZero();
+
+    // RC(i, w) = sum_j PC(i-j, w) rho(j, w) / (number of terms)
+    //
+#pragma omp parallel
+    {
+      std::vector<double> work(nfft);
+      std::vector<std::complex<double>> freq(nfreq);
+
+#pragma omp for
+      for (int w=0; w<ncomp; w++) {
+	if (rho.col(w).isZero(0.0)) continue;
+
+	Eigen::VectorXd r = rho.col(w);
+	forward(r.data(), numW, freq.data(), work);
+	for (int k=0; k<nfreq; k++) freq[k] *= P[w][k];
+	backward(freq, work.data());
+
+	for (int i=0; i<numT; i++) {
+	  int cnt = std::min<int>({i+1, numT-i, numW, numK});
+	  ret(i, w) = work[i]/nfft/cnt;
+	}
+      }
+    }
+
+    return ret;
+  }
+}
@@ -46,6 +46,7 @@
 
 #include <Koopman.H>
 
+#include <BrandSVD.H>
 #include <RedSVD.H>
 #include <YamlConfig.H>
 #include <YamlCheck.H>
@@ -125,15 +126,26 @@ namespace MSSA {
       V = svd.matrixV();
     }
 
+    X1V = X1 * V;
+
+    koopman_modes();
+
+    computed = true;
+    reconstructed = false;
+  }
+
+  // Koopman matrix, eigenvalues and modes from U, S and X1*V
+  //
+  void Koopman::koopman_modes()
+  {
     // Compute the approximation to the Koopman operator for the rank
     // reduced approximation
     //
     Eigen::MatrixXd D = S.asDiagonal();
 
-    // E.g. Tu et al. 2014, equation 4 (parens to enforce effficient
-    // order)
+    // E.g. Tu et al. 2014, equation 4
     //
-    A = U.transpose() * (X1 * V) * D.inverse();
+    A = U.transpose() * X1V * D.inverse();
 
     // Now compute the eigenvalues and eigenvectors
     //
@@ -158,10 +170,81 @@ namespace MSSA {
     // This is the exact mode from Tu et al. 2014, equation 9
     //
     else {
-      Phi = Linv.asDiagonal() * X1 * V * D.inverse() * W;
+      Phi = Linv.asDiagonal() * X1V * D.inverse() * W;
     }
-    
-    computed = true;
+  }
+
+  void Koopman::update(const mssaConfig& config)
+  {
+    CoefContainer db(config, spec);
+
+    // The new series must extend the current one
+    //
+    int newT = db.times.size();
+
+    if (newT < numT or
+	(numT and fabs(db.times[numT-1] - coefDB.times[numT-1]) > 1.0e-8)) {
+      throw std::runtime_error("Koopman::update: the new coefficients do not "
+			       "extend the current time series");
+    }
+
+    if (db.getKeys() != coefDB.getKeys()) {
+      throw std::runtime_error("Koopman::update: key list mismatch");
+    }
+
+    if (newT == numT) return;
+
+    for (auto & u : data) {
+      auto & y = db.getData(u.first);
+      u.second.insert(u.second.end(), y.begin()+numT, y.end());
+    }
+
+    int T0 = numT;
+
+    coefDB = db;
+    numT   = newT;
+
+    // The analysis will be done on first use
+    //
+    if (not computed) return;
+
+    // New input and output snapshots
+    //
+    int c = numT - T0;
+
+    Eigen::MatrixXd C0(nkeys, c), C1(nkeys, c);
+
+    int n=0;
+    for (auto & u : data) {
+      for (int j=0; j<c; j++) {
+	C0(n, j) = u.second[T0-1+j];
+	C1(n, j) = u.second[T0+j];
+      }
+      n++;
+    }
+
+    X0.conservativeResize(Eigen::NoChange, numT-1);
+    X1.conservativeResize(Eigen::NoChange, numT-1);
+    X0.rightCols(c) = C0;
+    X1.rightCols(c) = C1;
+
+    // Rank-k update of the SVD of X0.  With V' = [[V, 0], [0, I]]*R,
+    // the product X1*V' is [X1*V, C1]*R.
+    //
+    int k = S.size();
+    Eigen::MatrixXd R = svdAppend(U, S, C0, U.cols());
+
+    Eigen::MatrixXd Vn(V.rows()+c, R.cols());
+    Vn.topRows(V.rows()) = V * R.topRows(k);
+    Vn.bottomRows(c)     = R.bottomRows(c);
+    V = Vn;
+
+    Eigen::MatrixXd XC(nkeys, k+c);
+    XC << X1V, C1;
+    X1V = XC * R;
+
+    koopman_modes();
+
     reconstructed = false;
   }
 
@@ -803,6 +886,8 @@ namespace MSSA {
       W   = analysis.getDataSet("W"  ).read<Eigen::MatrixXcd>();
       Y   = analysis.getDataSet("Y"  ).read<Eigen::MatrixXd >();
 
+      X1V = X1 * V;
+
       computed = true;
 
     } catch (HighFive::Exception& err) {
@@ -829,6 +914,7 @@ namespace MSSA {
 
     // Now open and parse the coefficient files
     //
+    spec   = flags;
     coefDB = CoefContainer(config, flags);
 
     numT = coefDB.times.size();
@@ -39,6 +39,7 @@
 
 #include <expMSSA.H>
 
+#include <BrandSVD.H>
 #include <RedSVD.H>
 #include <YamlConfig.H>
 #include <YamlCheck.H>
@@ -214,6 +215,13 @@ namespace MSSA {
 
     numK = numT - numW + 1;
 
+    // Never form the trajectory matrix
+    //
+    if (params["Hankel"]) {
+      hankel_analysis();
+      return;
+    }
+
     Y.resize(numK, numW*nkeys);
     Y.fill(0.0);
 
@@ -352,8 +360,10 @@ namespace MSSA {
       for (int i=0; i<S.size(); i++) S(i) = S(i)*S(i)/numK;
     }
 
-    double tot = 0.0;
-    for (int j=0; j<S.size(); j++) tot += S(j);
+    // The total variance from the full trajectory matrix, since the
+    // randomized SVD only finds the leading eigenvalues
+    //
+    totEV = Y.squaredNorm()/numK;
 
     npc = std::min<int>(npc, numW*nkeys);
 
@@ -365,6 +375,164 @@ namespace MSSA {
     reconstructed = false;
   }
 
+  void expMSSA::makeHankel()
+  {
+    std::vector<const std::vector<double>*> channels;
+    for (auto k : mean) channels.push_back(&data[k.first]);
+
+    hankel = std::make_shared<HankelSVD>(channels, numW);
+  }
+
+  // Randomized SVD of the trajectory matrix using only FFT-based
+  // products.  The covariance analysis has the same eigenvectors, so
+  // the 'Traj' flag is not used here.
+  //
+  void expMSSA::hankel_analysis()
+  {
+    makeHankel();
+
+    if (hankel->norm()<=0.0) {
+      std::cout << "Frobenius norm of trajectory matrix is <= 0!" << std::endl;
+      exit(-1);
+    }
+
+    // The rank defaults to the number of requested PCs rather than
+    // the full rank
+    //
+    int srank = std::min<int>(hankel->rows(), hankel->cols());
+    if (params["rank"])
+      srank = std::min<int>(srank, params["rank"].as<int>());
+    else
+      srank = std::min<int>(srank, npc);
+
+    npc = std::min<int>(npc, srank);
+
+    int iter = 2;
+    if (params["powerIter"]) iter = params["powerIter"].as<int>();
+
+    std::tie(S, U) = hankel->svd(srank, 10, iter);
+
+    for (int i=0; i<S.size(); i++) S(i) = S(i)*S(i)/numK;
+
+    // S holds only the leading srank eigenvalues; the total variance
+    // is the squared Frobenius norm
+    //
+    totEV = hankel->norm()*hankel->norm()/numK;
+
+    std::cout << "shape U = " << U.rows() << " x "
+	      << U.cols() << std::endl;
+
+    // The trajectory matrix is never formed
+    //
+    Y.resize(0, 0);
+
+    // Compute the PCs by projecting the data
+    //
+    PC = hankel->multiply(U);
+
+    computed = true;
+    reconstructed = false;
+  }
+
+  void expMSSA::update(const mssaConfig& config)
+  {
+    CoefContainer db(config, spec);
+
+    // The new series must extend the current one
+    //
+    int newT = db.times.size();
+
+    if (newT < numT or
+	(numT and fabs(db.times[numT-1] - coefDB.times[numT-1]) > 1.0e-8)) {
+      throw std::runtime_error("expMSSA::update: the new coefficients do not "
+			       "extend the current time series");
+    }
+
+    if (db.getKeys() != coefDB.getKeys()) {
+      throw std::runtime_error("expMSSA::update: key list mismatch");
+    }
+
+    if (newT == numT) return;
+
+    // Detrend the new slices with the original mean and variance
+    //
+    for (auto & u : mean) {
+      Key k = u.first;
+      auto & y = db.getData(k);
+      for (int t=numT; t<newT; t++) {
+	double v = y[t];
+	if (type == TrendType::totPow) {
+	  if (useMean) v -= mean[k];
+	  v /= totPow;
+	} else if (type == TrendType::totVar) {
+	  v -= mean[k];
+	  if (totVar>0.0) v /= totVar;
+	} else {
+	  v -= mean[k];
+	  if (var[k]>0.0) v /= var[k];
+	}
+	data[k].push_back(v);
+      }
+    }
+
+    coefDB = db;
+    numT   = newT;
+
+    // The analysis will be done on first use
+    //
+    if (not computed) return;
+
+    // New rows of the trajectory matrix for the fixed window, stored
+    // as columns
+    //
+    int numK0 = numK;
+    numK = numT - numW + 1;
+    int c = numK - numK0;
+
+    Eigen::MatrixXd C(numW*nkeys, c);
+    {
+      size_t n=0;
+      for (auto k : mean) {
+	for (int j=0; j<numW; j++) {
+	  for (int i=0; i<c; i++)
+	    C(numW*n+j, i) = data[k.first][numK0 + i + j];
+	}
+	n++;
+      }
+    }
+
+    // S holds the eigenvalues sigma^2/numK
+    //
+    Eigen::VectorXd sig(S.size());
+    for (int i=0; i<S.size(); i++)
+      sig(i) = std::sqrt(std::max<double>(S(i), 0.0)*numK0);
+
+    svdAppend(U, sig, C, U.cols());
+
+    S.resize(sig.size());
+    for (int i=0; i<sig.size(); i++) S(i) = sig(i)*sig(i)/numK;
+
+    totEV = (totEV*numK0 + C.squaredNorm())/numK;
+
+    // Project the full series onto the updated basis.  For a
+    // truncated basis the old rows of the trajectory matrix are not
+    // in the span of the old U, so the old PCs can not simply be
+    // rotated.
+    //
+    if (Y.size()) {
+      Y.conservativeResize(numK, Eigen::NoChange);
+      Y.bottomRows(c) = C.transpose();
+      PC = Y * U;
+    } else {
+      // The FFT operator for the longer series
+      //
+      makeHankel();
+      PC = hankel->multiply(U);
+    }
+
+    reconstructed = false;
+  }
+
   void expMSSA::reconstruct(const std::vector<int>& evlist)
   {
     // Prevent a belly-up situation
@@ -419,6 +587,17 @@ namespace MSSA {
 	n++;
       }
 
+      // Diagonal averaging by FFT convolution
+      //
+      if (params["Hankel"]) {
+	if (not hankel) makeHankel();
+	hankel->setPC(PC.leftCols(ncomp));
+	for (auto u : mean) RC[u.first] = hankel->diagonalAverage(rho[u.first]);
+
+	reconstructed = true;
+	return;
+      }
+
 #pragma omp parallel
       if (useOpenMP) {
 	// Parallelize the map iteration by wrapping it in a standard loop.
@@ -1255,7 +1434,9 @@ namespace MSSA {
     "output",
     "totVar",
     "totPow",
-    "noMean"
+    "noMean",
+    "Hankel",
+    "powerIter"
   };
 
   void expMSSA::assignParameters(const std::string flags)
@@ -1366,8 +1547,9 @@ namespace MSSA {
       //
       HighFive::Group analysis = file.createGroup("mssa_analysis");
 
-      analysis.createDataSet("Y",  Y );
+      if (Y.size()) analysis.createDataSet("Y",  Y );
       analysis.createDataSet("S",  S );
+      analysis.createAttribute<double>("totEV", HighFive::DataSpace::From(totEV)).write(totEV);
       analysis.createDataSet("U",  U );
       analysis.createDataSet("PC", PC);
 
@@ -1511,8 +1693,13 @@ namespace MSSA {
 
       auto analysis = h5file.getGroup("mssa_analysis");
 
-      Y  = analysis.getDataSet("Y" ).read<Eigen::MatrixXd>();
+      if (analysis.exist("Y"))
+	Y  = analysis.getDataSet("Y" ).read<Eigen::MatrixXd>();
       S  = analysis.getDataSet("S" ).read<Eigen::VectorXd>();
+      if (analysis.hasAttribute("totEV"))
+	analysis.getAttribute("totEV").read(totEV);
+      else
+	totEV = S.sum();	// Older state files
       U  = analysis.getDataSet("U" ).read<Eigen::MatrixXd>();
       PC = analysis.getDataSet("PC").read<Eigen::MatrixXd>();
 
@@ -1589,6 +1776,7 @@ namespace MSSA {
 
     // Now open and parse the coefficient files
     //
+    spec   = flags;
     coefDB = CoefContainer(config, flags);
 
     numT = coefDB.times.size();
@@ -266,7 +266,7 @@ BiorthCube::get_force(const BiorthCube::coefType& c, Eigen::Vector3d x)
 	double norm = 1.0/sqrt(M_PI*ii.dot(ii));
 
 	for (int k=0; k<3; k++)
-	  force(k) -= std::complex<double>(0.0, dfac*i(k))*fac*norm;
+	  force(k) -= std::complex<double>(0.0, dfac*ii(k))*fac*norm;
       }
     }
   }
@@ -274,6 +274,62 @@ BiorthCube::get_force(const BiorthCube::coefType& c, Eigen::Vector3d x)
   return force;
 }
 
+// Potential, density and force in one pass
+void
+BiorthCube::get_fields(const BiorthCube::coefType& c, Eigen::Vector3d x,
+		       std::complex<double>& potl, std::complex<double>& dens,
+		       Eigen::Vector3cd& force)
+{
+  potl  = 0.0;
+  dens  = 0.0;
+  force.setZero();
+    
+  // Recursion multipliers and initial values
+  Eigen::Vector3cd step, init, curr;
+  Eigen::Vector3i i;
+
+  for (int k=0; k<3; k++) {
+    step(k) = std::exp(kfac*x(k));
+    init(k) = std::exp(-kfac*(x(k)*nmax(k)));
+  }
+    
+  curr(0) = init(0);
+  for (i(0)=0; i(0)<=2*nmax(0); i(0)++, curr(0)*=step(0)) {
+    curr(1) = init(1);
+    for (i(1)=0; i(1)<=2*nmax(1); i(1)++, curr(1)*=step(1)) {
+      curr(2) = init(2);
+      for (i(2)=0; i(2)<=2*nmax(2); i(2)++, curr(2)*=step(2)) {
+	
+	// Compute wavenumber; the coefficients are stored as:
+	// -nmax,-nmax+1,...,0,...,nmax-1,nmax
+	//
+	Eigen::Vector3i ii = i - nmax;
+
+	// No contribution to acceleration and potential ("swindle")
+	// for zero wavenumber
+	if (ii(0)==0 && ii(1)==0 && ii(2)==0) continue;
+	  
+	// Limit to minimum wave number
+	if (abs(ii(0)) > nmin(0) ||
+	    abs(ii(1)) > nmin(1) ||
+	    abs(ii(2)) > nmin(2)  ) continue;
+	  
+	auto fac = curr(0)*curr(1)*curr(2)*c(i(0), i(1), i(2));
+
+	// Normalization
+	double k2   = M_PI*ii.dot(ii);
+	double norm = 1.0/sqrt(k2);
+
+	potl += fac*norm;
+	dens -= fac*sqrt(k2);
+
+	for (int k=0; k<3; k++)
+	  force(k) -= std::complex<double>(0.0, dfac*ii(k))*fac*norm;
+      }
+    }
+  }
+}
+
 Eigen::MatrixXcd BiorthCube::orthoCheck()
 {
   Eigen::Vector3i d {2*nmax(0)+1, 2*nmax(1)+1, 2*nmax(2)+1};
@@ -110,6 +110,10 @@ BiorthCyl::BiorthCyl(const YAML::Node& conf) : conf(conf)
     if (conf["EVEN_M"])      EVEN_M = conf["EVEN_M"].as<bool>();
     else                     EVEN_M = false;
 
+    if (conf["shared_tables"])
+                             shared_tables = conf["shared_tables"].as<bool>();
+    else                     shared_tables = false;
+
     if (conf["diskconf"])    diskconf  = conf["diskconf"];
     else throw std::runtime_error("BiorthCyl: you must specify the diskconf stanza");
   }
@@ -150,23 +154,32 @@ void BiorthCyl::initialize()
   ymax    = z_to_yi(rcylmax*scale);
   dy      = (ymax - ymin)/(numy-1);
 
-  dens   .resize(mmax+1);
-  pot    .resize(mmax+1);
-  rforce .resize(mmax+1);
-  zforce .resize(mmax+1);
+  allocate(shared_tables);
+}
 
-  for (int m=0; m<=mmax; m++) {
+void BiorthCyl::allocate(bool shared)
+{
+  shared = shared and use_mpi and NodeShared::available();
 
-    dens  [m].resize(nmax);
-    pot   [m].resize(nmax);
-    rforce[m].resize(nmax);
-    zforce[m].resize(nmax);
+  const size_t gsize = static_cast<size_t>(numx)*numy;
 
-    for (int n=0; n<nmax; n++) {
-      dens  [m][n].resize(numx, numy);
-      pot   [m][n].resize(numx, numy);
-      rforce[m][n].resize(numx, numy);
-      zforce[m][n].resize(numx, numy);
+  // Release the old views before the old block
+  //
+  for (auto a : {&dens, &pot, &rforce, &zforce}) a->clear();
+  if (gridBlock) gridBlock->release();
+
+  gridBlock = std::make_shared<NodeShared::Block>(gsize*4*(mmax+1)*nmax,
+						  shared);
+  double *p = gridBlock->data();
+
+  for (auto a : {&dens, &pot, &rforce, &zforce}) {
+    a->resize(mmax+1);
+    for (int m=0; m<=mmax; m++) {
+      (*a)[m].reserve(nmax);
+      for (int n=0; n<nmax; n++) {
+	(*a)[m].emplace_back(p, numx, numy);
+	p += gsize;
+      }
     }
   }
 }
@@ -179,6 +192,11 @@ void BiorthCyl::create_tables()
 
   if (conf["basis"]) emp.basisTest(true);
 
+  // Every process fills part of the grid and the parts are summed
+  // below, so compute into private storage
+  //
+  if (gridBlock->isShared()) allocate(false);
+
   std::shared_ptr<progress::progress_display> progress;
 
   if (myid==0) {
@@ -256,6 +274,16 @@ void BiorthCyl::create_tables()
     }
   }
 
+  // Move the completed tables to node-shared storage
+  //
+  if (shared_tables and use_mpi and NodeShared::available()) {
+    auto work = gridBlock;
+    allocate(true);
+    if (gridBlock->writer())
+      std::copy(work->data(), work->data() + work->size(), gridBlock->data());
+    gridBlock->sync();
+  }
+
   if (myid==0) {
     std::cout << "---- BiorthCyl::create_tables: done!"
 	      << std::endl;
@@ -349,8 +377,8 @@ double BiorthCyl::d_yi_to_z(double y)
 
 // Matrix interpolation on grid for n-body
 void BiorthCyl::interp(double R, double Z,
-		       const std::vector<std::vector<Eigen::MatrixXd>>& mat,
-		       Eigen::MatrixXd& ret, bool anti_symmetric)
+		       const GridArray& mat, Eigen::MatrixXd& ret,
+		       bool anti_symmetric)
 {
   ret.resize(mmax+1, nmax);
   ret.setZero();
@@ -415,8 +443,7 @@ void BiorthCyl::interp(double R, double Z,
 
 
 double BiorthCyl::interp(int m, int n, double R, double Z,
-			 const std::vector<std::vector<Eigen::MatrixXd>>& mat,
-			 bool anti_symmetric)
+			 const GridArray& mat, bool anti_symmetric)
 {
   double ret = 0.0;
 
@@ -504,10 +531,10 @@ void BiorthCyl::WriteH5Arrays(HighFive::Group& harmonic)
       sout << n;
       auto arrays = order.createGroup(sout.str());
 
-      HighFive::DataSet ds1 = arrays.createDataSet<Eigen::MatrixXd>("density",   dens  [m][n]);
-      HighFive::DataSet ds2 = arrays.createDataSet("potential", pot   [m][n]);
-      HighFive::DataSet ds3 = arrays.createDataSet("rforce",    rforce[m][n]);
-      HighFive::DataSet ds4 = arrays.createDataSet("zforce",    zforce[m][n]);
+      HighFive::DataSet ds1 = arrays.createDataSet("density",   Eigen::MatrixXd(dens  [m][n]));
+      HighFive::DataSet ds2 = arrays.createDataSet("potential", Eigen::MatrixXd(pot   [m][n]));
+      HighFive::DataSet ds3 = arrays.createDataSet("rforce",    Eigen::MatrixXd(rforce[m][n]));
+      HighFive::DataSet ds4 = arrays.createDataSet("zforce",    Eigen::MatrixXd(zforce[m][n]));
     }
   }
 }
@@ -524,10 +551,10 @@ void BiorthCyl::ReadH5Arrays(HighFive::Group& harmonic)
       sout << n;
       auto arrays = order.getGroup(sout.str());
 
-      arrays.getDataSet("density")  .read(dens  [m][n]);
-      arrays.getDataSet("potential").read(pot   [m][n]);
-      arrays.getDataSet("rforce")   .read(rforce[m][n]);
-      arrays.getDataSet("zforce")   .read(zforce[m][n]);
+      dens  [m][n] = arrays.getDataSet("density")  .read<Eigen::MatrixXd>();
+      pot   [m][n] = arrays.getDataSet("potential").read<Eigen::MatrixXd>();
+      rforce[m][n] = arrays.getDataSet("rforce")   .read<Eigen::MatrixXd>();
+      zforce[m][n] = arrays.getDataSet("zforce")   .read<Eigen::MatrixXd>();
     }
   }
 
@@ -579,6 +606,29 @@ void BiorthCyl::WriteH5Cache()
 }
   
 bool BiorthCyl::ReadH5Cache()
+{
+  // Root reads the cache and forwards the tables to the other
+  // processes, or only to the node leaders if the tables are shared
+  //
+  int ok = 0;
+  if (myid==0) ok = ReadH5Tables();
+  if (use_mpi) MPI_Bcast(&ok, 1, MPI_INT, 0, MPI_COMM_WORLD);
+  if (not ok) return false;
+
+  gridBlock->bcast();
+
+  // Create the basis instance
+  //
+  emp = EmpCyl2d(mmax, nmaxfid, nmax, knots, numr,
+		 rcylmin*scale, rcylmax*scale, 
+		 scale, cmapR, logr, diskconf, biorth);
+    
+  if (conf["basis"]) emp.basisTest(true);
+
+  return true;
+}
+
+bool BiorthCyl::ReadH5Tables()
 {
   // First attempt to read the file
   //
@@ -674,14 +724,6 @@ bool BiorthCyl::ReadH5Cache()
       std::cerr << "---- BiorthCyl::ReadH5Cache: "
 		<< "read <" << cachename << ">" << std::endl;
 
-    // Create the basis instance
-    //
-    emp = EmpCyl2d(mmax, nmaxfid, nmax, knots, numr,
-		   rcylmin*scale, rcylmax*scale, 
-		   scale, cmapR, logr, diskconf, biorth);
-    
-    if (conf["basis"]) emp.basisTest(true);
-
     return true;
     
   } catch (HighFive::Exception& err) {
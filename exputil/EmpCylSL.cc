@@ -51,6 +51,8 @@ bool     EmpCylSL::PCAEOF          = false;
 bool     EmpCylSL::PCADRY          = true;
 bool     EmpCylSL::logarithmic     = false;
 bool     EmpCylSL::enforce_limits  = false;
+bool     EmpCylSL::interleave      = false;
+bool     EmpCylSL::shared_tables   = false;
 int      EmpCylSL::CMAPR           = 1;
 int      EmpCylSL::CMAPZ           = 1;
 int      EmpCylSL::NUMX            = 256;
@@ -679,77 +681,16 @@ SphModTblPtr EmpCylSL::make_sl()
 
 void EmpCylSL::send_eof_grid()
 {
-
 #ifdef SEND_DEBUG
-  auto blab = [](auto& s, auto& t, auto id, auto m, auto v) {
-		 std::cout << "[" << id << "] " << s << "  " << t
-			     << " (" << m << ", " << v << ")" << std::endl;
-		 };
-  
   std::cout << "[" << myid << "] (MMAX, rank3)=("
 	    << MMAX << ", " << rank3 << ")" << std::endl;
-#else
-  auto blab = [](auto& s, auto& t, auto id, auto m, auto v) {};
 #endif
 
-  // Send to workers
-  // 
-  for (int m=0; m<=MMAX; m++) {
-
-    // Grids in X--Y
-    // 
-    for (int v=0; v<rank3; v++) {
-
-      blab("before", "potC", myid, m, v);
-      MPI_Bcast(potC[m][v].data(), potC[m][v].size(),
-		MPI_DOUBLE, 0, MPI_COMM_WORLD);
-      blab("after", "potC", myid, m, v);
-
-      blab("before", "rforceC", myid, m, v);
-      MPI_Bcast(rforceC[m][v].data(), rforceC[m][v].size(),
-		MPI_DOUBLE, 0, MPI_COMM_WORLD);
-      blab("after", "rforceC", myid, m, v);
-
-      blab("before", "zforceC", myid, m, v);
-      MPI_Bcast(zforceC[m][v].data(), zforceC[m][v].size(),
-		MPI_DOUBLE, 0, MPI_COMM_WORLD);
-      blab("after", "zforceC", myid, m, v);
-
-      blab("before", "densC", myid, m, v);
-      MPI_Bcast(densC[m][v].data(), densC[m][v].size(),
-		MPI_DOUBLE, 0, MPI_COMM_WORLD);
-      blab("after", "densC", myid, m, v);
-    }
-  }
-
-  for (int m=1; m<=MMAX; m++) {
-    
-    // Grids in X--Y
-    //
-    for (int v=0; v<rank3; v++) {
-
-      blab("before", "potS", myid, m, v);
-      MPI_Bcast(potS[m][v].data(), potS[m][v].size(),
-		MPI_DOUBLE, 0, MPI_COMM_WORLD);
-      blab("after", "potS", myid, m, v);
-
-      blab("before", "rforceS", myid, m, v);
-      MPI_Bcast(rforceS[m][v].data(), rforceS[m][v].size(),
-		MPI_DOUBLE, 0, MPI_COMM_WORLD);
-      blab("after", "rforceS", myid, m, v);
-
-      blab("before", "zforceS", myid, m, v);
-      MPI_Bcast(zforceS[m][v].data(), zforceS[m][v].size(),
-		MPI_DOUBLE, 0, MPI_COMM_WORLD);
-      blab("after", "zforceS", myid, m, v);
-
-      blab("before", "densS", myid, m, v);
-      MPI_Bcast(densS[m][v].data(), densS[m][v].size(),
-		MPI_DOUBLE, 0, MPI_COMM_WORLD);
-      blab("after", "densS", myid, m, v);
-    }
-      
-  }
+  // Send to workers.  The grids are one contiguous block so this is
+  // a single broadcast, and only to the node leaders if the grids are
+  // node shared.
+  //
+  gridBlock->bcast();
 }
 
 
@@ -868,6 +809,7 @@ int EmpCylSL::read_eof_file(const string& eof_file)
   ortho = std::make_shared<SLGridSph>(make_sl(), LMAX, NMAX, NUMR,
 					RMIN, RMAX*0.99, false, 1, 1.0);
 
+  allocate_grids(shared_tables);
   setup_eof();
   setup_accumulation();
 
@@ -889,11 +831,14 @@ int EmpCylSL::read_eof_file(const string& eof_file)
   eof_made = true;
   std::fill(coefs_made.begin(), coefs_made.end(), false);
 
+  make_cell_table();
+
   return 1;
 }
 
 int EmpCylSL::read_cache(void)
 {
+  allocate_grids(shared_tables);
   setup_table();
   setup_accumulation();
 
@@ -918,6 +863,8 @@ int EmpCylSL::read_cache(void)
   eof_made = true;
   std::fill(coefs_made.begin(), coefs_made.end(), false);
 
+  make_cell_table();
+
   return 1;
 }
 
@@ -1601,7 +1548,7 @@ void EmpCylSL::compute_eof_grid(int request_id, int m)
       } else {
 	potS   [m][n] = tpot[n];
 	rforceS[m][n] = trforce[n];
-	zforceS[m][n] = trforce[n];
+	zforceS[m][n] = tzforce[n];
 	densS  [m][n] = tdens[n];
       }
     }
@@ -1827,7 +1774,7 @@ void EmpCylSL::compute_even_odd(int request_id, int m)
       } else {
 	potS   [m][n] = tpot[n];
 	rforceS[m][n] = trforce[n];
-	zforceS[m][n] = trforce[n];
+	zforceS[m][n] = tzforce[n];
 	densS  [m][n] = tdens[n];
       }
     }
@@ -2048,46 +1995,10 @@ void EmpCylSL::setup_table()
   YMAX    = z_to_y( Rtable*ASCALE);
   dY      = (YMAX - YMIN)/NUMY;
 
-  potC    .resize(MMAX+1);
-  rforceC .resize(MMAX+1);
-  zforceC .resize(MMAX+1);
-  
-  potS    .resize(MMAX+1);
-  rforceS .resize(MMAX+1);
-  zforceS .resize(MMAX+1);
-  
-  densC   .resize(MMAX+1);
-  densS   .resize(MMAX+1);
-
-  for (int m=0; m<=MMAX; m++) {
-
-    potC[m]   .resize(rank3);
-    rforceC[m].resize(rank3);
-    zforceC[m].resize(rank3);
-    densC[m]  .resize(rank3);
-    
-    for (int v=0; v<rank3; v++) {
-      potC   [m][v].resize(NUMX+1, NUMY+1);
-      rforceC[m][v].resize(NUMX+1, NUMY+1);
-      zforceC[m][v].resize(NUMX+1, NUMY+1);
-      densC  [m][v].resize(NUMX+1, NUMY+1);
-    }
-  }
-  
-  for (int m=1; m<=MMAX; m++) {
-    
-    potS[m]   .resize(rank3);
-    rforceS[m].resize(rank3);
-    zforceS[m].resize(rank3);
-    densS[m]  .resize(rank3);
-    
-    for (int v=0; v<rank3; v++) {
-      potS   [m][v].resize(NUMX+1, NUMY+1);
-      rforceS[m][v].resize(NUMX+1, NUMY+1);
-      zforceS[m][v].resize(NUMX+1, NUMY+1);
-      densS  [m][v].resize(NUMX+1, NUMY+1);
-    }
-  }
+  // Keep grids that have already been allocated, possibly in shared
+  // memory, by read_cache() or make_eof()
+  //
+  if (not gridBlock) allocate_grids(false);
 
   vc.resize(nthrds);
   vs.resize(nthrds);
@@ -2098,6 +2009,109 @@ void EmpCylSL::setup_table()
 
 }
 
+void EmpCylSL::allocate_grids(bool shared)
+{
+  shared = shared and use_mpi and NodeShared::available();
+
+  const size_t csize = static_cast<size_t>(NUMX+1)*(NUMY+1);
+
+  // Four grids for each of m>=0 cosine and m>0 sine and order
+  //
+  const size_t need = csize*NORDER*4*(2*MMAX+1);
+
+  if (gridBlock and gridBlock->size()==need and gridBlock->isShared()==shared)
+    return;
+
+  // Release the old block first to avoid holding two copies
+  //
+  for (auto a : {&potC, &rforceC, &zforceC, &densC,
+		 &potS, &rforceS, &zforceS, &densS}) a->clear();
+  if (gridBlock) gridBlock->release();
+  gridBlock.reset();
+
+  gridBlock = std::make_shared<NodeShared::Block>(need, shared);
+
+  double *p = gridBlock->data();
+
+  auto view = [&](GridArray& a, int mmin)
+  {
+    a.resize(MMAX+1);
+    for (int m=mmin; m<=MMAX; m++) {
+      a[m].reserve(NORDER);
+      for (int n=0; n<NORDER; n++) {
+	a[m].emplace_back(p, NUMX+1, NUMY+1);
+	p += csize;
+      }
+    }
+  };
+
+  view(potC,    0);
+  view(rforceC, 0);
+  view(zforceC, 0);
+  view(densC,   0);
+
+  view(potS,    1);
+  view(rforceS, 1);
+  view(zforceS, 1);
+  view(densS,   1);
+
+  if (gridBlock->isShared()) {
+    if (gridBlock->writer())
+      std::fill(gridBlock->data(), gridBlock->data() + need, 0.0);
+    gridBlock->sync();
+  }
+}
+
+void EmpCylSL::make_cell_table()
+{
+  if (cellTab) cellTab->release();
+  cellTab.reset();
+
+  if (not interleave) return;
+
+  // Offset to each harmonic within a cell: four field blocks for
+  // m=0 and eight for m>0
+  //
+  cellOff.resize(MMAX+2);
+  cellOff[0] = 0;
+  for (int m=0; m<=MMAX; m++) cellOff[m+1] = cellOff[m] + (m ? 8 : 4)*rank3;
+  cellSize = cellOff[MMAX+1];
+
+  // The cell table follows the grids: one copy per node if the grids
+  // are shared.  Every node leader has the complete grids so each
+  // fills its own copy.
+  //
+  bool shared = gridBlock and gridBlock->isShared();
+
+  cellTab = std::make_shared<NodeShared::Block>
+    (static_cast<size_t>(NUMX+1)*(NUMY+1)*cellSize, shared);
+
+  for (int ix=0; ix<=NUMX and cellTab->writer(); ix++) {
+    for (int iy=0; iy<=NUMY; iy++) {
+
+      double *c = cellTab->data() + (static_cast<size_t>(ix)*(NUMY+1) + iy)*cellSize;
+
+      for (int m=0; m<=MMAX; m++) {
+	double *t = c + cellOff[m];
+	for (int n=0; n<rank3; n++) {
+	  t[0*rank3+n] = potC   [m][n](ix, iy);
+	  t[1*rank3+n] = rforceC[m][n](ix, iy);
+	  t[2*rank3+n] = zforceC[m][n](ix, iy);
+	  t[3*rank3+n] = densC  [m][n](ix, iy);
+	  if (m) {
+	    t[4*rank3+n] = potS   [m][n](ix, iy);
+	    t[5*rank3+n] = rforceS[m][n](ix, iy);
+	    t[6*rank3+n] = zforceS[m][n](ix, iy);
+	    t[7*rank3+n] = densS  [m][n](ix, iy);
+	  }
+	}
+      }
+    }
+  }
+
+  cellTab->sync();
+}
+
 void EmpCylSL::setup_eof()
 {
   if (SC.size()==0 and SCe.size()==0) {
@@ -3056,6 +3070,10 @@ void EmpCylSL::make_eof(void)
   //
   if (use_mpi) {
 
+    // Only the root fills the grids so they may be node shared
+    //
+    allocate_grids(shared_tables);
+
     if (myid==0) {
 
       int worker = 0;
@@ -3219,6 +3237,8 @@ void EmpCylSL::make_eof(void)
   eof_made = true;
   std::fill(coefs_made.begin(), coefs_made.end(), false);
 
+  make_cell_table();
+
   if (VFLAG & 2) {
     if (use_mpi) MPI_Barrier(MPI_COMM_WORLD);
     std::cerr << "Process " << std::setw(4) << myid 
@@ -5023,6 +5043,25 @@ void EmpCylSL::set_trimmed(double snr, double rem)
 }
 
 
+// Weighted sum over the orders [n0, n1) of the bilinear interpolant
+// of one field block of the interleaved cell table.  The four corner
+// blocks are contiguous in n so the loop vectorizes.
+//
+static inline double cell_sum(const double* __restrict__ w,
+			      const double* const t[4], const double c[4],
+			      int off, int n0, int n1)
+{
+  const double *t00 = t[0] + off, *t10 = t[1] + off;
+  const double *t01 = t[2] + off, *t11 = t[3] + off;
+
+  double sum = 0.0;
+#pragma omp simd reduction(+:sum)
+  for (int n=n0; n<n1; n++)
+    sum += w[n]*(t00[n]*c[0] + t10[n]*c[1] + t01[n]*c[2] + t11[n]*c[3]);
+
+  return sum;
+}
+
 void EmpCylSL::accumulated_eval(double r, double z, double phi, 
 				double &p0, double& p, 
 				double& fr, double& fz, double &fp)
@@ -5084,6 +5123,53 @@ void EmpCylSL::accumulated_eval(double r, double z, double phi,
   
   double ccos, ssin=0.0, fac;
   
+  if (cellTab) {
+
+    const double *t[4] = {cell(ix, iy  ), cell(ix+1, iy  ),
+			  cell(ix, iy+1), cell(ix+1, iy+1)};
+    const double  c[4] = {c00, c10, c01, c11};
+
+    int n0 = std::max<int>(0, NMIN), n1 = std::min<int>(NLIM, rank3);
+
+    for (int mm=std::max<int>(0, MMIN); mm<=std::min<int>(MLIM, MMAX); mm++) {
+    
+      // Suppress odd M terms?
+      if (EVEN_M && (mm/2)*2 != mm) continue;
+
+      ccos = cos(phi*mm);
+      ssin = sin(phi*mm);
+
+      const double *w = accum_cos[mm].data();
+      int off = cellOff[mm];
+
+      double pC = cell_sum(w, t, c, off + 0*rank3, n0, n1);
+      double rC = cell_sum(w, t, c, off + 1*rank3, n0, n1);
+      double zC = cell_sum(w, t, c, off + 2*rank3, n0, n1);
+
+      p  += ccos*pC;
+      fr += ccos*rC;
+      fz += ccos*zC;
+      fp += ssin*pC*mm;
+
+      if (mm) {
+	w = accum_sin[mm].data();
+
+	double pS = cell_sum(w, t, c, off + 4*rank3, n0, n1);
+	double rS = cell_sum(w, t, c, off + 5*rank3, n0, n1);
+	double zS = cell_sum(w, t, c, off + 6*rank3, n0, n1);
+
+	p  += ssin*pS;
+	fr += ssin*rS;
+	fz += ssin*zS;
+	fp -= ccos*pS*mm;
+      }
+
+      if (mm==0) p0 = p;
+    }
+
+    return;
+  }
+
   for (int mm=std::max<int>(0, MMIN); mm<=std::min<int>(MLIM, MMAX); mm++) {
     
     // Suppress odd M terms?
@@ -5232,6 +5318,29 @@ double EmpCylSL::accumulated_dens_eval(double r, double z, double phi,
 
   double ccos, ssin=0.0, fac;
 
+  if (cellTab) {
+
+    const double *t[4] = {cell(ix, iy  ), cell(ix+1, iy  ),
+			  cell(ix, iy+1), cell(ix+1, iy+1)};
+    const double  c[4] = {c00, c10, c01, c11};
+
+    int n0 = std::max<int>(0, NMIN), n1 = std::min<int>(NLIM, rank3);
+
+    for (int mm=std::max<int>(0, MMIN); mm<=std::min<int>(MLIM, MMAX); mm++) {
+
+      int off = cellOff[mm];
+
+      ans += cos(phi*mm)*cell_sum(accum_cos[mm].data(), t, c, off + 3*rank3, n0, n1);
+
+      if (mm)
+	ans += sin(phi*mm)*cell_sum(accum_sin[mm].data(), t, c, off + 7*rank3, n0, n1);
+
+      if (mm==0) d0 = ans;
+    }
+
+    return ans;
+  }
+
   for (int mm=std::max<int>(0, MMIN); mm<=std::min<int>(MLIM, MMAX); mm++) {
 
     ccos = cos(phi*mm);
@@ -5369,6 +5478,31 @@ void EmpCylSL::get_pot(Eigen::MatrixXd& Vc, Eigen::MatrixXd& Vs,
 
   double fac = 1.0;
 
+  if (cellTab) {
+
+    const double *t00 = cell(ix, iy  ), *t10 = cell(ix+1, iy  );
+    const double *t01 = cell(ix, iy+1), *t11 = cell(ix+1, iy+1);
+
+    for (int mm=0; mm<=std::min<int>(MLIM, MMAX); mm++) {
+    
+      // Suppress odd M terms?
+      if (EVEN_M && (mm/2)*2 != mm) continue;
+
+      int off = cellOff[mm];
+
+      for (int n=0; n<rank3; n++)
+	Vc(mm, n) = t00[off+n]*c00 + t10[off+n]*c10 + t01[off+n]*c01 + t11[off+n]*c11;
+
+      if (mm) {
+	off += 4*rank3;
+	for (int n=0; n<rank3; n++)
+	  Vs(mm, n) = t00[off+n]*c00 + t10[off+n]*c10 + t01[off+n]*c01 + t11[off+n]*c11;
+      }
+    }
+
+    return;
+  }
+
   for (int mm=0; mm<=std::min<int>(MLIM, MMAX); mm++) {
     
     // Suppress odd M terms?
@@ -7198,10 +7332,10 @@ void EmpCylSL::WriteH5Cache()
 	sout << n;
 	auto order = harmonic.createGroup(sout.str());
       
-	order.createDataSet("potC",    potC   [m][n]);
-	order.createDataSet("rforceC", rforceC[m][n]);
-	order.createDataSet("zforceC", zforceC[m][n]);
-	order.createDataSet("densC",   densC  [m][n]);
+	order.createDataSet("potC",    Eigen::MatrixXd(potC   [m][n]));
+	order.createDataSet("rforceC", Eigen::MatrixXd(rforceC[m][n]));
+	order.createDataSet("zforceC", Eigen::MatrixXd(zforceC[m][n]));
+	order.createDataSet("densC",   Eigen::MatrixXd(densC  [m][n]));
       }
     }
 
@@ -7222,10 +7356,10 @@ void EmpCylSL::WriteH5Cache()
 	sout << n;
 	auto order = harmonic.createGroup(sout.str());
       
-	order.createDataSet("potS",    potS   [m][n]);
-	order.createDataSet("rforceS", rforceS[m][n]);
-	order.createDataSet("zforceS", zforceS[m][n]);
-	order.createDataSet("densS",   densS  [m][n]);
+	order.createDataSet("potS",    Eigen::MatrixXd(potS   [m][n]));
+	order.createDataSet("rforceS", Eigen::MatrixXd(rforceS[m][n]));
+	order.createDataSet("zforceS", Eigen::MatrixXd(zforceS[m][n]));
+	order.createDataSet("densS",   Eigen::MatrixXd(densS  [m][n]));
       }
     }
 
@@ -7317,32 +7451,9 @@ bool EmpCylSL::ReadH5Cache()
       EvenOdd  = true;
     }
 
-    // Allocate arrays for storing grids
+    // Allocate arrays for storing grids if the caller has not
     //
-    potC    .resize(MMAX+1);
-    rforceC .resize(MMAX+1);
-    zforceC .resize(MMAX+1);
-  
-    potS    .resize(MMAX+1);
-    rforceS .resize(MMAX+1);
-    zforceS .resize(MMAX+1);
-  
-    densC   .resize(MMAX+1);
-    densS   .resize(MMAX+1);
-
-    for (int m=0; m<=MMAX; m++) {
-      potC[m]   .resize(NORDER);
-      rforceC[m].resize(NORDER);
-      zforceC[m].resize(NORDER);
-      densC[m]  .resize(NORDER);
-    }
-
-    for (int m=1; m<=MMAX; m++) {
-      potS[m]   .resize(NORDER);
-      rforceS[m].resize(NORDER);
-      zforceS[m].resize(NORDER);
-      densS[m]  .resize(NORDER);
-    }    
+    if (not gridBlock) allocate_grids(false);
 
     // Read arrays and data from H5 file
     //
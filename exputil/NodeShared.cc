@@ -0,0 +1,155 @@
+#include <algorithm>
+#include <stdexcept>
+#include <climits>
+#include <map>
+
+#include <NodeShared.H>
+
+namespace NodeShared
+{
+  static MPI_Comm nodeComm   = MPI_COMM_NULL;
+  static MPI_Comm leaderComm = MPI_COMM_NULL;
+  static bool     commsMade  = false;
+
+  // Shared windows that have not been freed, keyed by creation
+  // order.  Every process on a node creates its windows in the same
+  // order so finalize() frees them in the same order.
+  //
+  static std::map<unsigned long, MPI_Win> windows;
+  static unsigned long                    serial = 0;
+
+  bool available()
+  {
+    int flag;
+    MPI_Initialized(&flag);
+    if (not flag) return false;
+    MPI_Finalized(&flag);
+    if (flag) return false;
+
+    int nprocs;
+    MPI_Comm_size(MPI_COMM_WORLD, &nprocs);
+    return nprocs > 1;
+  }
+
+  // Split MPI_COMM_WORLD by node and make the leader communicator.
+  // The world rank is the key so world rank 0 is the leader of its
+  // node and rank 0 of the leader communicator.
+  //
+  static void makeComms()
+  {
+    if (commsMade) return;
+
+    int myid;
+    MPI_Comm_rank(MPI_COMM_WORLD, &myid);
+
+    MPI_Comm_split_type(MPI_COMM_WORLD, MPI_COMM_TYPE_SHARED, myid,
+			MPI_INFO_NULL, &nodeComm);
+
+    int noderank;
+    MPI_Comm_rank(nodeComm, &noderank);
+
+    MPI_Comm_split(MPI_COMM_WORLD, noderank==0 ? 0 : MPI_UNDEFINED, myid,
+		   &leaderComm);
+
+    commsMade = true;
+  }
+
+  MPI_Comm node()
+  {
+    makeComms();
+    return nodeComm;
+  }
+
+  MPI_Comm leaders()
+  {
+    makeComms();
+    return leaderComm;
+  }
+
+  bool leader()
+  {
+    if (not available()) return true;
+    makeComms();
+    return leaderComm != MPI_COMM_NULL;
+  }
+
+  Block::Block(size_t n, bool shared) : count(n)
+  {
+    if (shared and available()) {
+
+      MPI_Aint bytes = leader() ? n*sizeof(double) : 0;
+
+      MPI_Win_allocate_shared(bytes, sizeof(double), MPI_INFO_NULL,
+			      node(), &base, &win);
+
+      // Every process addresses the leader's segment
+      //
+      MPI_Aint size;
+      int disp;
+      MPI_Win_shared_query(win, 0, &size, &disp, &base);
+
+      // Passive target epoch for the lifetime of the window so that
+      // sync() can use MPI_Win_sync
+      //
+      MPI_Win_lock_all(MPI_MODE_NOCHECK, win);
+
+      id = serial++;
+      windows[id] = win;
+
+    } else {
+      local.resize(n, 0.0);
+      base = local.data();
+    }
+  }
+
+  void Block::release()
+  {
+    if (win == MPI_WIN_NULL) return;
+
+    MPI_Win_unlock_all(win);
+    MPI_Win_free(&win);
+    windows.erase(id);
+
+    base  = nullptr;
+    count = 0;
+  }
+
+  void finalize()
+  {
+    if (not available()) return;
+
+    for (auto & v : windows) {
+      MPI_Win_unlock_all(v.second);
+      MPI_Win_free(&v.second);
+    }
+    windows.clear();
+  }
+
+  void Block::sync()
+  {
+    if (win == MPI_WIN_NULL) return;
+
+    MPI_Win_sync(win);
+    MPI_Barrier(node());
+    MPI_Win_sync(win);
+  }
+
+  void Block::bcast()
+  {
+    if (not available()) return;
+
+    MPI_Comm comm = isShared() ? leaders() : MPI_COMM_WORLD;
+
+    if (comm != MPI_COMM_NULL) {
+      // MPI counts are int
+      //
+      const size_t chunk = INT_MAX/2;
+      for (size_t beg=0; beg<count; beg+=chunk) {
+	int num = std::min<size_t>(chunk, count - beg);
+	MPI_Bcast(base + beg, num, MPI_DOUBLE, 0, comm);
+      }
+    }
+
+    sync();
+  }
+}
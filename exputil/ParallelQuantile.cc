@@ -0,0 +1,205 @@
+#include <algorithm>
+#include <stdexcept>
+#include <numeric>
+#include <cstring>
+#include <limits>
+#include <cmath>
+
+#include <ParallelQuantile.H>
+#include <P2Quantile.H>
+
+namespace ParallelQuantile
+{
+  // Number of bins per refinement round.  Each round reduces the
+  // bracket by this factor in the 64-bit key space so 16 bins need at
+  // most 16 rounds.
+  //
+  static const int nbin = 16;
+
+  // Order-preserving map from a double to an unsigned integer: flip
+  // all bits of negative numbers and the sign bit of positive ones
+  //
+  static uint64_t toKey(double x)
+  {
+    uint64_t u;
+    std::memcpy(&u, &x, sizeof(u));
+    const uint64_t sign = 0x8000000000000000ULL;
+    return (u & sign) ? ~u : (u | sign);
+  }
+
+  static double fromKey(uint64_t k)
+  {
+    const uint64_t sign = 0x8000000000000000ULL;
+    uint64_t u = (k & sign) ? (k & ~sign) : ~k;
+    double x;
+    std::memcpy(&x, &u, sizeof(x));
+    return x;
+  }
+
+  // For each target, find the smallest key K such that the total
+  // weight of keys <= K is at least the target.  The local keys are
+  // sorted and cum[i] is the weight of the first i keys.
+  //
+  static std::vector<uint64_t>
+  search(const std::vector<uint64_t>& keys, const std::vector<double>& cum,
+	 const std::vector<double>& target, MPI_Comm comm)
+  {
+    uint64_t lo = std::numeric_limits<uint64_t>::max(), hi = 0;
+    if (keys.size()) {
+      lo = keys.front();
+      hi = keys.back();
+    }
+
+    MPI_Allreduce(MPI_IN_PLACE, &lo, 1, MPI_UINT64_T, MPI_MIN, comm);
+    MPI_Allreduce(MPI_IN_PLACE, &hi, 1, MPI_UINT64_T, MPI_MAX, comm);
+
+    if (lo > hi)
+      throw std::runtime_error("ParallelQuantile: no data on any process");
+
+    int K = target.size();
+
+    // The answer for query q is in [L[q], H[q]]
+    //
+    std::vector<uint64_t> L(K, lo), H(K, hi);
+    std::vector<uint64_t> split(K*(nbin-1));
+    std::vector<double>   W(K*(nbin-1));
+
+    while (true) {
+
+      bool done = true;
+      for (int q=0; q<K; q++) if (L[q] < H[q]) done = false;
+      if (done) break;
+
+      // Bin edges and the local weight at or below each edge
+      //
+      for (int q=0; q<K; q++) {
+	uint64_t d = H[q] - L[q];
+	for (int j=1; j<nbin; j++) {
+	  uint64_t s = L[q] + (d/nbin)*j + ((d%nbin)*j)/nbin;
+	  auto it = std::upper_bound(keys.begin(), keys.end(), s);
+	  split[q*(nbin-1)+j-1] = s;
+	  W    [q*(nbin-1)+j-1] = cum[it - keys.begin()];
+	}
+      }
+
+      MPI_Allreduce(MPI_IN_PLACE, W.data(), W.size(), MPI_DOUBLE, MPI_SUM,
+		    comm);
+
+      // Narrow each bracket to the first bin that reaches the target
+      //
+      for (int q=0; q<K; q++) {
+	if (L[q] == H[q]) continue;
+	int j = 0;
+	while (j<nbin-1 and W[q*(nbin-1)+j] < target[q]) j++;
+	if (j<nbin-1) H[q] = split[q*(nbin-1)+j];
+	if (j>0)      L[q] = split[q*(nbin-1)+j-1] + 1;
+      }
+    }
+
+    return L;
+  }
+
+  uint64_t total(const std::vector<double>& data, MPI_Comm comm)
+  {
+    uint64_t n = data.size();
+    MPI_Allreduce(MPI_IN_PLACE, &n, 1, MPI_UINT64_T, MPI_SUM, comm);
+    return n;
+  }
+
+  std::vector<double> select(const std::vector<double>& data,
+			     const std::vector<uint64_t>& k,
+			     MPI_Comm comm)
+  {
+    std::vector<uint64_t> keys(data.size());
+    for (size_t i=0; i<data.size(); i++) keys[i] = toKey(data[i]);
+    std::sort(keys.begin(), keys.end());
+
+    std::vector<double> cum(keys.size()+1);
+    for (size_t i=0; i<cum.size(); i++) cum[i] = i;
+
+    uint64_t ntot = total(data, comm);
+
+    // The element of rank k is the smallest value with more than k
+    // elements at or below it
+    //
+    std::vector<double> target(k.size());
+    for (size_t q=0; q<k.size(); q++)
+      target[q] = std::min<uint64_t>(k[q], ntot-1) + 1;
+
+    auto ret = search(keys, cum, target, comm);
+
+    std::vector<double> ans(k.size());
+    for (size_t q=0; q<k.size(); q++) ans[q] = fromKey(ret[q]);
+
+    return ans;
+  }
+
+  double select(const std::vector<double>& data, uint64_t k, MPI_Comm comm)
+  {
+    return select(data, std::vector<uint64_t>{k}, comm)[0];
+  }
+
+  std::vector<double> weighted(const std::vector<double>& data,
+			       const std::vector<double>& weight,
+			       const std::vector<double>& prob,
+			       MPI_Comm comm)
+  {
+    if (data.size() != weight.size())
+      throw std::runtime_error("ParallelQuantile::weighted: data and weight sizes differ");
+
+    std::vector<size_t> indx(data.size());
+    std::iota(indx.begin(), indx.end(), 0);
+    std::sort(indx.begin(), indx.end(),
+	      [&data](size_t a, size_t b) { return data[a] < data[b]; });
+
+    std::vector<uint64_t> keys(data.size());
+    std::vector<double>   cum (data.size()+1, 0.0);
+    for (size_t i=0; i<indx.size(); i++) {
+      keys[i]  = toKey(data[indx[i]]);
+      cum[i+1] = cum[i] + weight[indx[i]];
+    }
+
+    double wtot = cum.back();
+    MPI_Allreduce(MPI_IN_PLACE, &wtot, 1, MPI_DOUBLE, MPI_SUM, comm);
+
+    std::vector<double> target(prob.size());
+    for (size_t q=0; q<prob.size(); q++) target[q] = prob[q]*wtot;
+
+    auto ret = search(keys, cum, target, comm);
+
+    std::vector<double> ans(prob.size());
+    for (size_t q=0; q<prob.size(); q++) ans[q] = fromKey(ret[q]);
+
+    return ans;
+  }
+
+  std::vector<double> streaming(const std::vector<double>& data,
+				const std::vector<double>& prob,
+				MPI_Comm comm)
+  {
+    int K = prob.size();
+
+    // Count weighted sums of the local estimates followed by the count
+    //
+    std::vector<double> sum(K+1, 0.0);
+
+    if (data.size()) {
+      for (int q=0; q<K; q++) {
+	P2Quantile p2(prob[q]);
+	for (auto v : data) p2.addValue(v);
+	sum[q] = p2.getQuantile() * data.size();
+      }
+      sum[K] = data.size();
+    }
+
+    MPI_Allreduce(MPI_IN_PLACE, sum.data(), K+1, MPI_DOUBLE, MPI_SUM, comm);
+
+    if (sum[K] <= 0.0)
+      throw std::runtime_error("ParallelQuantile: no data on any process");
+
+    std::vector<double> ans(K);
+    for (int q=0; q<K; q++) ans[q] = sum[q]/sum[K];
+
+    return ans;
+  }
+}
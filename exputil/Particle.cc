@@ -35,6 +35,7 @@ Particle::Particle()
   indx    = 0;
   tree    = 0u;
   key     = 0u;
+  levslot = -1;
   skey    = defaultKey;
 }
 
@@ -52,6 +53,7 @@ Particle::Particle(unsigned niatr, unsigned ndatr)
   indx    = 0;
   tree    = 0u;
   key     = 0u;
+  levslot = -1;
   iattrib = vector<int   >(niatr, 0);
   dattrib = vector<double>(ndatr, 0);
   skey    = defaultKey;
@@ -76,6 +78,7 @@ Particle::Particle(const Particle &p)
   indx    = p.indx;
   tree    = p.tree;
   key     = p.key;
+  levslot = -1;
   skey    = p.skey;
 }
 
@@ -466,6 +469,53 @@ int Particle::writeBinaryMPI(char *buf, unsigned rsize, bool indexing)
 }
 
 
+int Particle::readBinaryMPI(const char *buf, unsigned rsize, bool indexing,
+			    int seq)
+{
+  // Pointer offset
+  int p = 0;
+
+  // Read one floating value of either size
+  auto get = [&]()
+  {
+    double v;
+    if (rsize == sizeof(float)) {
+      float tf;
+      memcpy (&tf, buf+p, sizeof(float));
+      v = tf;
+    } else {
+      memcpy (&v, buf+p, sizeof(double));
+    }
+    p += rsize;
+    return v;
+  };
+
+  if (indexing) {
+    memcpy (&indx, buf+p, sizeof(unsigned long));
+    p += sizeof(unsigned long);
+  }
+  else
+    indx = seq;
+
+  mass = get();
+  for (int i=0; i<3; i++) pos[i] = get();
+  for (int i=0; i<3; i++) vel[i] = get();
+  pot    = get();
+  potext = 0.0;
+
+  level = multistep;
+
+  if (iattrib.size()) {
+    memcpy (&iattrib[0], buf+p, sizeof(int)*iattrib.size());
+    p += sizeof(int)*iattrib.size();
+  }
+
+  for (auto& jt : dattrib) jt = get();
+
+  return p;
+}
+
+
 void Particle::readAscii(bool indexing, int seq, std::istream* fin)
 {
   //
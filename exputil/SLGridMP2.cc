@@ -14,6 +14,7 @@
 #include <sstream>
 #include <fstream>
 #include <iomanip>
+#include <functional>
 #include <cstdlib>
 #include <vector>
 
@@ -82,12 +83,154 @@ static double L2, M2, K2;
 static int sl_dim;
 
 
+//! Incremental HDF5 cache for the table builders
+/*!
+  Each finished table is written to <cache>.partial as soon as it
+  is available, so an interrupted build resumes from the tables
+  already computed.  The partial file carries the same attributes as
+  the cache and is renamed to the cache when the build is complete.
+
+  Only the root process should use this class.  HDF5 errors are
+  reported and disable further checkpointing; they do not stop the
+  build.
+*/
+class H5Checkpoint
+{
+private:
+
+  std::string cache, partial, caller;
+  bool ok = false;
+
+public:
+
+  //! Open the checkpoint for <code>cache</code>.  An existing
+  //! partial file is kept if <code>check</code> accepts its
+  //! attributes; otherwise a new one is made and <code>header</code>
+  //! writes its attributes.
+  H5Checkpoint(const std::string& cache, const std::string& caller,
+	       std::function<void(HighFive::File&)> header,
+	       std::function<bool(HighFive::File&)> check) :
+    cache(cache), partial(cache + ".partial"), caller(caller)
+  {
+    if (std::filesystem::exists(partial)) {
+      try {
+	HighFive::SilenceHDF5 quiet;
+	HighFive::File file(partial, HighFive::File::ReadOnly);
+	ok = check(file);
+      }
+      catch (HighFive::Exception& err) {
+	ok = false;
+      }
+
+      if (ok) {
+	std::cout << "---- " << caller << ": resuming from <"
+		  << partial << ">" << std::endl;
+	return;
+      }
+
+      std::cout << "---- " << caller << ": discarding unusable <"
+		<< partial << ">" << std::endl;
+    }
+
+    try {
+      HighFive::File file(partial, HighFive::File::Overwrite);
+      header(file);
+      file.createGroup("Harmonic");
+      ok = true;
+    }
+    catch (HighFive::Exception& err) {
+      std::cerr << "---- " << caller << ": could not create <" << partial
+		<< ">, checkpointing is off: " << err.what() << std::endl;
+    }
+  }
+
+  //! Read table <code>name</code> if a previous build finished it
+  bool restore(const std::string& name,
+	       Eigen::VectorXd& ev, Eigen::MatrixXd& ef)
+  {
+    if (not ok) return false;
+
+    try {
+      HighFive::SilenceHDF5 quiet;
+      HighFive::File file(partial, HighFive::File::ReadOnly);
+      auto harmonic = file.getGroup("Harmonic");
+      if (not harmonic.exist(name)) return false;
+
+      auto arrays = harmonic.getGroup(name);
+      if (not arrays.hasAttribute("complete")) return false;
+
+      arrays.getDataSet("ev").read(ev);
+      arrays.getDataSet("ef").read(ef);
+      return true;
+    }
+    catch (HighFive::Exception& err) {
+      return false;
+    }
+  }
+
+  //! Append table <code>name</code>.  The file is closed on return
+  //! so the table survives an abort.
+  void write(const std::string& name,
+	     const Eigen::VectorXd& ev, const Eigen::MatrixXd& ef)
+  {
+    if (not ok) return;
+
+    try {
+      HighFive::File file(partial, HighFive::File::ReadWrite);
+      auto harmonic = file.getGroup("Harmonic");
+      if (harmonic.exist(name)) harmonic.unlink(name);
+
+      auto arrays = harmonic.createGroup(name);
+      arrays.createDataSet("ev", ev);
+      arrays.createDataSet("ef", ef);
+
+      // Marks the table as usable on restart
+      int one = 1;
+      arrays.createAttribute<int>("complete", HighFive::DataSpace::From(one)).write(one);
+    }
+    catch (HighFive::Exception& err) {
+      std::cerr << "---- " << caller << ": error writing <" << partial
+		<< ">, checkpointing is off: " << err.what() << std::endl;
+      ok = false;
+    }
+  }
+
+  //! Promote the complete partial file to the cache, backing up any
+  //! existing cache.  Returns false if there is no usable partial
+  //! file, in which case the caller should write the cache itself.
+  bool finish()
+  {
+    if (not ok) return false;
+
+    try {
+      if (std::filesystem::exists(cache)) {
+	std::filesystem::rename(cache, cache + ".bak");
+	std::cout << "---- " << caller << ": existing file backed up to <"
+		  << cache + ".bak>" << std::endl;
+      }
+      std::filesystem::rename(partial, cache);
+    }
+    catch (std::filesystem::filesystem_error const& ex) {
+      std::cerr << "---- " << caller << ": could not rename <" << partial
+		<< "> to <" << cache << ">: " << ex.what() << std::endl;
+      return false;
+    }
+
+    std::cout << "---- " << caller << ": wrote <" << cache << ">"
+	      << std::endl;
+
+    return true;
+  }
+};
+
+
 //======================================================================
 //======================================================================
 //======================================================================
 
 
 int SLGridSph::mpi = 0;		// initially off
+int SLGridSph::interrupt = 0;	// never
 
 extern "C" {
   int sledge_(logical* job, doublereal* cons, logical* endfin, 
@@ -259,12 +402,36 @@ void SLGridSph::initialize(int LMAX, int NMAX, int NUMR,
   
   if (not ReadH5Cache()) {
 
+    table = table_ptr_1D(new TableSph [lmax+1]);
+
+    // Checkpoint each table as it is finished and pick up the tables
+    // from an interrupted build
+    //
+    std::shared_ptr<H5Checkpoint> ckpt;
+    std::vector<int> todo;
+
+    if (cache and myid==0) {
+      ckpt = std::make_shared<H5Checkpoint>
+	(sph_cache_name, "SLGridSph",
+	 [this](HighFive::File& f) { WriteH5Header(f); },
+	 [this](HighFive::File& f) { return CheckH5Header(f); });
+    }
+
+    for (l=0; l<=lmax; l++) {
+      if (ckpt and ckpt->restore(std::to_string(l), table[l].ev, table[l].ef))
+	table[l].l = l;
+      else
+	todo.push_back(l);
+    }
+
+    if (ckpt and todo.size() < static_cast<size_t>(lmax+1))
+      std::cout << "---- SLGridSph: " << lmax + 1 - todo.size()
+		<< " of " << lmax + 1 << " tables restored" << std::endl;
+
     // MPI loop
     //
     if (mpi) {
 
-      table = table_ptr_1D(new TableSph [lmax+1]);
-      
       mpi_setup();
       
       int totbad = 0;		// Count total number of sledge errors
@@ -289,9 +456,11 @@ void SLGridSph::initialize(int LMAX, int NMAX, int NUMR,
 	int worker = 0;
 	int request_id = 1;
 
-	l=0;
+	size_t next = 0;	// Next entry in the todo list
 
-	while (l<=lmax) {
+	while (next<todo.size()) {
+
+	  l = todo[next];
 
 	  if (worker<mpi_numprocs-1) { // Send request to worker
 	    worker++;
@@ -309,17 +478,20 @@ void SLGridSph::initialize(int LMAX, int NMAX, int NUMR,
 			<< ": l=" << l << std::endl;
 	    
 	    // Increment counters
-	    l++;
+	    next++;
 	  }
 	  
-	  if (worker == mpi_numprocs-1 && l<=lmax) {
+	  if (worker == mpi_numprocs-1 && next<todo.size()) {
+
+	    l = todo[next];
 	  
 	    //
 	    // <Wait and receive>
 	    //
 	    
+	    int bad = 0;	// Sledge error count for this table
 #ifdef SLEDGE_THROW
-	    int bad;		// Get the sledge error count from a
+				// Get the sledge error count from a
 				// worker
 	    MPI_Recv(&bad, 1, MPI_INT, MPI_ANY_SOURCE, 10,
 		     MPI_COMM_WORLD, &status);
@@ -334,7 +506,11 @@ void SLGridSph::initialize(int LMAX, int NMAX, int NUMR,
 	    int retid = status.MPI_SOURCE;
 #endif
 	  
-	    mpi_unpack_table();      
+	    // Only a table without sledge errors may be resumed from
+	    //
+	    int lr = mpi_unpack_table();      
+	    if (ckpt and bad==0)
+	      ckpt->write(std::to_string(lr), table[lr].ev, table[lr].ef);
 
 	    //
 	    // <Send new request>
@@ -348,7 +524,7 @@ void SLGridSph::initialize(int LMAX, int NMAX, int NUMR,
 			<< ": l=" << l << std::endl;
 	    
 	    // Increment counters
-	    l++;
+	    next++;
 	  }
 	}
 	
@@ -357,8 +533,9 @@ void SLGridSph::initialize(int LMAX, int NMAX, int NUMR,
 	//
       
 	while (worker) {
+	  int bad = 0;		// Sledge error count for this table
 #ifdef SLEDGE_THROW
-	  int bad;		// Get the sledge error count from a
+				// Get the sledge error count from a
 				// worker
 	  MPI_Recv(&bad, 1, MPI_INT, MPI_ANY_SOURCE, 10,
 		   MPI_COMM_WORLD, &status);
@@ -372,7 +549,9 @@ void SLGridSph::initialize(int LMAX, int NMAX, int NUMR,
 		   MPI_COMM_WORLD, &status);
 	  
 #endif
-	  mpi_unpack_table();      
+	  int lr = mpi_unpack_table();      
+	  if (ckpt and bad==0)
+	    ckpt->write(std::to_string(lr), table[lr].ev, table[lr].ef);
 	  
 	  worker--;
 	}
@@ -427,22 +606,31 @@ void SLGridSph::initialize(int LMAX, int NMAX, int NUMR,
     // END MPI stanza, BEGIN single-process stanza
     else {
 
-      table = table_ptr_1D(new TableSph [lmax+1]);
-
-      for (l=0; l<=lmax; l++) {
+      int done = 0;
+      for (auto l : todo) {
 	if (tbdbg) std::cerr << "Begin [" << l << "] . . ." << std::endl;
 	compute_table(&(table[l]), l);
+	if (ckpt) ckpt->write(std::to_string(l), table[l].ev, table[l].ef);
 	if (tbdbg) std::cerr << ". . . done" << std::endl;
+
+	if (++done == interrupt)
+	  throw std::runtime_error("SLGridSph: build interrupted after " +
+				   std::to_string(done) + " tables");
       }
     }
     // END single process stanza
 
-    // Write cache
+    // Write cache: promote the checkpoint or write it directly if
+    // checkpointing failed
     //
-    if (myid==0 and cache) WriteH5Cache();
+    if (myid==0 and cache) {
+      if (not ckpt or not ckpt->finish()) WriteH5Cache();
+    }
   }
   // END: make tables
 
+  fuse_tables();
+
   if (tbdbg)
     std::cerr << "Process " << myid << ": exiting constructor" << std::endl;
   
@@ -484,6 +672,43 @@ bool SLGridSph::ReadH5Cache(void)
 {
   if (!cache) return false;
 
+  if (not mpi) return ReadH5Tables();
+
+  // With MPI on, only the root process opens the cache and the
+  // tables are broadcast to the others.  This avoids every process
+  // hitting the file system at start up.
+  //
+  int ok = 0;
+  if (myid==0) ok = ReadH5Tables();
+  MPI_Bcast(&ok, 1, MPI_INT, 0, MPI_COMM_WORLD);
+  if (not ok) return false;
+
+  if (myid) table = table_ptr_1D(new TableSph [lmax+1]);
+
+  for (int l=0; l<=lmax; l++) {
+    int dim[3];
+    if (myid==0) {
+      dim[0] = table[l].ev.size();
+      dim[1] = table[l].ef.rows();
+      dim[2] = table[l].ef.cols();
+    }
+    MPI_Bcast(dim, 3, MPI_INT, 0, MPI_COMM_WORLD);
+
+    if (myid) {
+      table[l].ev.resize(dim[0]);
+      table[l].ef.resize(dim[1], dim[2]);
+    }
+
+    MPI_Bcast(table[l].ev.data(), dim[0], MPI_DOUBLE, 0, MPI_COMM_WORLD);
+    MPI_Bcast(table[l].ef.data(), dim[1]*dim[2], MPI_DOUBLE, 0,
+	      MPI_COMM_WORLD);
+  }
+
+  return true;
+}
+
+bool SLGridSph::ReadH5Tables(void)
+{
   // First attempt to read the file
   //
   try {
@@ -495,82 +720,9 @@ bool SLGridSph::ReadH5Cache(void)
     //
     HighFive::File h5file(sph_cache_name, HighFive::File::ReadOnly);
     
-    // Try checking the rest of the parameters before reading arrays
-    //
-    auto checkInt = [&h5file](int value, std::string name)
-    {
-      int v; HighFive::Attribute vv = h5file.getAttribute(name); vv.read(v);
-      if (value == v) return true;
-      if (myid==0)
-	std::cout << "---- SLGridSph::ReadH5Cache: "
-		  << "parameter " << name << ": wanted " << value
-		  << " found " << v << std::endl;
-      return false;
-    };
-
-    auto checkDbl = [&h5file](double value, std::string name)
-    {
-      double v; HighFive::Attribute vv = h5file.getAttribute(name); vv.read(v);
-      if (fabs(value - v) < 1.0e-16) return true;
-      if (myid==0)
-	std::cout << "---- SLGridSph::ReadH5Cache: "
-		  << "parameter " << name << ": wanted " << value
-		  << " found " << v << std::endl;
-      return false;
-    };
-
-    auto checkStr = [&h5file](std::string value, std::string name)
-    {
-      std::string v; HighFive::Attribute vv = h5file.getAttribute(name); vv.read(v);
-      if (value.compare(v)==0) return true;
-      if (myid==0)
-	std::cout << "---- SLGridSph::ReadH5Cache: "
-		  << "parameter " << name << ": wanted " << value
-		  << " found " << v << std::endl;
-      return false;
-    };
-
-    // For cache ID
-    //
-    std::string geometry("sphere"), forceID("SLGridSph");
-    std::string modl(model_file_name);
-
-    // ID check
-    //
-    if (not checkStr(geometry, "geometry"))  return false;
-    if (not checkStr(forceID,  "forceID"))   return false;
-
-    // Version check
-    //
-    if (h5file.hasAttribute("Version")) {
-      if (not checkStr(Version, "Version"))  return false;
-    } else {
-      if (myid==0)
-	std::cout << "---- SLGridSph::ReadH5Cache: "
-		  << "recomputing cache for HighFive API change"
-		  << std::endl;
-      return false;
-    }
-
-    // Parameter check
-    //
-    if (not checkStr(modl,     "model"))     return false;
-    if (not checkInt(lmax,     "lmax"))      return false;
-    if (not checkInt(nmax,     "nmax"))      return false;
-    if (not checkInt(numr,     "numr"))      return false;
-    if (not checkInt(cmap,     "cmap"))      return false;
-    if (not checkDbl(rmin,     "rmin"))      return false;
-    if (not checkDbl(rmax,     "rmax"))      return false;
-    if (not checkInt(diverge,  "diverge"))   return false;
-    if (not checkDbl(dfac,     "dfac"))      return false;
-
-    // Backward compatibility for old 'scale' key word
+    // Check the parameters before reading arrays
     //
-    if (h5file.hasAttribute("scale")) {
-      if (not checkDbl(rmap,   "scale"))     return false;
-    } else {
-      if (not checkDbl(rmap,   "rmapping"))  return false;
-    }
+    if (not CheckH5Header(h5file)) return false;
 
     // Harmonic order
     //
@@ -611,6 +763,87 @@ bool SLGridSph::ReadH5Cache(void)
 
 
 
+bool SLGridSph::CheckH5Header(HighFive::File& file)
+{
+  auto checkInt = [&file](int value, std::string name)
+  {
+    int v; HighFive::Attribute vv = file.getAttribute(name); vv.read(v);
+    if (value == v) return true;
+    if (myid==0)
+      std::cout << "---- SLGridSph::ReadH5Cache: "
+		<< "parameter " << name << ": wanted " << value
+		<< " found " << v << std::endl;
+    return false;
+  };
+
+  auto checkDbl = [&file](double value, std::string name)
+  {
+    double v; HighFive::Attribute vv = file.getAttribute(name); vv.read(v);
+    if (fabs(value - v) < 1.0e-16) return true;
+    if (myid==0)
+      std::cout << "---- SLGridSph::ReadH5Cache: "
+		<< "parameter " << name << ": wanted " << value
+		<< " found " << v << std::endl;
+    return false;
+  };
+
+  auto checkStr = [&file](std::string value, std::string name)
+  {
+    std::string v; HighFive::Attribute vv = file.getAttribute(name); vv.read(v);
+    if (value.compare(v)==0) return true;
+    if (myid==0)
+      std::cout << "---- SLGridSph::ReadH5Cache: "
+		<< "parameter " << name << ": wanted " << value
+		<< " found " << v << std::endl;
+    return false;
+  };
+
+  // For cache ID
+  //
+  std::string geometry("sphere"), forceID("SLGridSph");
+  std::string modl(model_file_name);
+
+  // ID check
+  //
+  if (not checkStr(geometry, "geometry"))  return false;
+  if (not checkStr(forceID,  "forceID"))   return false;
+
+  // Version check
+  //
+  if (file.hasAttribute("Version")) {
+    if (not checkStr(Version, "Version"))  return false;
+  } else {
+    if (myid==0)
+      std::cout << "---- SLGridSph::ReadH5Cache: "
+		<< "recomputing cache for HighFive API change"
+		<< std::endl;
+    return false;
+  }
+
+  // Parameter check
+  //
+  if (not checkStr(modl,     "model"))     return false;
+  if (not checkInt(lmax,     "lmax"))      return false;
+  if (not checkInt(nmax,     "nmax"))      return false;
+  if (not checkInt(numr,     "numr"))      return false;
+  if (not checkInt(cmap,     "cmap"))      return false;
+  if (not checkDbl(rmin,     "rmin"))      return false;
+  if (not checkDbl(rmax,     "rmax"))      return false;
+  if (not checkInt(diverge,  "diverge"))   return false;
+  if (not checkDbl(dfac,     "dfac"))      return false;
+
+  // Backward compatibility for old 'scale' key word
+  //
+  if (file.hasAttribute("scale")) {
+    if (not checkDbl(rmap,   "scale"))     return false;
+  } else {
+    if (not checkDbl(rmap,   "rmapping"))  return false;
+  }
+
+  return true;
+}
+
+
 void SLGridSph::WriteH5Cache(void)
 {
   if (myid) return;
@@ -644,27 +877,10 @@ void SLGridSph::WriteH5Cache(void)
     HighFive::File file(sph_cache_name,
 			HighFive::File::ReadWrite | HighFive::File::Create);
     
-    // For cache ID
+    // Cache parameters
     //
-    std::string geometry("sphere"), forceID("SLGridSph");
+    WriteH5Header(file);
 
-    file.createAttribute<std::string>("geometry",  HighFive::DataSpace::From(geometry)).write(geometry);
-    file.createAttribute<std::string>("forceID",   HighFive::DataSpace::From(forceID)).write(forceID);
-    file.createAttribute<std::string>("Version",   HighFive::DataSpace::From(Version)).write(Version);
-      
-    // Write parameters
-    //
-    file.createAttribute<std::string> ("model",    HighFive::DataSpace::From(model_file_name)).write(model_file_name);
-    file.createAttribute<int>         ("lmax",     HighFive::DataSpace::From(lmax)).write(lmax);
-    file.createAttribute<int>         ("nmax",     HighFive::DataSpace::From(nmax)).write(nmax);
-    file.createAttribute<int>         ("numr",     HighFive::DataSpace::From(numr)).write(numr);
-    file.createAttribute<int>         ("cmap",     HighFive::DataSpace::From(cmap)).write(cmap);
-    file.createAttribute<double>      ("rmin",     HighFive::DataSpace::From(rmin)).write(rmin);
-    file.createAttribute<double>      ("rmax",     HighFive::DataSpace::From(rmax)).write(rmax);
-    file.createAttribute<double>      ("rmapping", HighFive::DataSpace::From(rmap)).write(rmap);
-    file.createAttribute<int>         ("diverge",  HighFive::DataSpace::From(diverge)).write(diverge);
-    file.createAttribute<double>      ("dfac",     HighFive::DataSpace::From(dfac)).write(dfac);
-      
     // Harmonic order (for h5dump readability)
     //
     auto harmonic = file.createGroup("Harmonic");
@@ -689,6 +905,31 @@ void SLGridSph::WriteH5Cache(void)
 }
 
 
+void SLGridSph::WriteH5Header(HighFive::File& file)
+{
+  // For cache ID
+  //
+  std::string geometry("sphere"), forceID("SLGridSph");
+
+  file.createAttribute<std::string>("geometry",  HighFive::DataSpace::From(geometry)).write(geometry);
+  file.createAttribute<std::string>("forceID",   HighFive::DataSpace::From(forceID)).write(forceID);
+  file.createAttribute<std::string>("Version",   HighFive::DataSpace::From(Version)).write(Version);
+      
+  // Write parameters
+  //
+  file.createAttribute<std::string> ("model",    HighFive::DataSpace::From(model_file_name)).write(model_file_name);
+  file.createAttribute<int>         ("lmax",     HighFive::DataSpace::From(lmax)).write(lmax);
+  file.createAttribute<int>         ("nmax",     HighFive::DataSpace::From(nmax)).write(nmax);
+  file.createAttribute<int>         ("numr",     HighFive::DataSpace::From(numr)).write(numr);
+  file.createAttribute<int>         ("cmap",     HighFive::DataSpace::From(cmap)).write(cmap);
+  file.createAttribute<double>      ("rmin",     HighFive::DataSpace::From(rmin)).write(rmin);
+  file.createAttribute<double>      ("rmax",     HighFive::DataSpace::From(rmax)).write(rmax);
+  file.createAttribute<double>      ("rmapping", HighFive::DataSpace::From(rmap)).write(rmap);
+  file.createAttribute<int>         ("diverge",  HighFive::DataSpace::From(diverge)).write(diverge);
+  file.createAttribute<double>      ("dfac",     HighFive::DataSpace::From(dfac)).write(dfac);
+}
+
+
 SLGridSph::~SLGridSph()
 {
   // Nothing
@@ -777,12 +1018,13 @@ double SLGridSph::get_pot(double x, int l, int n, int which)
   double x2 = (x - xi[indx])/dxi;
   
 
+  int k = l + n*(lmax+1);
+
 #ifdef USE_TABLE
-  return (x1*table[l].ef(n, indx) + x2*table[l].ef(n, indx+1))/
-    sqrt(table[l].ev[n]) * (x1*p0[indx] + x2*p0[indx+1]);
+  return (x1*potT(k, indx) + x2*potT(k, indx+1)) *
+    (x1*p0[indx] + x2*p0[indx+1]);
 #else
-  return (x1*table[l].ef(n, indx) + x2*table[l].ef(n, indx+1))/
-    sqrt(table[l].ev[n]) * sphpot(xi_to_r(x));
+  return (x1*potT(k, indx) + x2*potT(k, indx+1)) * sphpot(xi_to_r(x));
 #endif
 }
 
@@ -810,12 +1052,13 @@ double SLGridSph::get_dens(double x, int l, int n, int which)
   double x1 = (xi[indx+1] - x)/dxi;
   double x2 = (x - xi[indx])/dxi;
   
+  int k = l + n*(lmax+1);
+
 #ifdef USE_TABLE
-  return (x1*table[l].ef(n, indx) + x2*table[l].ef(n, indx+1)) *
-    sqrt(table[l].ev[n]) * (x1*d0[indx] + x2*d0[indx+1]);
+  return (x1*densT(k, indx) + x2*densT(k, indx+1)) *
+    (x1*d0[indx] + x2*d0[indx+1]);
 #else
-  return (x1*table[l].ef(n, indx) + x2*table[l].ef(n, indx+1)) *
-    sqrt(table[l].ev[n]) * sphdens(xi_to_r(x));
+  return (x1*densT(k, indx) + x2*densT(k, indx+1)) * sphdens(xi_to_r(x));
 #endif
 
 }
@@ -849,11 +1092,13 @@ double SLGridSph::get_force(double x, int l, int n, int which)
 				// Point  0: indx
 				// Point  1: indx+1
 
+  int k = l + n*(lmax+1);
+
   return d_xi_to_r(x)/dxi * (
-			     (p - 0.5)*table[l].ef(n, indx-1)*p0[indx-1]
-			     -2.0*p*table[l].ef(n, indx)*p0[indx]
-			     + (p + 0.5)*table[l].ef(n, indx+1)*p0[indx+1]
-			     ) / sqrt(table[l].ev[n]);
+			     (p - 0.5)*forceT(k, indx-1)
+			     -2.0*p*forceT(k, indx)
+			     + (p + 0.5)*forceT(k, indx+1)
+			     );
 }
 
 
@@ -883,17 +1128,15 @@ void SLGridSph::get_pot(Eigen::MatrixXd& mat, double x, int which)
   double x2 = (x - xi[indx])/dxi;
   
 
-  for (int l=0; l<=lmax; l++) {
-    for (int n=0; n<nmax; n++) {
 #ifdef USE_TABLE
-      mat(l, n) = (x1*table[l].ef(n, indx) + x2*table[l].ef(n, indx+1))/
-	sqrt(table[l].ev[n]) * (x1*p0[indx] + x2*p0[indx+1]);
+  double fac = x1*p0[indx] + x2*p0[indx+1];
 #else
-      mat(l, n) = (x1*table[l].ef(n, indx) + x2*table[l].ef(n, indx+1))/
-	sqrt(table[l].ev[n]) * sphpot(xi_to_r(x));
+  double fac = sphpot(xi_to_r(x));
 #endif
-    }
-  }
+
+  // One blend over all (l, n)
+  //
+  mat = (x1*fac)*knot(potT, indx) + (x2*fac)*knot(potT, indx+1);
 
 }
 
@@ -924,17 +1167,13 @@ void SLGridSph::get_dens(Eigen::MatrixXd& mat, double x, int which)
   double x2 = (x - xi[indx])/dxi;
   
 
-  for (int l=0; l<=lmax; l++) {
-    for (int n=0; n<nmax; n++) {
 #ifdef USE_TABLE
-      mat(l, n) = (x1*table[l].ef(n, indx) + x2*table[l].ef(n, indx+1))*
-	sqrt(table[l].ev[n]) * (x1*d0[indx] + x2*d0[indx+1]);
+  double fac = x1*d0[indx] + x2*d0[indx+1];
 #else
-      mat(l, n) = (x1*table[l].ef(n, indx) + x2*table[l].ef(n, indx+1))*
-	sqrt(table[l].ev[n]) * sphdens(xi_to_r(x));
+  double fac = sphdens(xi_to_r(x));
 #endif
-    }
-  }
+
+  mat = (x1*fac)*knot(densT, indx) + (x2*fac)*knot(densT, indx+1);
 
 }
 
@@ -964,15 +1203,10 @@ void SLGridSph::get_force(Eigen::MatrixXd& mat, double x, int which)
   double p = (x - xi[indx])/dxi;
   double fac = d_xi_to_r(x)/dxi;
 
-  for (int l=0; l<=lmax; l++) {
-    for (int n=0; n<nmax; n++) {
-      mat(l, n) = fac * (
-			 (p - 0.5)*table[l].ef(n, indx-1)*p0[indx-1]
-			 -2.0*p*table[l].ef(n, indx)*p0[indx]
-			 + (p + 0.5)*table[l].ef(n, indx+1)*p0[indx+1]
-			 ) / sqrt(table[l].ev[n]);
-    }
-  }
+  mat =
+    fac*(p - 0.5)*knot(forceT, indx-1)
+    -fac*2.0*p*knot(forceT, indx)
+    + fac*(p + 0.5)*knot(forceT, indx+1);
   
 }
 
@@ -1002,15 +1236,13 @@ void SLGridSph::get_pot(Eigen::VectorXd& vec, double x, int l, int which)
   double x2 = (x - xi[indx])/dxi;
   
 
-  for (int n=0; n<nmax; n++) {
 #ifdef USE_TABLE
-    vec[n] = (x1*table[l].ef(n, indx) + x2*table[l].ef(n, indx+1))/
-      sqrt(table[l].ev[n]) * (x1*p0[indx] + x2*p0[indx+1]);
+  double fac = x1*p0[indx] + x2*p0[indx+1];
 #else
-    vec[n] = (x1*table[l].ef(n, indx) + x2*table[l].ef(n, indx+1))/
-      sqrt(table[l].ev[n]) * sphpot(xi_to_r(x));
+  double fac = sphpot(xi_to_r(x));
 #endif
-  }
+
+  vec = (x1*fac)*knot(potT, indx, l) + (x2*fac)*knot(potT, indx+1, l);
 
 }
 
@@ -1040,15 +1272,13 @@ void SLGridSph::get_dens(Eigen::VectorXd& vec, double x, int l, int which)
   double x2 = (x - xi[indx])/dxi;
   
 
-  for (int n=0; n<nmax; n++) {
 #ifdef USE_TABLE
-    vec[n] = (x1*table[l].ef(n, indx) + x2*table[l].ef(n, indx+1))*
-      sqrt(table[l].ev[n]) * (x1*d0[indx] + x2*d0[indx+1]);
+  double fac = x1*d0[indx] + x2*d0[indx+1];
 #else
-    vec[n] = (x1*table[l].ef(n, indx) + x2*table[l].ef(n, indx+1))*
-      sqrt(table[l].ev[n]) * sphdens(xi_to_r(x));
+  double fac = sphdens(xi_to_r(x));
 #endif
-  }
+
+  vec = (x1*fac)*knot(densT, indx, l) + (x2*fac)*knot(densT, indx+1, l);
 
 }
 
@@ -1078,14 +1308,40 @@ void SLGridSph::get_force(Eigen::VectorXd& vec, double x, int l, int which)
   double p = (x - xi[indx])/dxi;
   double fac = d_xi_to_r(x)/dxi;
 
-  for (int n=0; n<nmax; n++) {
-    vec[n] = fac * (
-		    (p - 0.5)*table[l].ef(n, indx-1)*p0[indx-1]
-		    -2.0*p*table[l].ef(n, indx)*p0[indx]
-		    + (p + 0.5)*table[l].ef(n, indx+1)*p0[indx+1]
-		    ) / sqrt(table[l].ev[n]);
-  }
+  vec =
+    fac*(p - 0.5)*knot(forceT, indx-1, l)
+    -fac*2.0*p*knot(forceT, indx, l)
+    + fac*(p + 0.5)*knot(forceT, indx+1, l);
+
+}
+
+void SLGridSph::fuse_tables()
+{
+  // Column k holds every (l, n) at knot k in the column-major order
+  // of the (lmax+1) by nmax matrices returned by get_pot(), etc.  The
+  // eigenvalue normalization is folded into all three tables and the
+  // model potential into the force table, whose three-point
+  // derivative is taken of the product.  The pot and dens tables are
+  // blended first and then scaled by the interpolated model profile,
+  // as before.
+  //
+  int rows = (lmax+1)*nmax;
+
+  potT  .resize(rows, numr);
+  densT .resize(rows, numr);
+  forceT.resize(rows, numr);
 
+  for (int l=0; l<=lmax; l++) {
+    for (int n=0; n<nmax; n++) {
+      double sev = sqrt(table[l].ev[n]);
+      for (int k=0; k<numr; k++) {
+	double ef = table[l].ef(n, k);
+	potT  (l + n*(lmax+1), k) = ef/sev;
+	densT (l + n*(lmax+1), k) = ef*sev;
+	forceT(l + n*(lmax+1), k) = ef*p0[k]/sev;
+      }
+    }
+  }
 }
 
 void SLGridSph::compute_table(struct TableSph* table, int l)
@@ -1592,7 +1848,7 @@ int SLGridSph::mpi_pack_table(struct TableSph* table, int l)
 }
 
 
-void SLGridSph::mpi_unpack_table(void)
+int SLGridSph::mpi_unpack_table(void)
 {
   int l, length, position = 0;
 
@@ -1624,6 +1880,8 @@ void SLGridSph::mpi_unpack_table(void)
     for (int i=0; i<numr; i++)
       MPI_Unpack( &mpi_buf[0], length, &position, &table[l].ef(j, i), 1, 
 		  MPI_DOUBLE, MPI_COMM_WORLD);
+
+  return l;
 }
 
 
@@ -1876,6 +2134,9 @@ void SLGridSlab::bomb(string oops)
 
 				// Constructors
 
+const string slab_cache_name = ".slgrid_slab_cache";
+
+
 SLGridSlab::SLGridSlab(int NUMK, int NMAX, int NUMZ, double ZMAX,
 		       const std::string TYPE, bool VERBOSE)
 {
@@ -1942,10 +2203,16 @@ SLGridSlab::SLGridSlab(int NUMK, int NMAX, int NUMZ, double ZMAX,
 
       if (!ReadH5Cache()) {
 
-	kx = 0;
-	ky = 0;
+	std::shared_ptr<H5Checkpoint> ckpt;
+	std::vector<std::pair<int, int>> todo;
 
-	while (kx<=numk) {
+	restore_tables(ckpt, todo);
+
+	size_t next = 0;	// Next entry in the todo list
+
+	while (next<todo.size()) {
+
+	  std::tie(kx, ky) = todo[next];
 
 	  if (worker<mpi_numprocs-1) { // Send request to worker
 	    worker++;
@@ -1963,21 +2230,20 @@ SLGridSlab::SLGridSlab(int NUMK, int NMAX, int NUMZ, double ZMAX,
 			<< ": Kx=" << kx << ", Ky=" << ky << std::endl;
 
 				// Increment counters
-	    ky++;
-	    if (ky>kx) {
-	      kx++;
-	      ky = 0;
-	    }
+	    next++;
 	    
 	  }
 
-	  if (worker == mpi_numprocs-1 && kx<=numk) {
+	  if (worker == mpi_numprocs-1 && next<todo.size()) {
+
+	    std::tie(kx, ky) = todo[next];
 	  
 	    //
 	    // <Wait and receive>
 	    //
+	    int bad = 0;	// Sledge error count for this table
 #ifdef SLEDGE_THROW
-	    int bad;		// Get sledge error count
+				// Get sledge error count
 	    MPI_Recv(&bad, 1, MPI_INT, MPI_ANY_TAG, 10,
 		     MPI_COMM_WORLD, &status);
 	    totbad += bad;
@@ -1991,8 +2257,10 @@ SLGridSlab::SLGridSlab(int NUMK, int NMAX, int NUMZ, double ZMAX,
 	    
 	    int retid = status.MPI_SOURCE;
 #endif
-
-	    mpi_unpack_table();      
+				// Only a table without sledge errors
+				// may be resumed from
+	    int indx = mpi_unpack_table();
+	    if (bad==0) checkpoint_table(ckpt, indx);
 
 	    //
 	    // <Send new request>
@@ -2007,11 +2275,7 @@ SLGridSlab::SLGridSlab(int NUMK, int NMAX, int NUMZ, double ZMAX,
 			<< ": Kx=" << kx << ", Ky=" << ky << std::endl;
 
 				// Increment counters
-	    ky++;
-	    if (ky>kx) {
-	      kx++;
-	      ky = 0;
-	    }
+	    next++;
 
 	  }
 	}
@@ -2022,9 +2286,9 @@ SLGridSlab::SLGridSlab(int NUMK, int NMAX, int NUMZ, double ZMAX,
   
 	while (worker) {
 	
+	  int bad = 0;		// Sledge error count for this table
 #ifdef SLEDGE_THROW
 	  // Get sledge error count
-	  int bad;
 	  MPI_Recv(&bad, 1, MPI_INT, MPI_ANY_SOURCE, 10, MPI_COMM_WORLD,
 		   &status);
 	  totbad += bad;
@@ -2036,12 +2300,18 @@ SLGridSlab::SLGridSlab(int NUMK, int NMAX, int NUMZ, double ZMAX,
 	  MPI_Recv(&mpi_buf[0], mpi_bufsz, MPI_PACKED, MPI_ANY_SOURCE, 11,
 		   MPI_COMM_WORLD, &status);
 #endif
-	  mpi_unpack_table();      
+	  int indx = mpi_unpack_table();
+	  if (bad==0) checkpoint_table(ckpt, indx);
 
 	  worker--;
 	}
 
-	if (cache) WriteH5Cache();
+	// Promote the checkpoint or write the cache directly if
+	// checkpointing failed
+	//
+	if (cache) {
+	  if (not ckpt or not ckpt->finish()) WriteH5Cache();
+	}
 
       }
 
@@ -2096,16 +2366,26 @@ SLGridSlab::SLGridSlab(int NUMK, int NMAX, int NUMZ, double ZMAX,
 
     if (!ReadH5Cache()) {
 
-      for (kx=0; kx<=numk; kx++) {
-	for (ky=0; ky<=kx; ky++) {
-	  if (tbdbg) std::cerr << "Begin [" << kx << ", " << ky << "] . . ."
-			       << std::endl;
-	  compute_table(&(table[kx][ky]), kx, ky);
-	  if (tbdbg) std::cerr << ". . . done" << std::endl;
-	}
+      std::shared_ptr<H5Checkpoint> ckpt;
+      std::vector<std::pair<int, int>> todo;
+
+      restore_tables(ckpt, todo);
+
+      for (auto v : todo) {
+	std::tie(kx, ky) = v;
+	if (tbdbg) std::cerr << "Begin [" << kx << ", " << ky << "] . . ."
+			     << std::endl;
+	compute_table(&(table[kx][ky]), kx, ky);
+	checkpoint_table(ckpt, kx*(kx+1)/2 + ky);
+	if (tbdbg) std::cerr << ". . . done" << std::endl;
       }
 
-      if (cache) WriteH5Cache();
+      // Promote the checkpoint or write the cache directly if
+      // checkpointing failed
+      //
+      if (myid==0 and cache) {
+	if (not ckpt or not ckpt->finish()) WriteH5Cache();
+      }
     }
   }
 
@@ -2114,7 +2394,51 @@ SLGridSlab::SLGridSlab(int NUMK, int NMAX, int NUMZ, double ZMAX,
 }
 
 
-const string slab_cache_name = ".slgrid_slab_cache";
+void SLGridSlab::restore_tables(std::shared_ptr<H5Checkpoint>& ckpt,
+				std::vector<std::pair<int, int>>& todo)
+{
+  if (cache and myid==0) {
+    ckpt = std::make_shared<H5Checkpoint>
+      (slab_cache_name, "SLGridSlab",
+       [this](HighFive::File& f) { WriteH5Header(f); },
+       [this](HighFive::File& f) { return CheckH5Header(f); });
+  }
+
+  int total = 0;
+  for (int kx=0; kx<=numk; kx++) {
+    for (int ky=0; ky<=kx; ky++, total++) {
+      std::ostringstream sout;
+      sout << kx << " " << ky;
+      if (ckpt and
+	  ckpt->restore(sout.str(), table[kx][ky].ev, table[kx][ky].ef)) {
+	table[kx][ky].kx = kx;
+	table[kx][ky].ky = ky;
+      }
+      else
+	todo.push_back({kx, ky});
+    }
+  }
+
+  if (ckpt and todo.size() < static_cast<size_t>(total))
+    std::cout << "---- SLGridSlab: " << total - todo.size()
+	      << " of " << total << " tables restored" << std::endl;
+}
+
+
+void SLGridSlab::checkpoint_table(std::shared_ptr<H5Checkpoint>& ckpt, int indx)
+{
+  if (not ckpt) return;
+
+  // Invert indx = kx*(kx+1)/2 + ky
+  //
+  int kx = 0;
+  while ((kx+1)*(kx+2)/2 <= indx) kx++;
+  int ky = indx - kx*(kx+1)/2;
+
+  std::ostringstream sout;
+  sout << kx << " " << ky;
+  ckpt->write(sout.str(), table[kx][ky].ev, table[kx][ky].ef);
+}
 
 
 bool SLGridSlab::ReadH5Cache(void)
@@ -2132,61 +2456,9 @@ bool SLGridSlab::ReadH5Cache(void)
     //
     HighFive::File h5file(slab_cache_name, HighFive::File::ReadOnly);
     
-    // Try checking the rest of the parameters before reading arrays
-    //
-    auto checkInt = [&h5file](int value, std::string name)
-    {
-      int v; HighFive::Attribute vv = h5file.getAttribute(name); vv.read(v);
-      if (value == v) return true;
-      if (myid==0)
-	std::cout << "---- SLGridSlab::ReadH5Cache: "
-		  << "parameter " << name << ": wanted " << value
-		  << " found " << v << std::endl;
-      return false;
-    };
-
-    auto checkDbl = [&h5file](double value, std::string name)
-    {
-      double v; HighFive::Attribute vv = h5file.getAttribute(name); vv.read(v);
-      if (fabs(value - v) < 1.0e-16) return true;
-      if (myid==0)
-	std::cout << "---- SLGridSlab::ReadH5Cache: "
-		  << "parameter " << name << ": wanted " << value
-		  << " found " << v << std::endl;
-      return false;
-    };
-
-    auto checkStr = [&h5file](std::string value, std::string name)
-    {
-      std::string v; HighFive::Attribute vv = h5file.getAttribute(name); vv.read(v);
-      if (value.compare(v)==0) return true;
-      if (myid==0)
-	std::cout << "---- SLGridSlab::ReadH5Cache: "
-		  << "parameter " << name << ": wanted " << value
-		  << " found " << v << std::endl;
-      return false;
-    };
-
-    // For cache ID
-    //
-    std::string geometry("slab"), forceID("SLGridSlab");
-
-    // ID check
-    //
-    if (not checkStr(geometry, "geometry"))  return false;
-    if (not checkStr(forceID,  "forceID"))   return false;
-
-    // Parameter check
+    // Check the parameters before reading arrays
     //
-    if (not checkStr(type,     "type"))      return false;
-    if (not checkInt(numk,     "numk"))      return false;
-    if (not checkInt(nmax,     "nmax"))      return false;
-    if (not checkInt(numz,     "numz"))      return false;
-    if (not checkDbl(H,        "H"))         return false;
-    if (not checkDbl(L,        "L"))         return false;
-    if (not checkDbl(zmax,     "zmax"))      return false;
-    if (not checkDbl(ZBEG,     "ZBEG"))      return false;
-    if (not checkDbl(ZEND,     "ZEND"))      return false;
+    if (not CheckH5Header(h5file)) return false;
 
     // Harmonic order
     //
@@ -2230,6 +2502,66 @@ bool SLGridSlab::ReadH5Cache(void)
 
 
 
+bool SLGridSlab::CheckH5Header(HighFive::File& file)
+{
+  auto checkInt = [&file](int value, std::string name)
+  {
+    int v; HighFive::Attribute vv = file.getAttribute(name); vv.read(v);
+    if (value == v) return true;
+    if (myid==0)
+      std::cout << "---- SLGridSlab::ReadH5Cache: "
+		<< "parameter " << name << ": wanted " << value
+		<< " found " << v << std::endl;
+    return false;
+  };
+
+  auto checkDbl = [&file](double value, std::string name)
+  {
+    double v; HighFive::Attribute vv = file.getAttribute(name); vv.read(v);
+    if (fabs(value - v) < 1.0e-16) return true;
+    if (myid==0)
+      std::cout << "---- SLGridSlab::ReadH5Cache: "
+		<< "parameter " << name << ": wanted " << value
+		<< " found " << v << std::endl;
+    return false;
+  };
+
+  auto checkStr = [&file](std::string value, std::string name)
+  {
+    std::string v; HighFive::Attribute vv = file.getAttribute(name); vv.read(v);
+    if (value.compare(v)==0) return true;
+    if (myid==0)
+      std::cout << "---- SLGridSlab::ReadH5Cache: "
+		<< "parameter " << name << ": wanted " << value
+		<< " found " << v << std::endl;
+    return false;
+  };
+
+  // For cache ID
+  //
+  std::string geometry("slab"), forceID("SLGridSlab");
+
+  // ID check
+  //
+  if (not checkStr(geometry, "geometry"))  return false;
+  if (not checkStr(forceID,  "forceID"))   return false;
+
+  // Parameter check
+  //
+  if (not checkStr(type,     "type"))      return false;
+  if (not checkInt(numk,     "numk"))      return false;
+  if (not checkInt(nmax,     "nmax"))      return false;
+  if (not checkInt(numz,     "numz"))      return false;
+  if (not checkDbl(H,        "H"))         return false;
+  if (not checkDbl(L,        "L"))         return false;
+  if (not checkDbl(zmax,     "zmax"))      return false;
+  if (not checkDbl(ZBEG,     "ZBEG"))      return false;
+  if (not checkDbl(ZEND,     "ZEND"))      return false;
+
+  return true;
+}
+
+
 void SLGridSlab::WriteH5Cache(void)
 {
   if (myid) return;
@@ -2263,25 +2595,10 @@ void SLGridSlab::WriteH5Cache(void)
     HighFive::File file(slab_cache_name,
 			HighFive::File::ReadWrite | HighFive::File::Create);
     
-    // For cache ID
+    // Cache parameters
     //
-    std::string geometry("slab"), forceID("SLGridSlab");
+    WriteH5Header(file);
 
-    file.createAttribute<std::string>("geometry",  HighFive::DataSpace::From(geometry)).write(geometry);
-    file.createAttribute<std::string>("forceID",   HighFive::DataSpace::From(forceID)).write(forceID);
-      
-    // Write parameters
-    //
-    file.createAttribute<std::string> ("type",     HighFive::DataSpace::From(type)).write(type);
-    file.createAttribute<int>         ("numk",     HighFive::DataSpace::From(numk)).write(numk);
-    file.createAttribute<int>         ("nmax",     HighFive::DataSpace::From(nmax)).write(nmax);
-    file.createAttribute<int>         ("numz",     HighFive::DataSpace::From(numz)).write(numz);
-    file.createAttribute<double>      ("H",        HighFive::DataSpace::From(H)).write(H);
-    file.createAttribute<double>      ("L",        HighFive::DataSpace::From(L)).write(L);
-    file.createAttribute<double>      ("zmax",     HighFive::DataSpace::From(ZBEG)).write(zmax);
-    file.createAttribute<double>      ("ZBEG",     HighFive::DataSpace::From(ZBEG)).write(ZBEG);
-    file.createAttribute<double>      ("ZEND",     HighFive::DataSpace::From(ZEND)).write(ZEND);
-      
     // Harmonic order (for h5dump readability)
     //
     auto harmonic = file.createGroup("Harmonic");
@@ -2308,6 +2625,29 @@ void SLGridSlab::WriteH5Cache(void)
 }
 
 
+void SLGridSlab::WriteH5Header(HighFive::File& file)
+{
+  // For cache ID
+  //
+  std::string geometry("slab"), forceID("SLGridSlab");
+
+  file.createAttribute<std::string>("geometry",  HighFive::DataSpace::From(geometry)).write(geometry);
+  file.createAttribute<std::string>("forceID",   HighFive::DataSpace::From(forceID)).write(forceID);
+      
+  // Write parameters
+  //
+  file.createAttribute<std::string> ("type",     HighFive::DataSpace::From(type)).write(type);
+  file.createAttribute<int>         ("numk",     HighFive::DataSpace::From(numk)).write(numk);
+  file.createAttribute<int>         ("nmax",     HighFive::DataSpace::From(nmax)).write(nmax);
+  file.createAttribute<int>         ("numz",     HighFive::DataSpace::From(numz)).write(numz);
+  file.createAttribute<double>      ("H",        HighFive::DataSpace::From(H)).write(H);
+  file.createAttribute<double>      ("L",        HighFive::DataSpace::From(L)).write(L);
+  file.createAttribute<double>      ("zmax",     HighFive::DataSpace::From(ZBEG)).write(zmax);
+  file.createAttribute<double>      ("ZBEG",     HighFive::DataSpace::From(ZBEG)).write(ZBEG);
+  file.createAttribute<double>      ("ZEND",     HighFive::DataSpace::From(ZEND)).write(ZEND);
+}
+
+
 SLGridSlab::~SLGridSlab()
 {
   // Nothing
@@ -3442,7 +3782,7 @@ int SLGridSlab::mpi_pack_table(struct TableSlab* table, int kx, int ky)
 }
 
 
-void SLGridSlab::mpi_unpack_table(void)
+int SLGridSlab::mpi_unpack_table(void)
 {
   int length, position = 0;
   int kx, ky;
@@ -3474,6 +3814,8 @@ void SLGridSlab::mpi_unpack_table(void)
     for (int i=0; i<numz; i++)
       MPI_Unpack( &mpi_buf[0], length, &position, &table[kx][ky].ef(j, i), 1, 
 		  MPI_DOUBLE, MPI_COMM_WORLD);
+
+  return kx*(kx+1)/2 + ky;
 }
 
 std::unique_ptr<SLGridSlab::CoordMap> SLGridSlab::CoordMap::factory
@@ -566,6 +566,11 @@ double EmbeddedDiskModel::distf(double E, double L)
   return df->distf(E, L);
 }
 
+void EmbeddedDiskModel::distf_setup()
+{
+  if (dist_defined) df->setup();
+}
+
 double EmbeddedDiskModel::dfde(double E, double L)
 {
   if (!dist_defined) bomb("Embedded: <distf> not defined yet . . .");
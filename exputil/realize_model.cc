@@ -32,10 +32,12 @@
 #include <fstream>
 #include <random>
 #include <memory>
+#include <atomic>
 #include <cmath>
 
 #include <localmpi.H>
 #include <massmodel.H>
+#include <CounterRNG.H>
 #include <interp.H>
 
 #ifdef DEBUG
@@ -394,103 +396,123 @@ Eigen::VectorXd AxiSymModel::gen_point_2d(double r, int& ierr)
 
 Eigen::VectorXd AxiSymModel::gen_point_3d(int& ierr)
 {
-  if (!dist_defined) {
-    std::cerr << "AxiSymModel: must define distribution before realizing!"
-	      << std::endl;
-    exit (-1);
-  }
+  UnitRNG U = [this]() { return Unit(random_gen); };
+  return gen_point_3d(U, ierr);
+}
+
+
+void AxiSymModel::gen_table_3d()
+{
+  if (not gen_firstime) return;
 
 #ifdef DEBUG
-  static ofstream tout("gen3d.ktest");
+  orb = SphericalOrbit(this);
 #endif
 
-  double r, pot, vmax, vr=0.0, vt, eee, vt1=0.0, vt2=0.0, fmax;
-  double phi, sint, cost, sinp, cosp, azi;
-
   double rmin = max<double>(get_min_radius(), gen_rmin);
   double Emax = get_pot(get_max_radius());
 
-  if (gen_firstime) {
-
-#ifdef DEBUG
-    orb = SphericalOrbit(this);
-#endif
-
-    double tol = 1.0e-5;
-    double dx = (1.0 - 2.0*tol)/(numr-1);
-    double dy = (1.0 - 2.0*tol)/(numj-1);
-    double dr;
+  double tol = 1.0e-5;
+  double dx = (1.0 - 2.0*tol)/(numr-1);
+  double dy = (1.0 - 2.0*tol)/(numj-1);
+  double dr;
 
-    gen_mass.resize(gen_N);
-    gen_rloc.resize(gen_N);
-    gen_fmax.resize(gen_N);
+  gen_mass.resize(gen_N);
+  gen_rloc.resize(gen_N);
+  gen_fmax.resize(gen_N);
 
-    if (rmin <= 1.0e-16) gen_logr = 0;
+  if (rmin <= 1.0e-16) gen_logr = 0;
     
-    if (gen_logr)
-      dr = (log(get_max_radius()) - log(rmin))/(gen_N-1);
-    else
-      dr = (get_max_radius() - rmin)/(gen_N-1);
+  if (gen_logr)
+    dr = (log(get_max_radius()) - log(rmin))/(gen_N-1);
+  else
+    dr = (get_max_radius() - rmin)/(gen_N-1);
 
+  // Each radius is independent; the envelope search dominates.  The
+  // distribution must be complete before the threads evaluate it.
+  //
+  distf_setup();
 
-    for (int i=0; i<gen_N; i++) {
+#pragma omp parallel for schedule(dynamic) if(distf_reentrant())
+  for (int i=0; i<gen_N; i++) {
 
-      if (gen_logr) {
-	gen_rloc[i] = log(rmin) + dr*i;
-	r = exp(gen_rloc[i]);
-      }
-      else {
-	gen_rloc[i] = rmin + dr*i;
-	r = gen_rloc[i];
-      }
+    double r;
 
-      gen_mass[i] = get_mass(r);
+    if (gen_logr) {
+      gen_rloc[i] = log(rmin) + dr*i;
+      r = exp(gen_rloc[i]);
+    }
+    else {
+      gen_rloc[i] = rmin + dr*i;
+      r = gen_rloc[i];
+    }
 
-      pot = get_pot(r);
-      vmax = sqrt(2.0*fabs(Emax - pot));
+    gen_mass[i] = get_mass(r);
 
-      fmax = 0.0;
-      for (int j=0; j<numr; j++) {
-	double xxx = tol + dx*j;
+    double pot  = get_pot(r);
+    double vmax = sqrt(2.0*fabs(Emax - pot));
 
-	for (int k=0; k<numj; k++) {
-	  double yyy = tol + dy*k;
+    double fmax = 0.0;
+    for (int j=0; j<numr; j++) {
+      double xxx = tol + dx*j;
 
-	  vr = vmax*xxx;
-	  vt = vmax*sqrt((1.0 - xxx*xxx)*yyy);
-	  eee = pot + 0.5*(vr*vr + vt*vt);
+      for (int k=0; k<numj; k++) {
+	double yyy = tol + dy*k;
 
-	  double zzz = distf(eee, r*vt);
-	  fmax = zzz>fmax ? zzz : fmax;
-	}
-      }
-      gen_fmax[i] = fmax*(1.0 + ftol);
+	double vr  = vmax*xxx;
+	double vt  = vmax*sqrt((1.0 - xxx*xxx)*yyy);
+	double eee = pot + 0.5*(vr*vr + vt*vt);
 
+	double zzz = distf(eee, r*vt);
+	fmax = zzz>fmax ? zzz : fmax;
+      }
     }
+    gen_fmax[i] = fmax*(1.0 + ftol);
+  }
 
-    // Debug
-    //
-    if (myid==0) {
-      std::ofstream test("test.grid");
-      if (test) {
+  // Debug
+  //
+  if (myid==0) {
+    std::ofstream test("test.grid");
+    if (test) {
 
-	test << "# Rmin=" << rmin
-	     << "  Rmax=" << get_max_radius()
-	     << std::endl;
+      test << "# Rmin=" << rmin
+	   << "  Rmax=" << get_max_radius()
+	   << std::endl;
 	
-	for (int i=0; i<gen_N; i++) {
-	  test << std::setw(15) << gen_rloc[i]
-	       << std::setw(15) << gen_mass[i]
-	       << std::setw(15) << gen_fmax[i]
-	       << std::endl;
-	}
+      for (int i=0; i<gen_N; i++) {
+	test << std::setw(15) << gen_rloc[i]
+	     << std::setw(15) << gen_mass[i]
+	     << std::setw(15) << gen_fmax[i]
+	     << std::endl;
       }
     }
+  }
 
-    gen_firstime = false;
+  gen_firstime = false;
+}
+
+
+Eigen::VectorXd AxiSymModel::gen_point_3d(UnitRNG& U, int& ierr)
+{
+  if (!dist_defined) {
+    std::cerr << "AxiSymModel: must define distribution before realizing!"
+	      << std::endl;
+    exit (-1);
   }
 
-  r = odd2(Unit(random_gen)*gen_mass[gen_N-1], gen_mass, gen_rloc, 0);
+#ifdef DEBUG
+  static ofstream tout("gen3d.ktest");
+#endif
+
+  double r, pot, vmax, vr=0.0, vt, eee, vt1=0.0, vt2=0.0, fmax;
+  double phi, sint, cost, sinp, cosp, azi;
+
+  double Emax = get_pot(get_max_radius());
+
+  if (gen_firstime) gen_table_3d();
+
+  r = odd2(U()*gen_mass[gen_N-1], gen_mass, gen_rloc, 0);
   fmax = odd2(r, gen_rloc, gen_fmax, 1);
   if (gen_logr) r = exp(r);
   
@@ -504,28 +526,18 @@ Eigen::VectorXd AxiSymModel::gen_point_3d(int& ierr)
 
   for (it=0; it<gen_itmax; it++) {
 
-    double xxx = -2.0*cos(acos(Unit(random_gen))/3.0 - 2.0*M_PI/3.0);
-    double yyy = (1.0 - xxx*xxx)*Unit(random_gen);
+    double xxx = -2.0*cos(acos(U())/3.0 - 2.0*M_PI/3.0);
+    double yyy = (1.0 - xxx*xxx)*U();
 
     vr = vmax*xxx;
     vt = vmax*sqrt(yyy);
     eee = pot + 0.5*(vr*vr + vt*vt);
 
-    // Debug
-    /*
-    if (sqrt(vr*vr + vt*vt)>0.99*vmax) {
-      std::cout << "Check: df val = " << distf(eee, r*vt)/fmax 
-	   << "  v/vmax = " << sqrt(vr*vr + vt*vt)/vmax 
-	   << "  eee = " << eee
-	   << std::endl;
-    }
-    */
-
-    if (Unit(random_gen) > distf(eee, r*vt)/fmax ) continue;
+    if (U() > distf(eee, r*vt)/fmax ) continue;
 
-    if (Unit(random_gen)<0.5) vr *= -1.0;
+    if (U()<0.5) vr *= -1.0;
     
-    azi = 2.0*M_PI*Unit(random_gen);
+    azi = 2.0*M_PI*U();
     vt1 = vt*cos(azi);
     vt2 = vt*sin(azi);
 
@@ -534,7 +546,7 @@ Eigen::VectorXd AxiSymModel::gen_point_3d(int& ierr)
                 
   Eigen::VectorXd out(7);
 
-  static unsigned totcnt = 0, toomany = 0;
+  static std::atomic<unsigned> totcnt {0}, toomany {0};
   totcnt++;
 
   if (it==gen_itmax) {
@@ -551,10 +563,10 @@ Eigen::VectorXd AxiSymModel::gen_point_3d(int& ierr)
 
   ierr = 0;
   
-  if (Unit(random_gen)>=0.5) vr *= -1.0;
+  if (U()>=0.5) vr *= -1.0;
 
-  phi = 2.0*M_PI*Unit(random_gen);
-  cost = 2.0*(Unit(random_gen) - 0.5);
+  phi = 2.0*M_PI*U();
+  cost = 2.0*(U() - 0.5);
   sint = sqrt(1.0 - cost*cost);
   cosp = cos(phi);
   sinp = sin(phi);
@@ -794,80 +806,91 @@ Eigen::VectorXd AxiSymModel::gen_point_3d(double Emin, double Emax,
 
 Eigen::VectorXd AxiSymModel::gen_point_jeans_3d(int& ierr)
 {
-  double r, d, vr, vt, vt1, vt2, vv, vtot;
-  double phi, sint, cost, sinp, cosp, azi;
-  double rmin = max<double>(get_min_radius(), gen_rmin);
+  UnitRNG U = [this]() { return Unit(random_gen); };
+  return gen_point_jeans_3d(U, ierr);
+}
 
-  if (gen_firstime_jeans) {
-    double dr;
+void AxiSymModel::gen_table_jeans_3d()
+{
+  if (not gen_firstime_jeans) return;
 
-    gen_mass.resize(gen_N);
-    gen_rloc.resize(gen_N);
-    gen_fmax.resize(gen_N);
-    Eigen::VectorXd work(gen_N);
-    Eigen::VectorXd work2(gen_N);
+  double r, d, vtot, dr;
+  double rmin = max<double>(get_min_radius(), gen_rmin);
 
-    if (rmin <= 1.0e-16) gen_logr = 0;
-    
-    if (gen_logr)
-      dr = (log(get_max_radius()) - log(rmin))/(gen_N-1);
-    else
-      dr = (get_max_radius() - rmin)/(gen_N-1);
+  gen_mass.resize(gen_N);
+  gen_rloc.resize(gen_N);
+  gen_fmax.resize(gen_N);
+  Eigen::VectorXd work(gen_N);
+  Eigen::VectorXd work2(gen_N);
 
+  if (rmin <= 1.0e-16) gen_logr = 0;
+    
+  if (gen_logr)
+    dr = (log(get_max_radius()) - log(rmin))/(gen_N-1);
+  else
+    dr = (get_max_radius() - rmin)/(gen_N-1);
 
-    for (int i=0; i<gen_N; i++) {
 
-      if (gen_logr) {
-	gen_rloc[i] = log(rmin) + dr*i;
-	r = exp(gen_rloc[i]);
-      }
-      else {
-	gen_rloc[i] = rmin + dr*i;
-	r = gen_rloc[i];
-      }
+  for (int i=0; i<gen_N; i++) {
 
-      gen_mass[i] = get_mass(r);
-      work[i] = get_dpot(r) * get_density(r);
-      if (gen_logr) work[i] *= r;
+    if (gen_logr) {
+      gen_rloc[i] = log(rmin) + dr*i;
+      r = exp(gen_rloc[i]);
+    }
+    else {
+      gen_rloc[i] = rmin + dr*i;
+      r = gen_rloc[i];
     }
 
-    Trapsum(gen_rloc, work, work2);
+    gen_mass[i] = get_mass(r);
+    work[i] = get_dpot(r) * get_density(r);
+    if (gen_logr) work[i] *= r;
+  }
 
-    for (int i=0; i<gen_N; i++)
-      gen_fmax[i] = 3.0*(work2[gen_N-1] - work2[i]);
+  Trapsum(gen_rloc, work, work2);
 
+  for (int i=0; i<gen_N; i++)
+    gen_fmax[i] = 3.0*(work2[gen_N-1] - work2[i]);
 
-    // Debug
+
+  // Debug
     
-    ofstream test("test.grid");
-    if (test) {
+  ofstream test("test.grid");
+  if (test) {
 
-      test << "# [Jeans] Rmin=" << rmin
-	   << "  Rmax=" << get_max_radius()
-	   << std::endl;
+    test << "# [Jeans] Rmin=" << rmin
+	 << "  Rmax=" << get_max_radius()
+	 << std::endl;
 
-      for (int i=0; i<gen_N; i++) {
-	if (gen_logr) r = exp(gen_rloc[i]);
-	else r = gen_rloc[i];
+    for (int i=0; i<gen_N; i++) {
+      if (gen_logr) r = exp(gen_rloc[i]);
+      else r = gen_rloc[i];
 
-	d = get_density(r);
-	if (d>0.0 && gen_fmax[i]>=0.0)
-	  vtot = sqrt(gen_fmax[i]/d);
-	else
-	  vtot = 0.0;
+      d = get_density(r);
+      if (d>0.0 && gen_fmax[i]>=0.0)
+	vtot = sqrt(gen_fmax[i]/d);
+      else
+	vtot = 0.0;
 
-	test << std::setw(15) << gen_rloc[i]
-	     << std::setw(15) << gen_mass[i]
-	     << std::setw(15) << gen_fmax[i]
-	     << std::setw(15) << vtot
-	     << std::endl;
-      }
+      test << std::setw(15) << gen_rloc[i]
+	   << std::setw(15) << gen_mass[i]
+	   << std::setw(15) << gen_fmax[i]
+	   << std::setw(15) << vtot
+	   << std::endl;
     }
-
-    gen_firstime_jeans = false;
   }
 
-  r = odd2(Unit(random_gen)*gen_mass[gen_N-1], gen_mass, gen_rloc, 0);
+  gen_firstime_jeans = false;
+}
+
+Eigen::VectorXd AxiSymModel::gen_point_jeans_3d(UnitRNG& U, int& ierr)
+{
+  double r, d, vr, vt, vt1, vt2, vv, vtot;
+  double phi, sint, cost, sinp, cosp, azi;
+
+  if (gen_firstime_jeans) gen_table_jeans_3d();
+
+  r = odd2(U()*gen_mass[gen_N-1], gen_mass, gen_rloc, 0);
   vv = odd2(r, gen_rloc, gen_fmax);
 
   if (gen_logr) r = exp(r);
@@ -879,22 +902,22 @@ Eigen::VectorXd AxiSymModel::gen_point_jeans_3d(int& ierr)
     vtot = 0.0;
     
   
-  double xxx = -2.0*cos(acos(Unit(random_gen))/3.0 - 2.0*M_PI/3.0);
-  double yyy = (1.0 - xxx*xxx)*Unit(random_gen);
+  double xxx = -2.0*cos(acos(U())/3.0 - 2.0*M_PI/3.0);
+  double yyy = (1.0 - xxx*xxx)*U();
 
   vr = vtot*xxx;
   vt = vtot*sqrt(yyy);
 
-  azi = 2.0*M_PI*Unit(random_gen);
+  azi = 2.0*M_PI*U();
   vt1 = vt*cos(azi);
   vt2 = vt*sin(azi);
 
   Eigen::VectorXd out(7);
 
-  if (Unit(random_gen)>=0.5) vr *= -1.0;
+  if (U()>=0.5) vr *= -1.0;
 
-  phi = 2.0*M_PI*Unit(random_gen);
-  cost = 2.0*(Unit(random_gen) - 0.5);
+  phi = 2.0*M_PI*U();
+  cost = 2.0*(U() - 0.5);
   sint = sqrt(1.0 - cost*cost);
   cosp = cos(phi);
   sinp = sin(phi);
@@ -912,6 +935,54 @@ Eigen::VectorXd AxiSymModel::gen_point_jeans_3d(int& ierr)
   return out;
 }
 
+void AxiSymModel::gen_setup(bool jeans)
+{
+  if (dof()!=3) bomb("gen_setup is only implemented for dof=3");
+
+  if (jeans) gen_table_jeans_3d();
+  else       gen_table_3d();
+}
+
+Eigen::MatrixXd AxiSymModel::gen_points(int n, uint64_t seed, uint64_t first,
+					unsigned& nfail, bool jeans)
+{
+  // Tables and the distribution are computed once, before the
+  // threads share them.  Models with a non-reentrant distf() are
+  // realized by one thread; the variate streams make the result the
+  // same.
+  //
+  gen_setup(jeans);
+  distf_setup();
+
+  Eigen::MatrixXd ret(n, 7);
+  unsigned fails = 0;
+
+#pragma omp parallel for schedule(dynamic, 256) reduction(+:fails) if(distf_reentrant())
+  for (int i=0; i<n; i++) {
+
+    // One stream per particle makes the variate sequence independent
+    // of the process and thread layout
+    //
+    CounterRNG rng(seed, first + i);
+    UnitRNG U = [&rng]() { return rng.uniform(); };
+
+    Eigen::VectorXd ps;
+    int ierr;
+
+    do {
+      if (jeans) ps = gen_point_jeans(U, ierr);
+      else       ps = gen_point(U, ierr);
+      if (ierr) fails++;
+    } while (ierr);
+
+    ret.row(i) = ps.transpose();
+  }
+
+  nfail = fails;
+
+  return ret;
+}
+
 void AxiSymModel::gen_velocity(double* pos, double* vel, int& ierr)
 {
   if (dof()!=3)
@@ -1059,190 +1130,219 @@ void AxiSymModel::gen_velocity(double* pos, double* vel, int& ierr)
 
 Eigen::VectorXd SphericalModelMulti::gen_point(int& ierr)
 {
-  if (!real->dist_defined || !fake->dist_defined) {
-    std::cerr << "SphericalModelMulti: input distribution functions must be defined before realizing!" << std::endl;
-    exit (-1);
-  }
+  UnitRNG U = [this]() { return Unit(random_gen); };
+  return gen_point(U, ierr);
+}
 
-  double r, pot, vmax;
-  double vr=0.0, vt=0.0, eee=0.0, vt1=0.0, vt2=0.0, fmax, emax;
-  double mass, phi, sint, cost, sinp, cosp, azi;
+
+void SphericalModelMulti::gen_setup(bool jeans)
+{
+  if (jeans) AxiSymModel::gen_setup(jeans);
+  else       gen_table_multi();
+}
+
+
+void SphericalModelMulti::gen_table_multi()
+{
+  if (not gen_firstime) return;
 
   double Emax = get_pot(get_max_radius());
 
-  if (gen_firstime) {
+  double tol = 1.0e-5;
+  double dx = (1.0 - 2.0*tol)/(numr-1);
+  double dy = (1.0 - 2.0*tol)/(numj-1);
+  double dr;
 
-    double tol = 1.0e-5;
-    double dx = (1.0 - 2.0*tol)/(numr-1);
-    double dy = (1.0 - 2.0*tol)/(numj-1);
-    double dr;
+  gen_mass.resize(gen_N);
+  gen_rloc.resize(gen_N);
+  gen_fmax.resize(gen_N);
 
-    gen_mass.resize(gen_N);
-    gen_rloc.resize(gen_N);
-    gen_fmax.resize(gen_N);
+  gen_mass.setZero();
+  gen_rloc.setZero();
+  gen_fmax.setZero();
 
-    gen_mass.setZero();
-    gen_rloc.setZero();
-    gen_fmax.setZero();
+  std::vector<int> ibeg(numprocs);
+  std::vector<int> iend(numprocs);
 
-    std::vector<int> ibeg(numprocs);
-    std::vector<int> iend(numprocs);
+  int dN = gen_N/numprocs;
+  for (int n=0; n<numprocs; n++) {
+    ibeg[n] = dN*n;
+    iend[n] = dN*(n+1);
+  }
+  iend[numprocs-1] = gen_N;
 
-    int dN = gen_N/numprocs;
-    for (int n=0; n<numprocs; n++) {
-      ibeg[n] = dN*n;
-      iend[n] = dN*(n+1);
-    }
-    iend[numprocs-1] = gen_N;
+  std::vector<double> gen_emax(gen_N, 0.0), gen_vmax(gen_N, 0.0);
 
-    std::vector<double> gen_emax(gen_N, 0.0), gen_vmax(gen_N, 0.0);
+  if (rmin_gen <= 1.0e-16) gen_logr = 0;
 
-    if (rmin_gen <= 1.0e-16) gen_logr = 0;
-    
-    if (gen_logr)
-      dr = (log(rmax_gen) - log(rmin_gen))/(gen_N-1);
-    else
-      dr = (rmax_gen - rmin_gen)/(gen_N-1);
+  if (gen_logr)
+    dr = (log(rmax_gen) - log(rmin_gen))/(gen_N-1);
+  else
+    dr = (rmax_gen - rmin_gen)/(gen_N-1);
 
-    for (int i=ibeg[myid]; i<iend[myid]; i++) {
+  // Each radius is independent; the envelope search dominates.  The
+  // distribution must be complete before the threads evaluate it.
+  //
+  fake->distf_setup();
 
-      if (gen_logr) {
-	gen_rloc[i] = log(rmin_gen) + dr*i;
-	r = exp(gen_rloc[i]);
-      }
-      else {
-	gen_rloc[i] = rmin_gen + dr*i;
-	r = gen_rloc[i];
-      }
+#pragma omp parallel for schedule(dynamic) if(fake->distf_reentrant())
+  for (int i=ibeg[myid]; i<iend[myid]; i++) {
 
-      gen_mass[i] = fake->get_mass(r);
+    double r;
 
-      pot  = get_pot(r);
-      vmax = sqrt(2.0*fabs(Emax - pot));
+    if (gen_logr) {
+      gen_rloc[i] = log(rmin_gen) + dr*i;
+      r = exp(gen_rloc[i]);
+    }
+    else {
+      gen_rloc[i] = rmin_gen + dr*i;
+      r = gen_rloc[i];
+    }
 
-      emax = pot;
-      fmax = 0.0;
-      for (int j=0; j<numr; j++) {
-	double xxx = tol + dx*j;
+    gen_mass[i] = fake->get_mass(r);
 
-	for (int k=0; k<numj; k++) {
-	  double yyy = tol + dy*k;
+    double pot  = get_pot(r);
+    double vmax = sqrt(2.0*fabs(Emax - pot));
 
-	  vr = vmax*xxx;
-	  vt = vmax*sqrt((1.0 - xxx*xxx)*yyy);
-	  eee = pot + 0.5*(vr*vr + vt*vt);
-	  
-	  double zzz = fake->distf(eee, r*vt);
-	  if (zzz>fmax) {
-	    emax = eee;
-	    fmax = zzz;
-	  }
+    double emax = pot;
+    double fmax = 0.0;
+    for (int j=0; j<numr; j++) {
+      double xxx = tol + dx*j;
+
+      for (int k=0; k<numj; k++) {
+	double yyy = tol + dy*k;
+
+	double vr  = vmax*xxx;
+	double vt  = vmax*sqrt((1.0 - xxx*xxx)*yyy);
+	double eee = pot + 0.5*(vr*vr + vt*vt);
+
+	double zzz = fake->distf(eee, r*vt);
+	if (zzz>fmax) {
+	  emax = eee;
+	  fmax = zzz;
 	}
       }
-      gen_emax[i] = emax;
-      gen_vmax[i] = vmax;
-      gen_fmax[i] = fmax*(1.0 + ftol);
     }
+    gen_emax[i] = emax;
+    gen_vmax[i] = vmax;
+    gen_fmax[i] = fmax*(1.0 + ftol);
+  }
 
-    // These are for diagnostic output only
-    //
-    if (myid==0) {		// Node 0 receives
-      MPI_Reduce(MPI_IN_PLACE, gen_emax.data(), gen_N, MPI_DOUBLE, MPI_SUM,
-		 0, MPI_COMM_WORLD);
-      MPI_Reduce(MPI_IN_PLACE, gen_vmax.data(), gen_N, MPI_DOUBLE, MPI_SUM,
-		 0, MPI_COMM_WORLD);
-    } else {			// Nodes >0 send
-      MPI_Reduce(gen_emax.data(), 0, gen_N, MPI_DOUBLE, MPI_SUM,
-		 0, MPI_COMM_WORLD);
-      MPI_Reduce(gen_vmax.data(), 0, gen_N, MPI_DOUBLE, MPI_SUM,
-		 0, MPI_COMM_WORLD);
-    }
+  // These are for diagnostic output only
+  //
+  if (myid==0) {              // Node 0 receives
+    MPI_Reduce(MPI_IN_PLACE, gen_emax.data(), gen_N, MPI_DOUBLE, MPI_SUM,
+	       0, MPI_COMM_WORLD);
+    MPI_Reduce(MPI_IN_PLACE, gen_vmax.data(), gen_N, MPI_DOUBLE, MPI_SUM,
+	       0, MPI_COMM_WORLD);
+  } else {                    // Nodes >0 send
+    MPI_Reduce(gen_emax.data(), 0, gen_N, MPI_DOUBLE, MPI_SUM,
+	       0, MPI_COMM_WORLD);
+    MPI_Reduce(gen_vmax.data(), 0, gen_N, MPI_DOUBLE, MPI_SUM,
+	       0, MPI_COMM_WORLD);
+  }
 
-    // All processes need these . . .
-    //
-    MPI_Allreduce(MPI_IN_PLACE, gen_rloc.data(), gen_N, MPI_DOUBLE, MPI_SUM,
-		  MPI_COMM_WORLD);
-    MPI_Allreduce(MPI_IN_PLACE, gen_mass.data(), gen_N, MPI_DOUBLE, MPI_SUM,
-		  MPI_COMM_WORLD);
-    MPI_Allreduce(MPI_IN_PLACE, gen_fmax.data(), gen_N, MPI_DOUBLE, MPI_SUM,
-		  MPI_COMM_WORLD);
+  // All processes need these . . .
+  //
+  MPI_Allreduce(MPI_IN_PLACE, gen_rloc.data(), gen_N, MPI_DOUBLE, MPI_SUM,
+		MPI_COMM_WORLD);
+  MPI_Allreduce(MPI_IN_PLACE, gen_mass.data(), gen_N, MPI_DOUBLE, MPI_SUM,
+		MPI_COMM_WORLD);
+  MPI_Allreduce(MPI_IN_PLACE, gen_fmax.data(), gen_N, MPI_DOUBLE, MPI_SUM,
+		MPI_COMM_WORLD);
+
+  // Debug
+  //
+  if (myid==0) {
 
-    // Debug
-    //
-    if (myid==0) {
+    std::ofstream test("test_multi.grid");
+    if (test) {
 
-      std::ofstream test("test_multi.grid");
-      if (test) {
+      test << "# Rmin=" << rmin_gen
+	   << "  Rmax=" << rmax_gen
+	   << std::endl;
 
-	test << "# Rmin=" << rmin_gen
-	     << "  Rmax=" << rmax_gen
-	     << std::endl;
+      test << std::left 
+	   << std::endl << std::setfill('-') // Separator
+	   << std::setw(15) << "#"    
+	   << std::setw(15) << "+"
+	   << std::setw(15) << "+"
+	   << std::setw(15) << "+"
+	   << std::setw(15) << "+"
+	   << std::setw(15) << "+"
+	   << std::setw(15) << "+"
+	   << std::setw(15) << "+"
+	   << std::setw(15) << "+"
+	   << std::endl << std::setfill(' ') // Labels
+	   << std::setw(15) << "# radius"
+	   << std::setw(15) << "+ mass"
+	   << std::setw(15) << "+ Emax"
+	   << std::setw(15) << "+ Vmax"
+	   << std::setw(15) << "+ Fmax"
+	   << std::setw(15) << "+ Phi(r)"
+	   << std::setw(15) << "+ F_real(Phi)"
+	   << std::setw(15) << "+ F_fake(Phi)"
+	   << std::setw(15) << "+ Ratio"
+	   << std::endl
+	   << std::setw(15) << "# [1]" // Column number
+	   << std::setw(15) << "+ [2]"
+	   << std::setw(15) << "+ [3]"
+	   << std::setw(15) << "+ [4]"
+	   << std::setw(15) << "+ [5]"
+	   << std::setw(15) << "+ [6]"
+	   << std::setw(15) << "+ [7]"
+	   << std::setw(15) << "+ [8]"
+	   << std::setw(15) << "+ [9]"
+	   << std::endl << std::setfill('-') // Separator
+	   << std::setw(15) << "#"
+	   << std::setw(15) << "+"
+	   << std::setw(15) << "+"
+	   << std::setw(15) << "+"
+	   << std::setw(15) << "+"
+	   << std::setw(15) << "+"
+	   << std::setw(15) << "+"
+	   << std::setw(15) << "+"
+	   << std::setw(15) << "+"
+	   << std::endl << std::setfill(' ');
 
-	test << std::left 
-	     << std::endl << std::setfill('-') // Separator
-	     << std::setw(15) << "#"	
-	     << std::setw(15) << "+"
-	     << std::setw(15) << "+"
-	     << std::setw(15) << "+"
-	     << std::setw(15) << "+"
-	     << std::setw(15) << "+"
-	     << std::setw(15) << "+"
-	     << std::setw(15) << "+"
-	     << std::setw(15) << "+"
-	     << std::endl << std::setfill(' ') // Labels
-	     << std::setw(15) << "# radius"
-	     << std::setw(15) << "+ mass"
-	     << std::setw(15) << "+ Emax"
-	     << std::setw(15) << "+ Vmax"
-	     << std::setw(15) << "+ Fmax"
-	     << std::setw(15) << "+ Phi(r)"
-	     << std::setw(15) << "+ F_real(Phi)"
-	     << std::setw(15) << "+ F_fake(Phi)"
-	     << std::setw(15) << "+ Ratio"
-	     << std::endl
-	     << std::setw(15) << "# [1]" // Column number
-	     << std::setw(15) << "+ [2]"
-	     << std::setw(15) << "+ [3]"
-	     << std::setw(15) << "+ [4]"
-	     << std::setw(15) << "+ [5]"
-	     << std::setw(15) << "+ [6]"
-	     << std::setw(15) << "+ [7]"
-	     << std::setw(15) << "+ [8]"
-	     << std::setw(15) << "+ [9]"
-	     << std::endl << std::setfill('-') // Separator
-	     << std::setw(15) << "#"
-	     << std::setw(15) << "+"
-	     << std::setw(15) << "+"
-	     << std::setw(15) << "+"
-	     << std::setw(15) << "+"
-	     << std::setw(15) << "+"
-	     << std::setw(15) << "+"
-	     << std::setw(15) << "+"
-	     << std::setw(15) << "+"
-	     << std::endl << std::setfill(' ');
-
-	for (int i=0; i<gen_N; i++) {
-	  double r = exp(gen_rloc[i]);
-	  double p = get_pot(r);
-	  test << std::setw(15) << gen_rloc[i]
-	       << std::setw(15) << gen_mass[i]
-	       << std::setw(15) << gen_emax[i]
-	       << std::setw(15) << gen_vmax[i]
-	       << std::setw(15) << gen_fmax[i]
-	       << std::setw(15) << p
-	       << std::setw(15) << real->distf(p, 0.5)
-	       << std::setw(15) << fake->distf(p, 0.5)
-	       << std::setw(15) << real->get_density(r)/fake->get_density(r)
-	       << std::endl;
-	}
-      } else {
-	std::cerr << "Error opening <test_multi.grid>" << std::endl;
+      for (int i=0; i<gen_N; i++) {
+	double r = exp(gen_rloc[i]);
+	double p = get_pot(r);
+	test << std::setw(15) << gen_rloc[i]
+	     << std::setw(15) << gen_mass[i]
+	     << std::setw(15) << gen_emax[i]
+	     << std::setw(15) << gen_vmax[i]
+	     << std::setw(15) << gen_fmax[i]
+	     << std::setw(15) << p
+	     << std::setw(15) << real->distf(p, 0.5)
+	     << std::setw(15) << fake->distf(p, 0.5)
+	     << std::setw(15) << real->get_density(r)/fake->get_density(r)
+	     << std::endl;
       }
+    } else {
+      std::cerr << "Error opening <test_multi.grid>" << std::endl;
     }
+  }
 
-    gen_firstime = false;
+  gen_firstime = false;
+}
+
+
+Eigen::VectorXd SphericalModelMulti::gen_point(UnitRNG& U, int& ierr)
+{
+  if (!real->dist_defined || !fake->dist_defined) {
+    std::cerr << "SphericalModelMulti: input distribution functions must be defined before realizing!" << std::endl;
+    exit (-1);
   }
 
+  double r, pot, vmax;
+  double vr=0.0, vt=0.0, eee=0.0, vt1=0.0, vt2=0.0, fmax, emax;
+  double mass, phi, sint, cost, sinp, cosp, azi;
+
+  double Emax = get_pot(get_max_radius());
+
+  if (gen_firstime) gen_table_multi();
+
 				// Diagnostics
   int reject=0, negmass=0;
 				// Save DF evaluations
@@ -1258,7 +1358,7 @@ Eigen::VectorXd SphericalModelMulti::gen_point(int& ierr)
   // v
 #if  FIXED_RADIUS>0
   // Generate a radius (outside the loop)
-  mass = gen_mass[0] + Unit(random_gen)*(gen_mass[gen_N-1]-gen_mass[0]);
+  mass = gen_mass[0] + U()*(gen_mass[gen_N-1]-gen_mass[0]);
   r    = odd2(mass, gen_mass, gen_rloc, 0);
   fmax = odd2(r, gen_rloc, gen_fmax, 1);
   if (gen_logr) r = exp(r);
@@ -1274,7 +1374,7 @@ Eigen::VectorXd SphericalModelMulti::gen_point(int& ierr)
   for (it=0; it<gen_itmax; it++) {
 
     // Generate a radius (inside the loop)
-    mass = gen_mass[0] + Unit(random_gen)*(gen_mass[gen_N-1]-gen_mass[0]);
+    mass = gen_mass[0] + U()*(gen_mass[gen_N-1]-gen_mass[0]);
     r = odd2(mass, gen_mass, gen_rloc, 0);
     fmax = odd2(r, gen_rloc, gen_fmax, 1);
     if (gen_logr) r = exp(r);
@@ -1283,8 +1383,8 @@ Eigen::VectorXd SphericalModelMulti::gen_point(int& ierr)
     vmax = sqrt(2.0*max<double>(Emax - pot, 0.0));
 #endif
 
-    double xxx = 2.0*sin(asin(Unit(random_gen))/3.0);
-    double yyy = (1.0 - xxx*xxx)*Unit(random_gen);
+    double xxx = 2.0*sin(asin(U())/3.0);
+    double yyy = (1.0 - xxx*xxx)*U();
 
     vr = vmax*xxx;
     vt = vmax*sqrt(yyy);
@@ -1300,15 +1400,15 @@ Eigen::VectorXd SphericalModelMulti::gen_point(int& ierr)
       continue;
     }
 
-    if (Unit(random_gen) > vvv/fmax ) {
+    if (U() > vvv/fmax ) {
       reject++;
       maxv3 = std::max<double>(maxv3, vvv);
       continue;
     }
 
-    if (Unit(random_gen) < 0.5) vr *= -1.0;
+    if (U() < 0.5) vr *= -1.0;
     
-    azi = 2.0*M_PI*Unit(random_gen);
+    azi = 2.0*M_PI*U();
     vt1 = vt*cos(azi);
     vt2 = vt*sin(azi);
 
@@ -1317,7 +1417,7 @@ Eigen::VectorXd SphericalModelMulti::gen_point(int& ierr)
                 
   Eigen::VectorXd out(7);
 
-  static unsigned totcnt = 0, toomany = 0;
+  static std::atomic<unsigned> totcnt {0}, toomany {0};
   totcnt++;
 
 
@@ -1338,10 +1438,10 @@ Eigen::VectorXd SphericalModelMulti::gen_point(int& ierr)
 
   ierr = 0;
   
-  if (Unit(random_gen)>=0.5) vr *= -1.0;
+  if (U()>=0.5) vr *= -1.0;
 
-  phi  = 2.0*M_PI*Unit(random_gen);
-  cost = 2.0*(Unit(random_gen) - 0.5);
+  phi  = 2.0*M_PI*U();
+  cost = 2.0*(U() - 0.5);
   sint = sqrt(1.0 - cost*cost);
   cosp = cos(phi);
   sinp = sin(phi);
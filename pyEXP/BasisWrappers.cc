@@ -1027,6 +1027,33 @@ void BasisFactoryClasses(py::module &m)
          __call__       : same getFields() but provides field labels in a tuple
          )",
 	 py::arg("x"), py::arg("y"), py::arg("z"))
+    .def("getFieldsBatch", &BasisClasses::BiorthBasis::getFieldsBatch,
+	 R"(
+         Return the field evaluations for many cartesian positions at
+         once.  This is much faster than calling getFields() in a loop
+         since the basis tables are reused between nearby points and
+         the evaluation is multithreaded.
+
+         Parameters
+         ----------
+         x : numpy.ndarray
+             x-axis positions
+         y : numpy.ndarray
+             y-axis positions
+         z : numpy.ndarray
+             z-axis positions
+
+         Returns
+         -------
+         fields: numpy.ndarray
+             an array with one row per position and one column per field
+             in the order given by the labels from __call__
+
+         See also
+         --------
+         getFields : get fields at a single position
+         )",
+	 py::arg("x"), py::arg("y"), py::arg("z"))
     .def("getFieldsCoefs", &BasisClasses::BiorthBasis::getFieldsCoefs,
 	 R"(
          Return the field evaluations for a given cartesian position
@@ -972,6 +972,68 @@ void CoefficientClasses(py::module &m) {
             -----
             You will get a runtime error if the H5 filename does not exist
             )",py::arg("filename"))
+    .def("setH5Chunked",
+            &CoefClasses::Coefs::setH5Chunked,
+            R"(
+            Select the chunked, time-contiguous HDF5 layout for new files
+
+            Parameters
+            ----------
+            chunked : bool
+                write one extendible (time x harmonic x radial) dataset
+                rather than one group per snapshot
+            compress : int, default=0
+                deflate level (0 for none)
+
+            Returns
+            -------
+            None
+
+            Notes
+            -----
+            Only spherical and cylindrical coefficients support the
+            chunked layout.  ExtendH5Coefs follows the layout of the
+            existing file.
+            )",py::arg("chunked"), py::arg("compress")=0)
+    .def_static("ReadH5Window",
+            [](const std::string& file, double tmin, double tmax,
+               const std::vector<unsigned>& harmonics,
+               const std::vector<unsigned>& radial)
+            {
+              auto [times, M] = CoefClasses::Coefs::ReadH5Window
+                (file, tmin, tmax, harmonics, radial);
+              py::array_t<std::complex<double>> ret =
+                make_ndarray3<std::complex<double>>(M);
+              return std::make_tuple(times, ret);
+            },
+            R"(
+            Read a time window and a subset of channels from a chunked
+            HDF5 coefficient file without loading the full series
+
+            Parameters
+            ----------
+            file : str
+                the file path
+            tmin : float, default=-inf
+                minimum time value
+            tmax : float, default=inf
+                maximum time value
+            harmonics : list(int), default=[]
+                harmonic indices to read; all if empty
+            radial : list(int), default=[]
+                radial indices to read; all if empty
+
+            Returns
+            -------
+            tuple(list(float), numpy.ndarray)
+                the times and a 3-dimensional array indexed by time,
+                harmonic and radial index
+            )",
+            py::arg("file"),
+            py::arg("tmin")=-std::numeric_limits<double>::max(),
+            py::arg("tmax")= std::numeric_limits<double>::max(),
+            py::arg("harmonics")=std::vector<unsigned>(),
+            py::arg("radial")=std::vector<unsigned>())
     .def("Power",
              &CoefClasses::Coefs::Power,
              R"(
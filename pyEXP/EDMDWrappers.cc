@@ -264,6 +264,30 @@ void EDMDtoolkitClasses(py::module &m) {
         data dimension and trend state but can not sure	complete consistency.
         )", py::arg("prefix"));
 
+  f.def("update", &Koopman::update,
+	R"(
+        Append new time slices to the analysis
+
+        Parameters
+        ----------
+        config : mssaConfig
+            the same components and keys as the constructor with Coefs
+            instances that extend the current time series
+
+        Returns
+        -------
+        None
+
+        Notes
+        -----
+        Use this to follow a running simulation: reread the coefficient
+        file and pass the new Coefs.  If the analysis has already been
+        computed, the new slices are folded into the rank-nEV SVD of the state matrix
+        by a rank-k (Brand) update instead of recomputing it.  The result
+        is exact for a full-rank decomposition and an approximation for a
+        truncated one.
+        )", py::arg("config"));
+
   f.def("getModes", &Koopman::getModes,
 	R"(
         Access to detrended reconstructed channel series.
@@ -94,6 +94,13 @@ void MSSAtoolkitClasses(py::module &m) {
     "                        variance matrix SVD (Traj: false). The main use\n"
     "                        for this is checking the accuracy of the default\n"
     "                        randomized matrix methods.\n"
+    "  Hankel: true          Never form the trajectory matrix. Products\n"
+    "                        with the trajectory matrix are computed by\n"
+    "                        FFT from its Hankel structure and feed a\n"
+    "                        randomized SVD whose rank defaults to the\n"
+    "                        number of requested PCs.  The reconstruction\n"
+    "                        is also done by FFT. Use this for many\n"
+    "                        channels and long windows.\n"
     "  allchan: true         Perform k-means clustering analysis using all\n"
     "                        channels simultaneously\n"
     "  distance: true        Compute w-correlation matrix PNG images using\n"
@@ -107,7 +114,9 @@ void MSSAtoolkitClasses(py::module &m) {
     "The following parameters take values,\ndefaults are given in ()\n\n"
     "  evtol: double(0.01)   Truncate by the given cumulative p-value in\n"
     "                        chatty mode\n"
-    "  output: str(exp_mssa) Prefix name for output files\n\n"
+    "  output: str(exp_mssa) Prefix name for output files\n"
+    "  powerIter: int(2)     Number of power iterations for the Hankel\n"
+    "                        randomized SVD\n\n"
     "The 'output' value is only used if 'writeFiles' is specified, too.\n"
     "A simple YAML configuration for expMSSA might look like this:\n"
     "---\n"
@@ -218,6 +227,23 @@ void MSSAtoolkitClasses(py::module &m) {
         cumulatively summed vector
     )");
 
+  f.def("explained", &expMSSA::explained,
+    R"(
+    Cumulative fraction of the total variance explained by the
+    eigenvalues from the MSSA analysis
+
+    Returns
+    -------
+    list (float)
+        cumulative variance fractions
+
+    Notes
+    -----
+    The total includes the variance beyond the computed rank, so the
+    last entry is less than one when the rank is truncated, as it is
+    by default with the 'Hankel' flag.
+    )");
+
   
   f.def("getU", &expMSSA::getU,
 	R"(
@@ -520,6 +546,31 @@ void MSSAtoolkitClasses(py::module &m) {
         and trend state but cannot ensure complete consistency.
         )", py::arg("prefix"));
 
+  f.def("update", &expMSSA::update,
+	R"(
+        Append new time slices to the analysis
+
+        Parameters
+        ----------
+        config : mssaConfig
+            the same components and keys as the constructor with Coefs
+            instances that extend the current time series
+
+        Returns
+        -------
+        None
+
+        Notes
+        -----
+        Use this to follow a running simulation: reread the coefficient
+        file and pass the new Coefs.  If the analysis has already been
+        computed, the new slices are folded into the current SVD of the trajectory matrix
+        by a rank-k (Brand) update instead of recomputing it.  The result
+        is exact for a full-rank decomposition and an approximation for a
+        truncated one.  The new slices are detrended with the mean and
+        variance of the original series and the window length is kept.
+        )", py::arg("config"));
+
 
   f.def("getTotVar", &expMSSA::getTotVar,
 	R"(
@@ -0,0 +1,198 @@
+#include <filesystem>
+#include <algorithm>
+#include <iterator>
+#include <fstream>
+#include <map>
+
+#include "expand.H"
+#include <AsyncWriter.H>
+
+std::unique_ptr<AsyncWriter> AsyncWriter::writer;
+
+AsyncWriter& AsyncWriter::instance()
+{
+  if (not writer) writer = std::make_unique<AsyncWriter>();
+  return *writer;
+}
+
+AsyncWriter::~AsyncWriter()
+{
+  {
+    std::lock_guard<std::mutex> lock(mtx);
+    stop = true;
+  }
+  cv_work.notify_all();
+
+  // The writer drains the queue before it exits
+  //
+  if (thrd.joinable()) thrd.join();
+
+  if (error) {
+    try {
+      std::rethrow_exception(error);
+    }
+    catch (const std::exception& e) {
+      std::cerr << "AsyncWriter: error on final write: " << e.what()
+		<< std::endl;
+    }
+    catch (...) {
+      std::cerr << "AsyncWriter: unknown error on final write" << std::endl;
+    }
+  }
+}
+
+void AsyncWriter::write(std::vector<Item>& batch)
+{
+  // Coefficient snapshots grouped by file, in order of first appearance
+  //
+  using Snaps = std::pair<CoefClasses::Coefs*,
+			  std::vector<CoefClasses::CoefStrPtr>>;
+
+  std::vector<std::string> files;
+  std::map<std::string, Snaps> snaps;
+
+  for (auto & v : batch) {
+
+    if (v.coefs) {
+      auto it = snaps.find(v.file);
+      if (it == snaps.end()) {
+	files.push_back(v.file);
+	it = snaps.emplace(v.file, Snaps(v.coefs, {})).first;
+      }
+      it->second.second.push_back(v.snap);
+    }
+    else {
+      auto mode = std::ios::out | (v.append ? std::ios::app : std::ios::trunc);
+      std::ofstream out(v.file, mode);
+      if (out) out << v.text;
+      else std::cerr << "AsyncWriter: can't open file <" << v.file
+		     << "> for writing" << std::endl;
+    }
+  }
+
+  // One HDF5 append per file
+  //
+  for (auto & f : files) {
+    auto & [coefs, list] = snaps[f];
+
+    coefs->clear();
+    for (auto & s : list) coefs->add(s);
+
+    if (std::filesystem::exists(f))
+      coefs->ExtendH5Coefs(f);
+    else
+      coefs->WriteH5Coefs(f);
+
+    coefs->clear();
+  }
+}
+
+void AsyncWriter::worker()
+{
+  while (true) {
+
+    std::vector<Item> batch;
+    {
+      std::unique_lock<std::mutex> lock(mtx);
+      cv_work.wait(lock, [&]{ return stop or queue.size(); });
+
+      // Only stop once the queue is drained
+      //
+      if (queue.empty()) return;
+
+      batch.assign(std::make_move_iterator(queue.begin()),
+		   std::make_move_iterator(queue.end()));
+      queue.clear();
+      busy = batch.size();
+    }
+    cv_space.notify_all();
+
+    try {
+      write(batch);
+    }
+    catch (...) {
+      std::lock_guard<std::mutex> lock(mtx);
+      if (not error) error = std::current_exception();
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(mtx);
+      busy = 0;
+    }
+    cv_done.notify_all();
+  }
+}
+
+void AsyncWriter::check()
+{
+  std::exception_ptr err;
+  {
+    std::lock_guard<std::mutex> lock(mtx);
+    std::swap(err, error);
+  }
+  if (err) std::rethrow_exception(err);
+}
+
+void AsyncWriter::push(Item&& item)
+{
+  check();
+
+  // Synchronous output
+  //
+  if (not async_output) {
+    std::vector<Item> batch;
+    batch.push_back(std::move(item));
+    write(batch);
+    return;
+  }
+
+  {
+    std::unique_lock<std::mutex> lock(mtx);
+
+    // Start the writer on first use
+    //
+    if (not thrd.joinable()) thrd = std::thread(&AsyncWriter::worker, this);
+
+    // Block while the queue is full
+    //
+    size_t depth = std::max<int>(async_depth, 1);
+    cv_space.wait(lock, [&]{ return queue.size() < depth; });
+
+    queue.push_back(std::move(item));
+  }
+  cv_work.notify_one();
+}
+
+void AsyncWriter::coefs(const std::string& file, CoefClasses::Coefs& coefs,
+			CoefClasses::CoefStrPtr snap)
+{
+  Item item;
+  item.file  = file;
+  item.coefs = &coefs;
+  item.snap  = snap;
+  push(std::move(item));
+}
+
+void AsyncWriter::text(const std::string& file, const std::string& data,
+		       bool append)
+{
+  Item item;
+  item.file   = file;
+  item.text   = data;
+  item.append = append;
+  push(std::move(item));
+}
+
+void AsyncWriter::flush()
+{
+  {
+    std::unique_lock<std::mutex> lock(mtx);
+    cv_done.wait(lock, [&]{ return queue.empty() and busy==0; });
+  }
+  check();
+}
+
+void AsyncWriter::flushAll()
+{
+  if (writer) writer->flush();
+}
@@ -28,7 +28,9 @@ AxisymmetricBasis::valid_keys =
     "vtkfreq",
     "tksmooth",
     "tkcum",
-    "tk_type"
+    "tk_type",
+    "h5chunked",
+    "h5compress"
   };
 
 AxisymmetricBasis:: AxisymmetricBasis(Component* c0, const YAML::Node& conf) :
@@ -58,6 +60,8 @@ AxisymmetricBasis:: AxisymmetricBasis(Component* c0, const YAML::Node& conf) :
   subsamp   = false;
   defSampT  = 1;
   sampT     = 1;
+  h5chunked = false;
+  h5compress= 0;
 
   string val;
 
@@ -80,6 +84,8 @@ AxisymmetricBasis:: AxisymmetricBasis(Component* c0, const YAML::Node& conf) :
     if (conf["tksmooth"])  tksmooth   = conf["tksmooth"].as<double>();
     if (conf["tkcum"])     tkcum      = conf["tkcum"].as<double>();
     if (conf["tk_type"])   tk_type    = setTK(conf["tk_type"].as<std::string>());
+    if (conf["h5chunked"]) h5chunked  = conf["h5chunked"].as<bool>();
+    if (conf["h5compress"])h5compress = conf["h5compress"].as<int>();
 
     if (conf["Mmax"] and not conf["Lmax"]) Lmax = Mmax;
   }
@@ -1187,88 +1193,109 @@ void AxisymmetricBasis::parallel_distribute_coefficients(void)
 }
 
 
-void AxisymmetricBasis::parallel_gather_coef2(void)
+unsigned AxisymmetricBasis::pca_pack_size()
 {
+  unsigned Lsize = (Lmax+1)*(Lmax+2)/2, sz = 0;
+
+  if (pcavar) sz += 1 + sampT*(1 + Lsize*nmax*(nmax+1));
+  if (pcaeof) sz += tvar.size()*nmax*nmax;
+
+  return sz;
+}
+
+void AxisymmetricBasis::pca_pack(double* buf)
+{
+  int Lsize = (Lmax+1)*(Lmax+2)/2;
+
   if (pcavar) {
 
-    // Report particles used [with storage sanity checks]
+    // Particles used
     //
-    if (use.size()>0) {
-      for (int n=1; n<nthrds; n++) use[0] += use[n];
-      MPI_Allreduce(&use[0], &used, 1,
-		    MPI_INT, MPI_SUM, MPI_COMM_WORLD);
-    } else {
-      std::cout << "[" << myid << "] AxisymmetricBasis: "
-		<< "use has zero size" << std::endl;
+    double u = 0.0;
+    for (auto v : use) u += v;
+    *buf++ = u;
+
+    // Mass, mean and covariance for each subsample
+    //
+    for (unsigned T=0; T<sampT; T++) {
+      *buf++ = T<massT1.size() ? massT1[T] : 0.0;
+      for (int l=0; l<Lsize; l++) {
+	buf = std::copy(expcoefT1[T][l]->data(),
+			expcoefT1[T][l]->data() + nmax, buf);
+	buf = std::copy(expcoefM1[T][l]->data(),
+			expcoefM1[T][l]->data() + nmax*nmax, buf);
+      }
     }
+  }
 
-    if (sampT) {
+  if (pcaeof) {
+    for (auto & v : tvar)
+      buf = std::copy(v->data(), v->data() + nmax*nmax, buf);
+  }
+}
 
-      // Report mass used [with storage sanity checks]
-      //
-      if (massT1.size() == massT.size() and massT.size()==sampT)
-	MPI_Allreduce(&massT1[0], &massT[0], sampT,
-		      MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
-      else {
-	std::cout << "[" << myid << "] AxisymmetricBasis: "
-		  << "coef2 out of bounds in mass" << std::endl;
-      }
-      
-      // Reduce mean and covariance [with storage sanity checks]
-      //
-      for (unsigned T=0; T<sampT; T++) {
-
-	for (int l=0; l<(Lmax+1)*(Lmax+2)/2; l++) {
-	  if (expcoefT1[T][l]->size()==nmax and
-	      expcoefT [T][l]->size()==nmax) {
-	    MPI_Allreduce(&(*expcoefT1[T][l])[0],
-			  &(*expcoefT [T][l])[0], nmax,
-			  MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
-	  } else {
-	    std::cout << "[" << myid << "] AxisymmetricBasis: "
-		      << "coef2 out of bounds in coef" << std::endl;
-	  }
+void AxisymmetricBasis::pca_unpack(const double* buf)
+{
+  int Lsize = (Lmax+1)*(Lmax+2)/2;
 
-	  if (expcoefM1[T][l]->rows()==nmax and
-	      expcoefM1[T][l]->cols()==nmax and
-	      expcoefM [T][l]->rows()==nmax and
-	      expcoefM [T][l]->cols()==nmax) {
-	    MPI_Allreduce(expcoefM1[T][l]->data(),
-			  expcoefM [T][l]->data(), expcoefM1[T][l]->size(),
-			  MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
-	  } else {
-	    std::cout << "[" << myid << "] AxisymmetricBasis: "
-		      << "coef2 out of bounds in disp" << std::endl;
-	  }
-	}
+  if (pcavar) {
+
+    used = static_cast<int>(std::lround(*buf++));
+
+    for (unsigned T=0; T<sampT; T++) {
+      massT[T] = *buf++;
+      for (int l=0; l<Lsize; l++) {
+	std::copy(buf, buf + nmax, expcoefT[T][l]->data());
+	buf += nmax;
+	std::copy(buf, buf + nmax*nmax, expcoefM[T][l]->data());
+	buf += nmax*nmax;
       }
     }
   }
 
   if (pcaeof) {
+    for (auto & v : tvar) {
+      std::copy(buf, buf + nmax*nmax, v->data());
+      buf += nmax*nmax;
+    }
+  }
+}
 
-    int Lsize = (Lmax+1)*(Lmax+2)/2;
+void AxisymmetricBasis::parallel_gather_coef2(void)
+{
+  // Storage sanity checks
+  //
+  if (pcavar) {
+    if (use.size()==0) {
+      std::cout << "[" << myid << "] AxisymmetricBasis: "
+		<< "use has zero size" << std::endl;
+      return;
+    }
 
-    std::vector<double> MPIinT(nmax*nmax*Lsize);
-    std::vector<double> MPIotT(nmax*nmax*Lsize);
+    if (massT.size() != sampT or
+	expcoefT1.size() != sampT or expcoefM1.size() != sampT) {
+      std::cout << "[" << myid << "] AxisymmetricBasis: "
+		<< "coef2 out of bounds" << std::endl;
+      return;
+    }
 
-    
-    for (int l=0; l<Lsize; l++) {
-      
-      for (int nn=0; nn<nmax; nn++)
-	for (int oo=0; oo<nmax; oo++)
-	  MPIinT[nmax*nmax*l + nn*nmax + oo] = (*tvar[l])(nn, oo);
-      
-      MPI_Allreduce ( &MPIinT[0], &MPIotT[0], nmax*nmax*Lmax,
-		      MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
-      
-      for (int nn=0; nn<nmax; nn++)
-	for (int oo=0; oo<nmax; oo++)
-	  (*tvar[l])(nn, oo)= MPIinT[nmax*nmax*l + nn*nmax + oo];
-      
+    if (massT1.size() != sampT) {
+      std::cout << "[" << myid << "] AxisymmetricBasis: "
+		<< "coef2 out of bounds in mass" << std::endl;
     }
   }
-  
+
+  // One reduction for all of the accumulators
+  //
+  std::vector<double> buf(pca_pack_size());
+  if (buf.size()==0) return;
+
+  pca_pack(buf.data());
+
+  MPI_Allreduce(MPI_IN_PLACE, buf.data(), buf.size(),
+		MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+
+  pca_unpack(buf.data());
 }
 
 AxisymmetricBasis::TKType AxisymmetricBasis::setTK(const std::string& tk)
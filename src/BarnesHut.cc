@@ -0,0 +1,504 @@
+#include <algorithm>
+#include <numeric>
+#include <cfloat>
+#include <cmath>
+
+#include "expand.H"
+
+#include <BarnesHut.H>
+
+const std::set<std::string>
+BarnesHut::valid_keys = {
+  "theta",
+  "leaf_size",
+  "soft_indx",
+  "soft",
+  "scale_soft",
+  "type"
+};
+
+BarnesHut::BarnesHut(Component* c0, const YAML::Node& conf) : PotAccel(c0, conf)
+{
+  // Tree parameters
+  //
+  theta      = 0.6;
+  leaf_size  = 8;
+
+  // Standard softening
+  //
+  soft_indx  = 0;
+  soft       = 0.01;
+  fixed_soft = true;
+  scale_soft = false;
+
+  initialize();
+
+  stack.resize(nthrds);
+}
+
+void BarnesHut::initialize(void)
+{
+  // Remove matched keys
+  //
+  for (auto v : valid_keys) current_keys.erase(v);
+
+  // Assign values from YAML
+  //
+  try {
+    if (conf["theta"])      theta      = conf["theta"].as<double>();
+    if (conf["leaf_size"])  leaf_size  = conf["leaf_size"].as<int>();
+
+    if (conf["soft_indx"]) {
+      soft_indx = conf["soft_indx"].as<int>();
+      fixed_soft = false;
+    }
+
+    if (conf["soft"]) {
+      soft = conf["soft"].as<double>();
+      fixed_soft = true;
+    }
+
+    if (conf["scale_soft"]) scale_soft = conf["scale_soft"].as<bool>();
+
+    if (conf["type"]) {
+      std::string type = conf["type"].as<std::string>();
+      if (type.compare("Spline") == 0) kernel = std::make_shared<SplineSoft>();
+      else                             kernel = std::make_shared<PlummerSoft>();
+    } else {
+      kernel = std::make_shared<SplineSoft>();
+      if (myid==0) std::cout << "BarnesHut: using SplineSoft" << std::endl;
+    }
+  }
+  catch (YAML::Exception & error) {
+    if (myid==0) std::cout << "Error parsing parameters in BarnesHut: "
+			   << error.what() << std::endl
+			   << std::string(60, '-') << std::endl
+			   << "Config node"        << std::endl
+			   << std::string(60, '-') << std::endl
+			   << conf                 << std::endl
+			   << std::string(60, '-') << std::endl;
+    throw std::runtime_error("BarnesHut::initialize: error parsing YAML");
+  }
+
+  if (theta <= 0.0) {
+    std::string msg("BarnesHut: theta must be positive");
+    throw GenericError(msg, __FILE__, __LINE__, 1019, false);
+  }
+
+  if (leaf_size < 1) leaf_size = 1;
+}
+
+void BarnesHut::get_acceleration_and_potential(Component* C)
+{
+  cC = C;
+  nbodies = cC->Number();
+
+  /*======================================*/
+  /* Determine potential and acceleration */
+  /*======================================*/
+
+  determine_acceleration_and_potential();
+}
+
+double BarnesHut::softening(Particle *P)
+{
+  if (scale_soft and P->scale > 0.0) return P->scale;
+  if (not fixed_soft) return P->dattrib[soft_indx];
+  return soft;
+}
+
+void BarnesHut::determine_acceleration_and_potential(void)
+{
+				// Make sure softening is defined if needed
+  if (!fixed_soft && component->ndattrib<soft_indx+1) {
+    std::string msg("BarnesHut: particle softening data missing");
+    throw GenericError(msg, __FILE__, __LINE__, 1019, false);
+  }
+
+  int nlocal = component->Number();
+  MPI_Allreduce(&nlocal, &used, 1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+
+  if (used==0) return;
+
+  // Load the local sources
+  //
+  double adb = component->Adiabatic();
+
+  for (auto v : {&sx, &sy, &sz, &sm, &se}) {
+    v->clear();
+    v->reserve(nlocal);
+  }
+
+  for (auto & it : component->Particles()) {
+    Particle *P = it.second.get();
+    sm.push_back(P->mass*adb);
+    sx.push_back(P->pos[0]);
+    sy.push_back(P->pos[1]);
+    sz.push_back(P->pos[2]);
+    se.push_back(softening(P));
+  }
+
+  // Active particles and their bounding box
+  //
+  std::vector<Particle*> active;
+  double box[6] = { DBL_MAX,  DBL_MAX,  DBL_MAX,
+		   -DBL_MAX, -DBL_MAX, -DBL_MAX};
+
+  for (int lev=mlevel; lev<=multistep; lev++) {
+    for (auto j : cC->levlist[lev]) {
+      if (cC->freeze(j)) continue;
+      Particle *P = cC->Part(j);
+      active.push_back(P);
+      for (int k=0; k<3; k++) {
+	box[k  ] = std::min<double>(box[k  ], P->pos[k]);
+	box[k+3] = std::max<double>(box[k+3], P->pos[k]);
+      }
+    }
+  }
+
+  // Exchange the locally essential trees
+  //
+  if (numprocs>1) {
+
+    build_tree();
+
+    std::vector<double> boxes(6*numprocs);
+    MPI_Allgather(box, 6, MPI_DOUBLE, boxes.data(), 6, MPI_DOUBLE,
+		  MPI_COMM_WORLD);
+
+    std::vector<double> sendbuf;
+    std::vector<int> scount(numprocs, 0), sdispl(numprocs, 0);
+    std::vector<int> rcount(numprocs, 0), rdispl(numprocs, 0);
+
+    for (int n=0; n<numprocs; n++) {
+      sdispl[n] = sendbuf.size();
+				// Skip self and processes with no
+				// active particles
+      if (n==myid or boxes[6*n] > boxes[6*n+3]) continue;
+      export_let(&boxes[6*n], &boxes[6*n+3], sendbuf);
+      scount[n] = sendbuf.size() - sdispl[n];
+    }
+
+    MPI_Alltoall(scount.data(), 1, MPI_INT, rcount.data(), 1, MPI_INT,
+		 MPI_COMM_WORLD);
+
+    for (int n=1; n<numprocs; n++) rdispl[n] = rdispl[n-1] + rcount[n-1];
+
+    std::vector<double> recvbuf(rdispl.back() + rcount.back());
+
+    MPI_Alltoallv(sendbuf.data(), scount.data(), sdispl.data(), MPI_DOUBLE,
+		  recvbuf.data(), rcount.data(), rdispl.data(), MPI_DOUBLE,
+		  MPI_COMM_WORLD);
+
+				// Append the imported sources
+    for (size_t i=0; i<recvbuf.size(); i+=5) {
+      sm.push_back(recvbuf[i+0]);
+      sx.push_back(recvbuf[i+1]);
+      sy.push_back(recvbuf[i+2]);
+      sz.push_back(recvbuf[i+3]);
+      se.push_back(recvbuf[i+4]);
+    }
+  }
+
+  build_tree();
+
+  // Walk the tree for each active particle.  The cost per particle
+  // varies with the local density so the loop is dynamically
+  // scheduled.
+  //
+  if (tree.size()) {
+    ThreadPool::instance().parallel_for
+      (active.size(), 0, [&](size_t beg, size_t end, int id)
+       {
+	 for (size_t i=beg; i<end; i++) {
+	   Particle *P = active[i];
+	   double acc[3] = {0.0, 0.0, 0.0}, pot = 0.0;
+	   walk(P->pos, acc, pot, id);
+	   for (int k=0; k<3; k++) P->acc[k] += acc[k];
+	   P->pot += pot;
+	 }
+       });
+  }
+				// Clear external potential flag
+  use_external = false;
+}
+
+void BarnesHut::build_tree()
+{
+  tree.clear();
+
+  int nsrc = sx.size();
+  if (nsrc==0) return;
+
+  // Root cell
+  //
+  double lo[3] = {sx[0], sy[0], sz[0]}, hi[3] = {sx[0], sy[0], sz[0]};
+  for (int i=1; i<nsrc; i++) {
+    lo[0] = std::min<double>(lo[0], sx[i]); hi[0] = std::max<double>(hi[0], sx[i]);
+    lo[1] = std::min<double>(lo[1], sy[i]); hi[1] = std::max<double>(hi[1], sy[i]);
+    lo[2] = std::min<double>(lo[2], sz[i]); hi[2] = std::max<double>(hi[2], sz[i]);
+  }
+
+  Node root;
+  root.half = 0.0;
+  for (int k=0; k<3; k++) {
+    root.center[k] = 0.5*(lo[k] + hi[k]);
+    root.half = std::max<double>(root.half, 0.5*(hi[k] - lo[k]));
+  }
+  root.half  = std::max<double>(root.half, 1.0e-12) * (1.0 + 1.0e-6);
+  root.first = 0;
+  root.count = nsrc;
+
+  tree.push_back(root);
+
+  std::vector<int> ord(nsrc), tmp(nsrc);
+  std::iota(ord.begin(), ord.end(), 0);
+
+  split(0, 0, ord, tmp);
+
+  // Put the sources in tree order so that leaves are contiguous
+  //
+  for (auto v : {&sx, &sy, &sz, &sm, &se}) {
+    std::vector<double> & a = *v;
+    std::vector<double> b(nsrc);
+    for (int i=0; i<nsrc; i++) b[i] = a[ord[i]];
+    a.swap(b);
+  }
+}
+
+void BarnesHut::split(int n, int depth,
+		      std::vector<int>& ord, std::vector<int>& tmp)
+{
+  // Copy: the node array grows below
+  Node nd = tree[n];
+
+  double mass = 0.0, com[3] = {0.0, 0.0, 0.0}, eps = 0.0;
+
+  if (nd.count <= leaf_size or depth >= max_depth) {
+
+    nd.child = -1;
+    nd.nchild = 0;
+
+    for (int i=nd.first; i<nd.first+nd.count; i++) {
+      int j = ord[i];
+      mass   += sm[j];
+      com[0] += sm[j]*sx[j];
+      com[1] += sm[j]*sy[j];
+      com[2] += sm[j]*sz[j];
+      eps    += sm[j]*se[j];
+    }
+
+  } else {
+
+    // Sort this node's sources by octant
+    //
+    int cnt[8] = {0}, off[8];
+
+    auto octant = [&](int j)
+    {
+      return
+	(sx[j] > nd.center[0] ? 1 : 0) |
+	(sy[j] > nd.center[1] ? 2 : 0) |
+	(sz[j] > nd.center[2] ? 4 : 0) ;
+    };
+
+    for (int i=nd.first; i<nd.first+nd.count; i++) cnt[octant(ord[i])]++;
+
+    off[0] = nd.first;
+    for (int o=1; o<8; o++) off[o] = off[o-1] + cnt[o-1];
+
+    for (int i=nd.first; i<nd.first+nd.count; i++)
+      tmp[off[octant(ord[i])]++] = ord[i];
+
+    std::copy(tmp.begin()+nd.first, tmp.begin()+nd.first+nd.count,
+	      ord.begin()+nd.first);
+
+    // Make the nonempty children contiguous
+    //
+    nd.child  = tree.size();
+    nd.nchild = 0;
+
+    int first = nd.first;
+    for (int o=0; o<8; o++) {
+      if (cnt[o]) {
+	Node c;
+	c.half = 0.5*nd.half;
+	c.center[0] = nd.center[0] + (o & 1 ? c.half : -c.half);
+	c.center[1] = nd.center[1] + (o & 2 ? c.half : -c.half);
+	c.center[2] = nd.center[2] + (o & 4 ? c.half : -c.half);
+	c.first = first;
+	c.count = cnt[o];
+	tree.push_back(c);
+	nd.nchild++;
+      }
+      first += cnt[o];
+    }
+
+    for (int c=0; c<nd.nchild; c++) {
+      split(nd.child+c, depth+1, ord, tmp);
+      const Node & cn = tree[nd.child+c];
+      mass   += cn.mass;
+      com[0] += cn.mass*cn.com[0];
+      com[1] += cn.mass*cn.com[1];
+      com[2] += cn.mass*cn.com[2];
+      eps    += cn.mass*cn.eps;
+    }
+  }
+
+  // Moments
+  //
+  if (mass > 0.0) {
+    for (int k=0; k<3; k++) nd.com[k] = com[k]/mass;
+    nd.eps = eps/mass;
+  } else {
+    for (int k=0; k<3; k++) nd.com[k] = nd.center[k];
+    nd.eps = soft;
+  }
+  nd.mass = mass;
+
+  nd.delta = 0.0;
+  for (int k=0; k<3; k++)
+    nd.delta += (nd.com[k] - nd.center[k])*(nd.com[k] - nd.center[k]);
+  nd.delta = std::sqrt(nd.delta);
+
+  tree[n] = nd;
+}
+
+void BarnesHut::export_let(const double* lo, const double* hi,
+			   std::vector<double>& buf)
+{
+  if (tree.size()==0) return;
+
+  auto push = [&](double m, double x, double y, double z, double e)
+  {
+    buf.push_back(m);
+    buf.push_back(x);
+    buf.push_back(y);
+    buf.push_back(z);
+    buf.push_back(e);
+  };
+
+  std::vector<int> stk(1, 0);
+
+  while (stk.size()) {
+    const Node & nd = tree[stk.back()];
+    stk.pop_back();
+
+    // Smallest distance from the box to the center of mass
+    //
+    double d2 = 0.0;
+    for (int k=0; k<3; k++) {
+      double d = std::max<double>({lo[k] - nd.com[k], 0.0, nd.com[k] - hi[k]});
+      d2 += d*d;
+    }
+
+    // A node that overlaps the box is always opened: for large theta
+    // the opening distance alone would accept it
+    //
+    bool overlap = true;
+    for (int k=0; k<3; k++) {
+      if (nd.center[k] + nd.half < lo[k] or nd.center[k] - nd.half > hi[k])
+	overlap = false;
+    }
+
+    double dcrit = 2.0*nd.half/theta + nd.delta;
+
+    if (not overlap and d2 > dcrit*dcrit) {
+      push(nd.mass, nd.com[0], nd.com[1], nd.com[2], nd.eps);
+    } else if (nd.nchild==0) {
+      for (int i=nd.first; i<nd.first+nd.count; i++)
+	push(sm[i], sx[i], sy[i], sz[i], se[i]);
+    } else {
+      for (int c=0; c<nd.nchild; c++) stk.push_back(nd.child+c);
+    }
+  }
+}
+
+void BarnesHut::walk(const double* pos, double* acc, double& pot, int id)
+{
+  // Interaction list
+  //
+  double dx[tile], dy[tile], dz[tile], rr[tile], ee[tile], ww[tile];
+  double mf[tile], pt[tile];
+  int nt = 0;
+
+  double ax = 0.0, ay = 0.0, az = 0.0, pp = 0.0;
+
+  // Evaluate the interaction list.  Sources at the current location
+  // get zero weight and unit separation so that the kernels need not
+  // branch.
+  //
+  auto flush = [&]()
+  {
+#pragma omp simd
+    for (int k=0; k<nt; k++) {
+      double r = std::sqrt(dx[k]*dx[k] + dy[k]*dy[k] + dz[k]*dz[k]);
+      bool ok = r > rtol;
+      ww[k] = ok ? ww[k] : 0.0;
+      rr[k] = ok ? r : 1.0;
+    }
+
+    kernel->eval(nt, rr, ee, mf, pt);
+
+#pragma omp simd reduction(+:ax,ay,az,pp)
+    for (int k=0; k<nt; k++) {
+      double rfac = ww[k]*mf[k]/(rr[k]*rr[k]*rr[k]);
+      ax += -dx[k]*rfac;
+      ay += -dy[k]*rfac;
+      az += -dz[k]*rfac;
+      pp += ww[k]*pt[k];
+    }
+
+    nt = 0;
+  };
+
+  auto add = [&](double m, double x, double y, double z, double e)
+  {
+    dx[nt] = pos[0] - x;
+    dy[nt] = pos[1] - y;
+    dz[nt] = pos[2] - z;
+    ww[nt] = m;
+    ee[nt] = e;
+    if (++nt == tile) flush();
+  };
+
+  // Depth-first traversal
+  //
+  std::vector<int> & stk = stack[id];
+  stk.clear();
+  stk.push_back(0);
+
+  while (stk.size()) {
+    const Node & nd = tree[stk.back()];
+    stk.pop_back();
+
+    double d2 = 0.0;
+    for (int k=0; k<3; k++) d2 += (pos[k] - nd.com[k])*(pos[k] - nd.com[k]);
+
+    // Never accept a node that contains the target; otherwise, for
+    // large theta, the particle would feel its own monopole
+    //
+    bool inside = true;
+    for (int k=0; k<3; k++) {
+      if (std::fabs(pos[k] - nd.center[k]) > nd.half) inside = false;
+    }
+
+    double dcrit = 2.0*nd.half/theta + nd.delta;
+
+    if (not inside and d2 > dcrit*dcrit) {
+      add(nd.mass, nd.com[0], nd.com[1], nd.com[2], nd.eps);
+    } else if (nd.nchild==0) {
+      for (int i=nd.first; i<nd.first+nd.count; i++)
+	add(sm[i], sx[i], sy[i], sz[i], se[i]);
+    } else {
+      for (int c=0; c<nd.nchild; c++) stk.push_back(nd.child+c);
+    }
+  }
+
+  if (nt) flush();
+
+  acc[0] += ax;
+  acc[1] += ay;
+  acc[2] += az;
+  pot    += pp;
+}
@@ -1,4 +1,5 @@
 #include <algorithm>
+#include <limits>
 #include <iostream>
 #include <iomanip>
 #include <sstream>
@@ -16,10 +17,13 @@
 #include <Cube.H>
 #include <SlabSL.H>
 #include <Direct.H>
+#include <BarnesHut.H>
 #include <Shells.H>
 #include <NoForce.H>
 #include <Orient.H>
 #include <YamlCheck.H>
+#include <ThreadPool.H>
+#include <SFCKey.H>
 
 #include "expand.H"
 
@@ -84,7 +88,8 @@ const std::set<std::string> Component::valid_keys_parm =
     "ctr_name",
     "noswitch",
     "freezeL",
-    "dtreset"
+    "dtreset",
+    "sfc"
   };
 
 const std::set<std::string> Component::valid_keys_force =
@@ -247,6 +252,7 @@ Component::Component(YAML::Node& CONF)
   noswitch    = false;		// Allow multistep switching at master step only
   dtreset     = true;		// Select time step from criteria over last step
   freezeLev   = false;		// Only compute new levels on first step
+  sfcBalance  = false;		// Load balance by particle index
 
   set_default_values();
 
@@ -357,126 +363,186 @@ void Component::set_default_values()
   if (!cconf["buffered"])        cconf["buffered"]    = buffered;
   if (!cconf["noswitch"])        cconf["noswitch"]    = noswitch;
   if (!cconf["freezeL"])         cconf["freezeL"]     = freezeLev;
+  if (!cconf["sfc"])             cconf["sfc"]         = sfcBalance;
   if (!cconf["dtreset"])         cconf["dtreset"]     = dtreset;
 }
 
 
-class thrd_pass_reset
+void Component::reset_slots()
 {
-public:
-  int id;
-  Component *c;
-  vector< vector<int> > newlist;
-};
+  if (not slot_stale) return;
+
+  plist.clear();
+  pslot.clear();
+
+  if (particles.size()) {
+
+    // Contiguous list in index order, or in space-filling-curve
+    // key order when balancing by key
+    //
+    plist.reserve(particles.size());
+    for (auto & p : particles) plist.push_back(p.second.get());
+    if (sfcBalance)
+      std::sort(plist.begin(), plist.end(),
+		[](Particle* a, Particle* b)
+		{ return a->key < b->key or (a->key == b->key and a->indx < b->indx); });
+    else
+      std::sort(plist.begin(), plist.end(),
+		[](Particle* a, Particle* b) { return a->indx < b->indx; });
 
-static vector<thrd_pass_reset> td;
-static pthread_t* t  = 0;
+    // Only use the dense table if the index span is compact;
+    // otherwise slot() falls back to the hash lookup
+    //
+    auto mm = std::minmax_element(plist.begin(), plist.end(),
+				  [](Particle* a, Particle* b) { return a->indx < b->indx; });
+    slot0 = (*mm.first)->indx;
+    unsigned long span = (*mm.second)->indx - slot0 + 1;
+
+    if (span <= slot_span_max*plist.size() + 1024) {
+      pslot.resize(span, 0);
+      for (auto p : plist) pslot[p->indx - slot0] = p;
+    }
 
-void * reset_level_lists_thrd(void *ptr)
+    // Report the switch to the hash lookup.  This is expected after
+    // a key balance on more than a few processes, since each process
+    // then holds a spatial region whose indices are scattered.
+    //
+    bool sparse = pslot.empty();
+    if (sparse and not slot_sparse)
+      std::cout << "---- Component <" << name << "> [" << myid
+		<< "]: index span " << span << " for " << plist.size()
+		<< " particles is too wide for the dense index table;"
+		<< " using the hash lookup" << std::endl;
+    slot_sparse = sparse;
+  }
+
+  slot_stale = false;
+}
+
+bool Component::soa_begin(unsigned mlevel)
 {
-  // Thread ID
-  int id = static_cast<thrd_pass_reset*>(ptr)->id;
+  reset_slots();
 
-  // Component
-  Component *c = static_cast<thrd_pass_reset*>(ptr)->c;
+  // Level offsets into the store
+  //
+  soff.assign(multistep+2, 0);
+  for (int lev=0; lev<=multistep; lev++)
+    soff[lev+1] = soff[lev] + (lev>=static_cast<int>(mlevel) ? levlist[lev].size() : 0);
 
+  size_t n = soff[multistep+1];
+  if (n==0) return false;
 
-  int nbodies = c->Number();
-  int nbeg = nbodies*(id  )/nthrds;
-  int nend = nbodies*(id+1)/nthrds;
-  
-  PartMapItr it = c->Particles().begin();
+  soa_level = mlevel;
+  store.resize(n);
 
-  std::advance(it, nbeg);
+  // With the dense table, the store slot is looked up by index
+  // without touching the particle.  soa_end() clears the entries it
+  // used, so the table only needs to be initialized when the dense
+  // table changes size.  Otherwise sslot() uses the level list
+  // position.
+  //
+  if (pslot.empty())
+    sidx.clear();
+  else if (sidx.size() != pslot.size())
+    sidx.assign(pslot.size(), -1);
 
-  vector< vector<int> > *v = &static_cast<thrd_pass_reset*>(ptr)->newlist;
+  // Gather in level list order
+  //
+  ThreadPool::instance().parallel_for
+    (n, 0, [this](size_t beg, size_t end, int id)
+    {
+      int lev = std::upper_bound(soff.begin(), soff.end(), beg) - soff.begin() - 1;
+      for (size_t s=beg; s<end; s++) {
+	while (s >= soff[lev+1]) lev++;
+	unsigned long i = levlist[lev][s - soff[lev]];
+	store.load(s, slot(i));
+	if (sidx.size()) sidx[i - slot0] = s;
+      }
+    });
 
-  for (int n=nbeg; n<nend; n++, it++) {
-    (*v)[it->second->level].push_back(it->first);
-  }
-  
-  return (NULL);
+  soa_live = true;
+
+  return true;
 }
 
-void Component::reset_level_lists()
+void Component::soa_end()
 {
-  if (td.size()==0) {
-    td = vector<thrd_pass_reset>(nthrds);
+  if (not soa_live) return;
 
-    t  = new pthread_t [nthrds];
+  soa_live = false;
 
-    if (!t) {
-      std::ostringstream sout;
-      sout << "Process " << myid
-	   << ": reset_level_lists: error allocating memory for thread";
-      throw GenericError(sout.str(), __FILE__, __LINE__, 1006, true);
-    }
-  }
-  
-  if (nthrds==1) {
+  ThreadPool::instance().parallel_for
+    (store.size(), 0, [this](size_t beg, size_t end, int id)
+    {
+      for (size_t s=beg; s<end; s++) {
+	store.save(s);
+	if (sidx.size()) sidx[store.part[s]->indx - slot0] = -1;
+      }
+    });
+}
 
-    td[0].id = 0;
-    td[0].c  = this;
-    td[0].newlist  = std::vector< std::vector<int> >(multistep+1);
+// Per-thread level lists, reused between calls
+//
+static ThreadScratch<std::vector< std::vector<int> > > newlist;
 
-    reset_level_lists_thrd(&td[0]);
+void Component::reset_level_lists()
+{
+  // The threaded level sort below walks the contiguous list
+  //
+  reset_slots();
 
-  } else {
+  ThreadPool& pool = ThreadPool::instance();
+  int nthr = pool.size();
 
-    //
-    // Make the <nthrds> threads
-    //
-    int errcode;
-    void *retval;
-  
-    for (int i=0; i<nthrds; i++) {
-    
-      td[i].id = i;
-      td[i].c  = this;
-      td[i].newlist  = std::vector< std::vector<int> >(multistep+1);
-      
-      errcode =  pthread_create(&t[i], 0, reset_level_lists_thrd, &td[i]);
+  newlist.resize(nthr);
 
-      if (errcode) {
-	std::ostringstream sout;
-	sout << "Process " << myid
-	     << " reset_level_lists: cannot make thread " << i
-	     << ", errcode=" << errcode;;
-	throw GenericError(sout.str(), __FILE__, __LINE__, 1007, true);
-      }
-#ifdef DEBUG
-      else {
-	cout << "Process " << myid << ": thread <" << i << "> created\n";
-      }
-#endif
-    }
-    
-    //
-    // Collapse the threads
-    //
-    for (int i=0; i<nthrds; i++) {
-      if ((errcode=pthread_join(t[i], &retval))) {
-	std::ostringstream sout;
-	sout << "Process " << myid
-	     << " reset_level_lists: thread join " << i
-	     << " failed, errcode=" << errcode;
-	throw GenericError(sout.str(), __FILE__, __LINE__, 1008, true);
-      }
-#ifdef DEBUG    
-      cout << "Process " << myid << ": multistep thread <" << i << "> thread exited\n";
-#endif
+  // Static slices keep each thread's list in index order so the
+  // concatenation below is sorted
+  //
+  pool.run([this, nthr](int id)
+  {
+    auto & v = newlist[id];
+    v.resize(multistep+1);
+    for (auto & l : v) l.clear();
+
+    int nbodies = plist.size();
+    int nbeg = nbodies*(id  )/nthr;
+    int nend = nbodies*(id+1)/nthr;
+  
+    for (int n=nbeg; n<nend; n++) {
+      v[plist[n]->level].push_back(plist[n]->indx);
     }
-  }
+  });
+
 				// Particle list per level.
 				// Begin with empty lists . . .
   levlist = std::vector< std::vector<int> > (multistep+1);
-  for (int i=0; i<nthrds; i++) {
+  for (int i=0; i<nthr; i++) {
     for (unsigned n=0; n<=multistep; n++) {
       levlist[n].insert(levlist[n].end(),
-			td[i].newlist[n].begin(), 
-			td[i].newlist[n].end());
+			newlist[i][n].begin(), 
+			newlist[i][n].end());
     }
   }
+
+  // Record each particle's position in its list.  Thread id's
+  // entries start after those of the lower threads.
+  //
+  pool.run([this, nthr](int id)
+  {
+    std::vector<int> pos(multistep+1, 0);
+    for (int i=0; i<id; i++) {
+      for (unsigned n=0; n<=multistep; n++) pos[n] += newlist[i][n].size();
+    }
+
+    int nbodies = plist.size();
+    int nbeg = nbodies*(id  )/nthr;
+    int nend = nbodies*(id+1)/nthr;
+  
+    for (int n=nbeg; n<nend; n++) {
+      plist[n]->levslot = pos[plist[n]->level]++;
+    }
+  });
   
   if (VERBOSE>10 and particles.size()) {
 				// Level creation check
@@ -747,6 +813,7 @@ Component::Component(YAML::Node& CONF, istream *in, bool SPL) : conf(CONF)
   noswitch    = false;		// Allow multistep switching at master step only
   dtreset     = true;		// Select level from criteria over last step
   freezeLev   = false;		// Only compute new levels on first step
+  sfcBalance  = false;		// Load balance by particle index
 
   configure();
 
@@ -824,6 +891,7 @@ void Component::configure(void)
     if (cconf["noswitch"])   noswitch  = cconf["noswitch"].as<bool>();
     if (cconf["freezeL"])   freezeLev  = cconf["freezeL" ].as<bool>();
     if (cconf["dtreset"])     dtreset  = cconf["dtreset" ].as<bool>();
+    if (cconf["sfc"    ])  sfcBalance  = cconf["sfc"     ].as<bool>();
     
     if (cconf["ton"]) {
       ton = cconf["ton"].as<double>();
@@ -886,6 +954,9 @@ void Component::configure(void)
   else if ( !id.compare("direct") ) {
     force = new Direct(this, fconf);
   }
+  else if ( !id.compare("tree") ) {
+    force = new BarnesHut(this, fconf);
+  }
   else if ( !id.compare("shells") ) {
     force = new Shells(this, fconf);
   }
@@ -1572,7 +1643,32 @@ void Component::read_bodies_and_distribute_binary_out(istream *in)
 				// bodies list
   unsigned int ipart=0;
 
-  if (myid==0) {
+  if (restart_mpiio) {
+				// Each process reads its own slice of
+				// the particle records
+    MPI_Bcast(&rsize, 1, MPI_UNSIGNED, 0, MPI_COMM_WORLD);
+
+    MPI_Offset offset = 0;
+    if (myid==0) offset = in->tellg();
+    MPI_Bcast(&offset, 1, MPI_OFFSET, 0, MPI_COMM_WORLD);
+
+    unsigned long first = 0;
+    for (int n=0; n<myid; n++) first += nbodies_table[n];
+    nbodies = nbodies_table[myid];
+
+    read_binary_mpi(outdir + infile, offset, first, nbodies, first+1, rmax1);
+
+    seq_cur = first + nbodies;
+				// Position the root stream at the next
+				// component
+    if (myid==0) in->seekg(offset + nbodies_tot*psp_record_size());
+
+    MPI_Allreduce(MPI_IN_PLACE, &rmax1,   1, MPI_DOUBLE,        MPI_MAX,
+		  MPI_COMM_WORLD);
+    MPI_Allreduce(MPI_IN_PLACE, &top_seq, 1, MPI_UNSIGNED_LONG, MPI_MAX,
+		  MPI_COMM_WORLD);
+
+  } else if (myid==0) {
 				// Read root node particles
     seq_cur = 0;
 
@@ -1708,6 +1804,88 @@ void Component::openNextBlob(std::ifstream& in,
 }
 
 
+unsigned long Component::psp_record_size()
+{
+  unsigned long recsz = (8 + ndattrib)*rsize + niattrib*sizeof(int);
+  if (indexing) recsz += sizeof(unsigned long);
+  return recsz;
+}
+
+
+void Component::read_binary_mpi(const std::string& file, MPI_Offset offset,
+				unsigned long first, unsigned long number,
+				unsigned long seq, double& r2max)
+{
+  MPI_File fh;
+  int ret = MPI_File_open(MPI_COMM_WORLD, file.c_str(), MPI_MODE_RDONLY,
+			  MPI_INFO_NULL, &fh);
+
+  if (ret != MPI_SUCCESS) {
+    char err[MPI_MAX_ERROR_STRING];
+    int len;
+    MPI_Error_string(ret, err, &len);
+    std::ostringstream sout;
+    sout << "Component::read_binary_mpi: could not open <" << file
+	 << ">, " << std::string(err, len);
+    throw GenericError(sout.str(), __FILE__, __LINE__, 1010, true);
+  }
+
+  // Read in bounded chunks so that the byte count fits in an int and
+  // the staging buffer stays small.  Every process must make the same
+  // number of collective calls.
+  //
+  const unsigned long recsz = psp_record_size();
+  const unsigned long chunk = std::max<unsigned long>(1, (1ul<<26)/recsz);
+
+  unsigned long nchunk = (number + chunk - 1)/chunk, maxchunk;
+  MPI_Allreduce(&nchunk, &maxchunk, 1, MPI_UNSIGNED_LONG, MPI_MAX,
+		MPI_COMM_WORLD);
+
+  std::vector<char> buf(std::min<unsigned long>(number, chunk)*recsz);
+
+  unsigned long done = 0;
+  for (unsigned long c=0; c<maxchunk; c++) {
+
+    unsigned long n = std::min<unsigned long>(chunk, number - done);
+
+    MPI_Status status;
+    ret = MPI_File_read_at_all(fh, offset + (first + done)*recsz,
+			       buf.data(), n*recsz, MPI_BYTE, &status);
+
+    int count = 0;
+    if (ret == MPI_SUCCESS) MPI_Get_count(&status, MPI_BYTE, &count);
+
+    if (ret != MPI_SUCCESS or static_cast<unsigned long>(count) != n*recsz) {
+      std::ostringstream sout;
+      sout << "Component::read_binary_mpi: short read from <" << file
+	   << ">, expected " << n*recsz << " bytes and got " << count;
+      throw GenericError(sout.str(), __FILE__, __LINE__, 1010, true);
+    }
+
+    const char *p = buf.data();
+    for (unsigned long i=0; i<n; i++) {
+      PartPtr part = std::make_shared<Particle>(niattrib, ndattrib);
+
+      p += part->readBinaryMPI(p, rsize, indexing, seq + done + i);
+
+      double r2 = 0.0;
+      for (int k=0; k<3; k++) r2 += part->pos[k]*part->pos[k];
+      r2max = std::max<double>(r2, r2max);
+
+				// Load the particle
+      particles[part->indx] = part;
+
+				// Record top_seq
+      top_seq = std::max<unsigned long>(part->indx, top_seq);
+    }
+
+    done += n;
+  }
+
+  MPI_File_close(&fh);
+}
+
+
 void Component::read_bodies_and_distribute_binary_spl(istream *in)
 {
   // Will contain the component header
@@ -1896,7 +2074,63 @@ void Component::read_bodies_and_distribute_binary_spl(istream *in)
 				// bodies list
   unsigned int ipart=0;
 
-  if (myid==0) {
+  if (restart_mpiio) {
+				// Get the blob names and particle
+				// counts on the root process
+    MPI_Bcast(&rsize, 1, MPI_UNSIGNED, 0, MPI_COMM_WORLD);
+
+    const size_t PBUF_SIZ = 1024;
+    std::vector<char> names(number*PBUF_SIZ, 0);
+    std::vector<unsigned long> counts(number, 0);
+
+    if (myid==0) {
+      auto fit = parts.begin();
+      std::ifstream fin;
+      for (int n=0; n<number; n++) {
+	strncpy(&names[n*PBUF_SIZ], fit->c_str(), PBUF_SIZ-1);
+	int N;
+	openNextBlob(fin, fit, N);
+	counts[n] = N;
+      }
+    }
+
+    MPI_Bcast(&number, 1, MPI_INT, 0, MPI_COMM_WORLD);
+    names.resize(number*PBUF_SIZ, 0);
+    counts.resize(number, 0);
+    MPI_Bcast(names.data(),  number*PBUF_SIZ, MPI_CHAR,          0, MPI_COMM_WORLD);
+    MPI_Bcast(counts.data(), number,          MPI_UNSIGNED_LONG, 0, MPI_COMM_WORLD);
+
+				// This process' range of records
+    unsigned long first = 0;
+    for (int n=0; n<myid; n++) first += nbodies_table[n];
+    nbodies = nbodies_table[myid];
+    unsigned long last = first + nbodies;
+
+				// Read the overlap with each blob
+    std::string dir(outdir);
+    if (dir.back() != '/') dir += '/';
+
+    unsigned long beg = 0;
+    for (int n=0; n<number; n++) {
+      unsigned long end = beg + counts[n];
+      unsigned long lo  = std::max<unsigned long>(beg, first);
+      unsigned long hi  = std::min<unsigned long>(end, last);
+      unsigned long cnt = hi > lo ? hi - lo : 0;
+
+      read_binary_mpi(dir + &names[n*PBUF_SIZ], sizeof(unsigned int),
+		      cnt ? lo - beg : 0, cnt, lo+1, rmax1);
+
+      beg = end;
+    }
+
+    seq_cur = last;
+
+    MPI_Allreduce(MPI_IN_PLACE, &rmax1,   1, MPI_DOUBLE,        MPI_MAX,
+		  MPI_COMM_WORLD);
+    MPI_Allreduce(MPI_IN_PLACE, &top_seq, 1, MPI_UNSIGNED_LONG, MPI_MAX,
+		  MPI_COMM_WORLD);
+
+  } else if (myid==0) {
 
 				// Set iterator to beginning of split list
     auto fit = parts.begin();
@@ -3398,13 +3632,18 @@ void Component::update_indices(void)
   // Cumulate
   //
   nbodies_index[0] = nbodies_table[0];
-  for (int n=0; n<numprocs; n++)
+  for (int n=1; n<numprocs; n++)
     nbodies_index[n] = nbodies_index[n-1] + nbodies_table[n];
 
 }
 
 void Component::load_balance(void)
 {
+  if (sfcBalance) {
+    load_balance_sfc();
+    return;
+  }
+
   MPI_Status status;
   vector<unsigned int> nbodies_index1(numprocs);
   vector<unsigned int> nbodies_table1(numprocs);
@@ -3639,15 +3878,225 @@ void Component::load_balance(void)
 }
 
 
-template< typename T >
-typename std::vector<T>::iterator 
-insert_sorted( std::vector<T> & vec, T const& item )
+void Component::load_balance_sfc(void)
+{
+  // Initialize the particle ferry instance with dynamic attribute sizes
+  if (not pf) pf = ParticleFerryPtr(new ParticleFerry(niattrib, ndattrib));
+
+  reset_slots();
+
+  // Global bounding box
+  //
+  double lo[3], hi[3];
+  for (int k=0; k<3; k++) {
+    lo[k] =  std::numeric_limits<double>::max();
+    hi[k] = -std::numeric_limits<double>::max();
+  }
+
+  for (auto p : plist) {
+    for (int k=0; k<3; k++) {
+      lo[k] = std::min<double>(lo[k], p->pos[k]);
+      hi[k] = std::max<double>(hi[k], p->pos[k]);
+    }
+  }
+
+  MPI_Allreduce(MPI_IN_PLACE, lo, 3, MPI_DOUBLE, MPI_MIN, MPI_COMM_WORLD);
+  MPI_Allreduce(MPI_IN_PLACE, hi, 3, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+
+  double span = 0.0;
+  for (int k=0; k<3; k++) span = std::max<double>(span, hi[k] - lo[k]);
+  if (span <= 0.0) span = 1.0;
+
+  const unsigned cmax = (1u << sfcBits) - 1;
+  const double   fac  = cmax/span;
+
+  // Assign keys
+  //
+  ThreadPool::instance().parallel_for(plist.size(), 0,
+    [&](size_t beg, size_t end, int id)
+    {
+      for (size_t i=beg; i<end; i++) {
+	unsigned x[3];
+	for (int k=0; k<3; k++)
+	  x[k] = std::min<unsigned>(cmax, (plist[i]->pos[k] - lo[k])*fac);
+	plist[i]->key = hilbertKey(x, sfcBits);
+      }
+    });
+
+  std::sort(plist.begin(), plist.end(),
+	    [](Particle* a, Particle* b)
+	    { return a->key < b->key or (a->key == b->key and a->indx < b->indx); });
+
+  // Cumulative effort along the local key order.  Particle::effort
+  // counts the force evaluations of each particle since the last
+  // balance (see ComponentContainer::compute_potential).  If none
+  // were counted (e.g. the device path), every particle counts once.
+  //
+  size_t nloc = plist.size();
+  std::vector<unsigned long> keys(nloc);
+  std::vector<double> cum(nloc+1, 0.0);
+  for (size_t i=0; i<nloc; i++) {
+    keys[i]  = plist[i]->key;
+    cum[i+1] = cum[i] + plist[i]->effort;
+  }
+
+  double wtot = cum[nloc];
+  MPI_Allreduce(MPI_IN_PLACE, &wtot, 1, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+
+  if (wtot < 1.0) {
+    for (size_t i=0; i<nloc; i++) cum[i+1] = i + 1;
+    wtot = nloc;
+    MPI_Allreduce(MPI_IN_PLACE, &wtot, 1, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+  }
+
+  // Target cumulative effort at each rank boundary, proportional to
+  // the measured processor rates
+  //
+  int nsplit = numprocs - 1;
+  std::vector<double> target(nsplit);
+  double rsum = 0.0;
+  for (int n=0; n<nsplit; n++) {
+    rsum += comp->rates[n];
+    target[n] = rsum*wtot;
+  }
+
+  // Bisect for the splitting keys; all splitters are refined together
+  // so each round is a single reduction
+  //
+  std::vector<unsigned long> klo(nsplit, 0), khi(nsplit, 1ul << (3*sfcBits));
+  std::vector<double> wbelow(nsplit);
+
+  for (int it=0; it<3*sfcBits; it++) {
+
+    for (int n=0; n<nsplit; n++) {
+      unsigned long mid = klo[n] + (khi[n] - klo[n])/2;
+      size_t j = std::lower_bound(keys.begin(), keys.end(), mid) - keys.begin();
+      wbelow[n] = cum[j];
+    }
+
+    MPI_Allreduce(MPI_IN_PLACE, wbelow.data(), nsplit,
+		  MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+
+    for (int n=0; n<nsplit; n++) {
+      unsigned long mid = klo[n] + (khi[n] - klo[n])/2;
+      if (wbelow[n] < target[n]) klo[n] = mid;
+      else                       khi[n] = mid;
+    }
+  }
+
+  // Rank n owns the keys in [khi[n-1], khi[n]).  Keys are sorted, so
+  // each destination is a contiguous run of the local list.
+  //
+  std::vector<size_t> first(numprocs+1, nloc);
+  first[0] = 0;
+  for (int n=0; n<nsplit; n++)
+    first[n+1] = std::lower_bound(keys.begin(), keys.end(), khi[n]) - keys.begin();
+  for (int n=1; n<=numprocs; n++) first[n] = std::max(first[n], first[n-1]);
+
+  std::vector<unsigned> sendcnt(numprocs), allcnt(numprocs*numprocs);
+  for (int n=0; n<numprocs; n++) sendcnt[n] = first[n+1] - first[n];
+
+  MPI_Allgather(sendcnt.data(), numprocs, MPI_UNSIGNED,
+		allcnt.data(), numprocs, MPI_UNSIGNED, MPI_COMM_WORLD);
+
+  // Ship the runs.  Every rank walks the (from, to) pairs in the same
+  // order so the point-to-point exchanges cannot deadlock.
+  //
+  unsigned moved = 0;
+
+  for (int from=0; from<numprocs; from++) {
+    for (int to=0; to<numprocs; to++) {
+
+      unsigned number = allcnt[from*numprocs + to];
+      if (from==to or number==0) continue;
+
+      moved += number;
+
+      if (myid != from and myid != to) continue;
+
+      pf->ShipParticles(to, from, number);
+
+      if (myid == from) {
+	for (size_t i=first[to]; i<first[to+1]; i++) {
+	  auto it = particles.find(plist[i]->indx);
+	  pf->SendParticle(it->second);
+	  particles.erase(it);
+	}
+      }
+
+      if (myid == to) {
+	unsigned counter = 0;
+	while (counter < number) {
+	  while (PartPtr temp=pf->RecvParticle()) {
+	    particles[temp->indx] = temp;
+	    counter++;
+	  }
+	}
+      }
+
+      slot_stale = true;
+      particle_epoch++;
+    }
+  }
+
+  // Rebuild the key-ordered list, level lists and counts
+  //
+  slot_stale = true;
+  particle_epoch++;
+  reset_level_lists();
+  update_indices();
+
+  // Start a new effort count
+  //
+  for (auto p : plist) p->effort = 0.0;
+
+  if (myid==0 and VERBOSE>4) {
+    std::cout << "Component <" << name << ">: key balance moved "
+	      << moved << " of " << nbodies_tot << " particles" << std::endl;
+  }
+}
+
+
+void Component::levlist_insert(Particle* p)
 {
-  return vec.insert
-    ( 
-     std::upper_bound( vec.begin(), vec.end(), item ),
-     item 
-      );
+  auto & v = levlist[p->level];
+  p->levslot = v.size();
+  v.push_back(p->indx);
+}
+
+bool Component::levlist_remove(Particle* p)
+{
+  int indx = p->indx;
+  int k = p->levslot;
+
+  // Not in a list
+  //
+  if (k < 0) return false;
+
+  // The slot and level must agree with the lists.  Anything else is a
+  // bookkeeping error (e.g. a level change without a list update), so
+  // report it rather than search for the particle.
+  //
+  if (p->level > multistep or k >= (int)levlist[p->level].size() or
+      levlist[p->level][k] != indx) {
+    std::ostringstream sout;
+    sout << "Component::levlist_remove [" << name << "]: particle "
+	 << indx << " with level=" << p->level << " and slot=" << k
+	 << " is not at that position in the level lists";
+    throw InternalError(sout.str(), __FILE__, __LINE__);
+  }
+
+  // Swap the last entry into the hole
+  //
+  auto & v = levlist[p->level];
+  if (k != (int)v.size()-1) {
+    v[k] = v.back();
+    slot(v[k])->levslot = k;
+  }
+  v.pop_back();
+
+  p->levslot = -1;
+  return true;
 }
 
 void Component::add_particles(int from, int to, std::vector<PartPtr>& plist)
@@ -3670,19 +4119,7 @@ void Component::add_particles(int from, int to, std::vector<PartPtr>& plist)
 
 	// Remove particle from lev list
 	//
-	bool success = false;	// Sanity check
-	for (auto & v : levlist) {
-	  auto jt = std::find(v.begin(), v.end(), (*it)->indx);
-	  if (jt != v.end()) {
-	    v.erase(jt);
-	    success = true;
-	    break;
-	  }
-	}
-
-	// Levlist sanity check
-	//
-	if (not success) {
+	if (not levlist_remove(it->get())) {
 	  std::cout << "***ERROR*** "
 		    << "Component::add_particles: could not find indx="
 		    << (*it)->indx << " in levlist in any of "
@@ -3690,6 +4127,8 @@ void Component::add_particles(int from, int to, std::vector<PartPtr>& plist)
 	}
 
 	particles.erase((*it)->indx);
+	slot_stale = true;
+	particle_epoch++;
       
 	icount++;
 	counter++;
@@ -3712,7 +4151,9 @@ void Component::add_particles(int from, int to, std::vector<PartPtr>& plist)
 
       while (PartPtr temp=pf->RecvParticle()) {
 	particles[temp->indx] = temp;
-	insert_sorted<int>(levlist[temp->level], temp->indx);
+	slot_stale = true;
+	particle_epoch++;
+	levlist_insert(temp.get());
 	counter++;
       }
 
@@ -3731,10 +4172,13 @@ void Component::add_particles(int from, int to, std::vector<PartPtr>& plist)
 
 bool Component::freeze(unsigned indx)
 {
+  double pos[3];
+  Pos(pos, indx);
+
   double r2 = 0.0;
   for (int i=0; i<3; i++) r2 += 
-			    (particles[indx]->pos[i] - com0[i] - center[i])*
-			    (particles[indx]->pos[i] - com0[i] - center[i]);
+			    (pos[i] - com0[i] - center[i])*
+			    (pos[i] - com0[i] - center[i]);
   if (r2 > rtrunc*rtrunc) return true;
   else return false;
 }
@@ -3771,51 +4215,62 @@ void Component::redistributeByList(vector<int>& redist)
   unsigned int icount;
   int indx, curnode, tonode, lastnode, M;
 
+  // Ship the current run of particles from curnode to lastnode
+  //
+  auto ship = [&]()
+  {
+    if (icount==0) return;
+
+    pf->ShipParticles(lastnode, curnode, icount);
+
+    if (myid==curnode) {
+      for (unsigned i=0; i<icount; i++) {
+	PartPtr p = particles[tlist[i]];
+	pf->SendParticle(p);
+	levlist_remove(p.get());
+	particles.erase(tlist[i]);
+      }
+      slot_stale = true;
+      particle_epoch++;
+    }
+    if (myid==lastnode) {
+      unsigned counter = 0;
+      while (counter < icount) {
+	while ((part=pf->RecvParticle())) {
+	  particles[part->indx] = part;
+	  levlist_insert(part.get());
+	  counter++;
+	}
+      }
+      slot_stale = true;
+      particle_epoch++;
+    }
+    tlist.clear();
+    icount = 0;
+  };
+
   while (it != redist.end()) {
     curnode = *(it++);		// Current owner
     M       = *(it++);		// Number to transfer to another node
     if (M) {
-      indx   = *(it++);		// Index
-      tonode = *(it++);		// Destination
-      icount = 0;		// Number transferred to destination
-
+      icount   = 0;		// Number in the current run
+      lastnode = -1;		// Destination of the current run
 
-      // Do the first particle
-      //
-      tlist.clear();
-      tlist.push_back(indx);
-      icount++;
-
-      lastnode = tonode;
-
-      // Do the remaining particles
-      //
-      for (int m=1; m<M; m++) {
-	indx   = *(it++);
-	tonode = *(it++);
+      for (int m=0; m<M; m++) {
+	indx   = *(it++);		// Index
+	tonode = *(it++);		// Destination
 				// Next destination?
-	if (tonode != lastnode && icount) {
-	  pf->ShipParticles(tonode, curnode, icount);
-
-	  if (myid==curnode) {
-	    for (unsigned i=0; i<icount; i++) {
-	      pf->SendParticle(particles[tlist[i]]);
-	      particles.erase(tlist[i]);
-	    }
-	  }
-	  if (myid==lastnode) {
-	    while ((part=pf->RecvParticle()))
-	      particles[part->indx] = part;
-	  }
-	  tlist.clear();
-	  icount = 0;
+	if (tonode != lastnode) {
+	  ship();
+	  lastnode = tonode;
 	}
-
 				// Add the particle
 	tlist.push_back(indx);
 	icount++;
       }
-	
+
+      ship();			// Ship the final run
+      
     } // End of particles on this node
     
   } // Next stanza
@@ -3871,9 +4326,10 @@ void Component::seq_new_particles()
 	p->indx  = ++top_seq;
 	p->level = multistep;
 	particles[p->indx] = p;
-				// Add to level list:
-				// last element by construction
-	levlist[p->level].push_back(p->indx); 
+	slot_stale = true;
+	particle_epoch++;
+				// Add to level list
+	levlist_insert(p.get());
       }
     }
 
@@ -3906,22 +4362,12 @@ void Component::seq_new_particles()
 void Component::DestroyPart(PartPtr p)
 {
   particles.erase(p->indx);
+  slot_stale = true;
+  particle_epoch++;
 
   // Remove from level list
   //
-  bool success = false;		// For sanity check . . .
-  for (auto & v : levlist) {
-    auto it = std::find(v.begin(), v.end(), p->indx);
-    if (it != v.end()) {
-      v.erase(it);
-      success = true;
-      break;
-    }
-  }
-
-  // Levlist sanity check
-  //
-  if (not success) {
+  if (not levlist_remove(p.get())) {
     std::cout << "***ERROR*** "
 	      << "Component::DestroyPart: could not find indx=" << p->indx
 	      << " in levlist in any of " << multistep+1 << " levels"
@@ -3937,6 +4383,8 @@ void Component::DestroyPart(PartPtr p)
 void Component::AddPart(PartPtr p)
 {
   particles[p->indx] = p;
+  slot_stale = true;
+  particle_epoch++;
 
   // Refresh size of local particle list
   nbodies = particles.size();
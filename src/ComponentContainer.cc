@@ -5,12 +5,14 @@
 #include <expand.H>
 
 #include <algorithm>
+#include <chrono>
 #include <vector>
 #include <memory>
 
 #include <ComponentContainer.H>
 #include <ExternalCollection.H>
 #include <StringTok.H>
+#include <ThreadPool.H>
 
 #ifdef USE_GPTL
 #include <gptl.h>
@@ -520,6 +522,8 @@ void ComponentContainer::compute_potential(unsigned mlevel)
     } else
 #endif
       {
+				// Refresh the dense index table
+	c->reset_slots();
 				// Look for particles at this and
 				// successive levels
 	for (int lev=mlevel; lev<=multistep; lev++) {
@@ -527,13 +531,16 @@ void ComponentContainer::compute_potential(unsigned mlevel)
 	  ntot = c->levlist[lev].size();
       
 	  for (unsigned n=0; n<ntot; n++) {
-				// Particle index
-	    indx = c->levlist[lev][n];
+				// Particle pointer
+	    Particle *p = c->Part(c->levlist[lev][n]);
+				// Count the evaluation for the
+				// key balance
+	    p->effort += 1.0;
 				// Zero-out external potential
-	    c->Part(indx)->potext = 0.0;
+	    p->potext = 0.0;
 				// Zero-out potential and acceleration
-	    c->Part(indx)->pot = 0.0;
-	    for (int k=0; k<c->dim; k++) c->Part(indx)->acc[k] = 0.0;
+	    p->pot = 0.0;
+	    for (int k=0; k<c->dim; k++) p->acc[k] = 0.0;
 	  }
 	}
       }
@@ -586,7 +593,11 @@ void ComponentContainer::compute_potential(unsigned mlevel)
       c->ParticlesToCuda();
 #endif
     } else {
+				// Run on the particle store if the
+				// force only uses the accessors
+      bool soa = not use_cuda and c->force->storeAware() and c->soa_begin(mlevel);
       c->force->get_acceleration_and_potential(c);
+      if (soa) c->soa_end();
     }
 
     c->time_so_far.stop();
@@ -656,9 +667,42 @@ void ComponentContainer::compute_potential(unsigned mlevel)
   //   check in the cuda-aware force.
   //
 
+  // Fused interactions
+  // ------------------
+  // o A component that feels more than one force, all of which
+  //   supply a batch kernel, has its forces evaluated together in
+  //   fused_interaction() after this loop
+  //
+  // o The forces on each component are still added in the order of
+  //   the interaction list, so the result does not change
+  //
+  std::map<Component*, std::vector<Source>> fused;
+
+  if (fuse_interactions and not use_cuda) {
+    std::map<Component*, std::vector<Source>> sources;
+    for (auto inter : interaction) {
+      for (auto other : inter->l)
+	sources[other].push_back({inter->c, nullptr});
+    }
+
+    for (auto & v : sources) {
+      if (v.second.size() < 2) continue;
+      bool ok = true;
+      for (auto & s : v.second) ok = ok and s.c->force->batchAware();
+      if (ok) fused[v.first].reserve(v.second.size());
+    }
+  }
+
   for (auto inter : interaction) {
 				// Iterate through the list 
     for (auto other : inter->l) {
+
+      auto it = fused.find(other);
+      if (it != fused.end()) {	// Defer to the fused pass
+	it->second.push_back({inter->c, timing ? &(itmr++)->second : nullptr});
+	continue;
+      }
+
 #if HAVE_LIBCUDA==1
       if (use_cuda) {
 	if (not inter->c->force->cudaAware() and not fetched[other]) {
@@ -691,7 +735,9 @@ void ComponentContainer::compute_potential(unsigned mlevel)
       inter->c->force->SetExternal();
 
       inter->c->force->set_multistep_level(mlevel);
+      bool soa = not use_cuda and inter->c->force->storeAware() and other->soa_begin(mlevel);
       inter->c->force->get_acceleration_and_potential(other);
+      if (soa) other->soa_end();
 
       inter->c->force->ClearExternal();
       other->time_so_far.stop();
@@ -726,6 +772,14 @@ void ComponentContainer::compute_potential(unsigned mlevel)
     }
   }
 
+  // Order the fused components as in the component list so that the
+  // work is the same on every process
+  //
+  for (auto c : components) {
+    auto it = fused.find(c);
+    if (it != fused.end()) fused_interaction(c, it->second, mlevel);
+  }
+
   if (timing) timer_inter.stop();
       
 #ifdef USE_GPTL
@@ -1044,6 +1098,101 @@ void ComponentContainer::compute_potential(unsigned mlevel)
 }
 
 
+void ComponentContainer::fused_interaction(Component* other,
+					   const std::vector<Source>& src,
+					   unsigned mlevel)
+{
+  // Particles per block: small enough that a block stays in cache
+  // while every force is applied to it
+  //
+  constexpr size_t block = 256;
+
+#ifdef USE_GPTL
+  ostringstream sout;
+  sout <<"ComponentContainer::interation fused<" << other->name << ">";
+  GPTLstart(sout.str().c_str());
+#endif
+
+  nvTracerPtr tPtr;
+  if (cuda_prof) {
+    std::ostringstream sout;
+    sout << "ComponentContainer, fused interaction [" << other->name << "]";
+    tPtr = std::make_shared<nvTracer>(sout.str().c_str());
+  }
+
+  if (timing) timer_accel.start();
+  other->time_so_far.start();
+
+  // Active particles at this and successive levels
+  //
+  std::vector<int> indx;
+  for (unsigned lev=mlevel; lev<=multistep; lev++)
+    indx.insert(indx.end(),
+		other->levlist[lev].begin(), other->levlist[lev].end());
+
+  for (auto & s : src) {
+    if (s.timer) s.timer->start();
+    s.c->force->SetExternal();
+    s.c->force->set_multistep_level(mlevel);
+    s.c->force->batch_begin(other);
+    if (s.timer) s.timer->stop();
+  }
+
+  // Kernel time per force summed over the workers
+  //
+  ThreadScratch<std::vector<double>> ktime(nthrds);
+  if (timing) {
+    for (int n=0; n<nthrds; n++) ktime[n].resize(src.size(), 0.0);
+    if (nthrds>1) timer_thr_int.start();
+  }
+
+  // The batch kernels only use the accessors
+  //
+  bool soa = other->soa_begin(mlevel);
+
+  ThreadPool::instance().parallel_for
+    (indx.size(), block, [&](size_t beg, size_t end, int id)
+    {
+      for (size_t k=0; k<src.size(); k++) {
+	if (timing) {
+	  auto t0 = std::chrono::high_resolution_clock::now();
+	  src[k].c->force->batch_eval(&indx[beg], end-beg, id);
+	  std::chrono::duration<double> dt =
+	    std::chrono::high_resolution_clock::now() - t0;
+	  ktime[id][k] += dt.count();
+	} else {
+	  src[k].c->force->batch_eval(&indx[beg], end-beg, id);
+	}
+      }
+    });
+
+  if (soa) other->soa_end();
+
+  if (timing and nthrds>1) timer_thr_int.stop();
+
+  for (size_t k=0; k<src.size(); k++) {
+    auto & s = src[k];
+    if (s.timer) {
+      s.timer->start();
+      // Wall clock share of the pass
+      double sum = 0.0;
+      for (int n=0; n<nthrds; n++) sum += ktime[n][k];
+      s.timer->add(sum/nthrds);
+    }
+    s.c->force->batch_end();
+    s.c->force->ClearExternal();
+    if (s.timer) s.timer->stop();
+  }
+
+  other->time_so_far.stop();
+  if (timing) timer_accel.stop();
+
+#ifdef USE_GPTL
+  GPTLstop (sout.str().c_str());
+#endif
+}
+
+
 void ComponentContainer::compute_expansion(unsigned mlevel)
 {
 #ifdef USE_GPTL
@@ -1099,6 +1248,10 @@ void ComponentContainer::compute_expansion(unsigned mlevel)
 #endif
   }
 
+  // Complete any non-blocking coefficient reductions
+  //
+  for (auto c : components) c->force->finish_coefficients();
+
 #ifdef USE_GPTL
   GPTLstop("ComponentContainer::compute_expansion");
 #endif
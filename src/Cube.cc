@@ -5,6 +5,7 @@
 #include <cmath>
 
 #include <Cube.H>
+#include <AsyncWriter.H>
 
 const std::set<std::string>
 Cube::valid_keys = {
@@ -14,7 +15,11 @@ Cube::valid_keys = {
   "nmaxx",
   "nmaxy",
   "nmaxz",
-  "method"
+  "method",
+  "nufft",
+  "nufft_tol",
+  "mstep_order",
+  "mstep_diag"
 };
 
 //@{
@@ -32,6 +37,12 @@ Cube::Cube(Component* c0, const YAML::Node& conf) : PotAccel(c0, conf)
   coef_dump  = true;
   byPlanes   = true;
   cuMethod   = "planes";
+  nufft      = false;
+  nufft_tol  = 1.0e-6;
+  mstep_order = 1;
+  mstep_diag  = false;
+  planR2C    = 0;
+  planC2R    = 0;
 
   // Default parameter values
   //
@@ -53,6 +64,10 @@ Cube::Cube(Component* c0, const YAML::Node& conf) : PotAccel(c0, conf)
   imz   = 1 + 2*nmaxz;		// number of x wave numbers
   osize = imx * imy * imz;	// total number of coefficients
 
+  // Mesh and transforms for the NUFFT engine
+  //
+  if (nufft) nufft_initialize();
+
   // Allocate storage
   //
   expcoef.resize(nthrds);
@@ -84,15 +99,31 @@ Cube::Cube(Component* c0, const YAML::Node& conf) : PotAccel(c0, conf)
     expcoefN[i] -> setZero();
     expcoefL[i] -> setZero();
   }
+
+  // Higher-order interpolation of the inactive levels
+  //
+  if (multistep and mstep_order>1) {
+    std::string diagfile;
+    if (mstep_diag) diagfile = outdir + runtag + ".mstep_diag." + component->name;
+    msinterp = std::make_shared<MultistepInterp>(mstep_order, multistep+1,
+						 diagfile);
+  }
     
   // Constant factors
   //
   dfac = 2.0*M_PI;
   kfac = std::complex<double>(0.0, dfac);
+
+  // Name attribute for HDF5 coefficient output
+  //
+  cubeCoefs.setName(component->name);
 }
 
 Cube::~Cube(void)
 {
+  if (planR2C) fftw_destroy_plan(planR2C);
+  if (planC2R) fftw_destroy_plan(planC2R);
+
 #if HAVE_LIBCUDA==1
   if (component->cudaDevice>=0) destroy_cuda();
 #endif
@@ -114,6 +145,10 @@ void Cube::initialize(void)
     if (conf["nmaxy" ])  nmaxy      = conf["nmaxy" ].as<int>();
     if (conf["nmaxz" ])  nmaxz      = conf["nmaxz" ].as<int>();
     if (conf["method"])  cuMethod   = conf["method"].as<std::string>();
+    if (conf["nufft" ])  nufft      = conf["nufft" ].as<bool>();
+    if (conf["nufft_tol"]) nufft_tol = conf["nufft_tol"].as<double>();
+    if (conf["mstep_order"]) mstep_order = conf["mstep_order"].as<int>();
+    if (conf["mstep_diag"])  mstep_diag  = conf["mstep_diag"].as<bool>();
   }
   catch (YAML::Exception & error) {
     if (myid==0) std::cout << "Error parsing parameters in Cube: "
@@ -168,6 +203,14 @@ void * Cube::determine_coefficients_thread(void * arg)
       if (y<0.0 or y>1.0) continue;
       if (z<0.0 or z>1.0) continue;
       
+      // Spread onto the mesh; the transform is done after the
+      // threads have finished
+      //
+      if (nufft) {
+	nufft_spread(id, mass, x, y, z);
+	continue;
+      }
+
       // Recursion multipliers
       //
       std::complex<double> stepx = std::exp(-kfac*x);
@@ -227,6 +270,11 @@ void Cube::determine_coefficients(void)
   //
   if (multistep) {
 
+    // Save the outgoing coefficients for higher-order interpolation
+    //
+    if (msinterp)
+      msinterp->push(mlevel, MultistepInterp::flatten(expcoefL[mlevel]->data(), osize), tnow);
+
     auto p = expcoefL[mlevel];
   
     expcoefL[mlevel] = expcoefN[mlevel];
@@ -262,6 +310,15 @@ void Cube::determine_coefficients(void)
 
   for (int i=0; i<nthrds; i++) use1 += use[i];
   
+  // Only the host threads spread onto the NUFFT mesh
+  //
+  bool host = true;
+#if HAVE_LIBCUDA==1
+  if (component->cudaDevice>=0 and use_cuda and not cudaAccumOverride)
+    host = false;
+#endif
+  if (nufft and host) nufft_coefficients();
+
   MPI_Allreduce ( &use1, &use0,  1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
   used = use0;
 
@@ -362,6 +419,15 @@ void * Cube::determine_acceleration_and_potential_thread(void * arg)
     double y = cC->Pos(i, 1);
     double z = cC->Pos(i, 2);
 
+    // Interpolate from the field meshes
+    if (nufft) {
+      double pot, acc[3];
+      nufft_interpolate(x, y, z, pot, acc);
+      for (int k=0; k<3; k++) cC->AddAcc(i, k, acc[k]);
+      cC->AddPot(i, pot);
+      continue;
+    }
+
     // Recursion multipliers
     auto stepx = std::exp(kfac*x);
     auto stepy = std::exp(kfac*y);
@@ -450,6 +516,17 @@ void Cube::determine_acceleration_and_potential(void)
 
   }
 
+  // Field meshes for the NUFFT engine.  The device kernels evaluate
+  // the coefficients directly, so skip them when the forces are
+  // computed there.
+  //
+  bool host = true;
+#if HAVE_LIBCUDA==1
+  if (use_cuda and cC->cudaDevice>=0 and cC->force->cudaAware() and
+      not cudaAccelOverride) host = false;
+#endif
+  if (nufft and host) nufft_fields();
+
 #if HAVE_LIBCUDA==1
   if (use_cuda and cC->cudaDevice>=0 and cC->force->cudaAware()) {
     if (cudaAccelOverride) {
@@ -503,28 +580,14 @@ void Cube::dump_coefs_h5(const std::string& file)
 				// coefficients through the map
   *cur->coefs   = expcoef[0];
 
-  // Check if file exists
+  // Copy the YAML config.  Only used when the file is created.
   //
-  if (std::filesystem::exists(file)) {
-    cubeCoefs.clear();
-    cubeCoefs.add(cur);
-    cubeCoefs.ExtendH5Coefs(file);
-  }
-  // Otherwise, extend the existing HDF5 file
+  std::ostringstream sout; sout << conf;
+  cur->buf = sout.str();	// Copy to CoefStruct buffer
+
+  // Create or extend the HDF5 file
   //
-  else {
-    // Copy the YAML config.  We only need this on the first call.
-    std::ostringstream sout; sout << conf;
-    cur->buf = sout.str();	// Copy to CoefStruct buffer
-
-    // Add the name attribute.  We only need this on the first call.
-    cubeCoefs.setName(component->name);
-
-    // And the new coefficients and write the new HDF5
-    cubeCoefs.clear();
-    cubeCoefs.add(cur);
-    cubeCoefs.WriteH5Coefs(file);
-  }
+  AsyncWriter::instance().coefs(file, cubeCoefs, cur);
 }
 
 
@@ -647,9 +710,16 @@ void Cube::compute_multistep_coefficients()
     double b = numer/denom;	// Interpolation weights
     double a = 1.0 - b;
 
-    for (int i=0; i<osize; i++) {
-      expcoef[0].data()[i] +=
-	a*expcoefL[M]->data()[i] + b*expcoefN[M]->data()[i] ;
+    if (msinterp) {
+      auto C = msinterp->combine(M, b,
+				 MultistepInterp::flatten(expcoefL[M]->data(), osize),
+				 MultistepInterp::flatten(expcoefN[M]->data(), osize));
+      MultistepInterp::addTo(C, expcoef[0].data());
+    } else {
+      for (int i=0; i<osize; i++) {
+	expcoef[0].data()[i] +=
+	  a*expcoefL[M]->data()[i] + b*expcoefN[M]->data()[i] ;
+      }
     }
     
     // Sanity debug check
@@ -674,5 +744,7 @@ void Cube::compute_multistep_coefficients()
       expcoef[0].data()[i] += expcoefN[M]->data()[i];
     }
   }
+
+  if (msinterp) msinterp->report(tnow, mstep, mdrft);
 }
 
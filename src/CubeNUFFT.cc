@@ -0,0 +1,261 @@
+// Nonuniform FFT engine for the periodic cube basis
+//
+// The coefficients are
+//
+//   c(k) = -norm(k) * sum_p m_p exp(-2 pi i k.x_p)
+//
+// for k in [-nmax, nmax]^3.  The particles are spread onto a periodic
+// mesh of size ngrid with a truncated Gaussian, the mesh is
+// transformed with FFTW and the Fourier transform of the Gaussian is
+// divided out (Greengard & Lee 2004).  With an oversampling ratio of
+// two, the error falls off as exp(-2*pi*nspread/3) for a kernel of
+// half width nspread.
+//
+// The force is the adjoint operation: the deconvolved spectra of the
+// potential and the three acceleration components are transformed back
+// to the mesh and interpolated to each particle with the same kernel.
+
+#include "expand.H"
+
+#include <algorithm>
+#include <cmath>
+
+#include <Cube.H>
+
+// Smallest even integer >= n with no prime factors other than 2, 3, 5
+//
+static int fftSize(int n)
+{
+  for (int m=std::max<int>(n, 2); ; m++) {
+    if (m % 2) continue;
+    int r = m;
+    for (int p : {2, 3, 5}) while (r % p == 0) r /= p;
+    if (r==1) return m;
+  }
+}
+
+void Cube::nufft_initialize()
+{
+  // Oversampling ratio
+  //
+  const double R = 2.0;
+
+  // Kernel half width and Gaussian width in mesh units
+  //
+  nspread = std::ceil(-std::log(nufft_tol)*(R - 0.5)/(M_PI*(R - 1.0)));
+  nspread = std::max<int>(2, std::min<int>(nspread, 16));
+  sigma   = std::sqrt(nspread*R/(2.0*M_PI*(R - 0.5)));
+
+  int nmax[3] = {nmaxx, nmaxy, nmaxz};
+
+  for (int d=0; d<3; d++) {
+    ngrid[d] = fftSize(std::max<int>(std::ceil(R*(2*nmax[d]+1)), 2*nspread));
+
+    // The mesh sum is h^3 times the FFT and the kernel transform in
+    // each dimension is sigma*h*sqrt(2*pi)*exp(-2*pi^2*k^2*sigma^2*h^2)
+    //
+    deconv[d].resize(2*nmax[d]+1);
+    for (int k=-nmax[d]; k<=nmax[d]; k++) {
+      double q = M_PI*sigma*k/ngrid[d];
+      deconv[d][k+nmax[d]] = std::exp(2.0*q*q)/(sigma*std::sqrt(2.0*M_PI));
+    }
+  }
+
+  int nreal = ngrid[0]*ngrid[1]*ngrid[2];
+  int nhalf = ngrid[0]*ngrid[1]*(ngrid[2]/2+1);
+
+  mesh.resize(nthrds);
+  for (auto & v : mesh) v.resize(nreal, 0.0);
+
+  fields  .resize(4*nreal);
+  work    .resize(nreal);
+  spectrum.resize(nhalf);
+
+  // Plans are executed on the new-array interface
+  //
+  auto data = reinterpret_cast<fftw_complex*>(spectrum.data());
+
+  planR2C = fftw_plan_dft_r2c_3d(ngrid[0], ngrid[1], ngrid[2],
+				 work.data(), data,
+				 FFTW_ESTIMATE | FFTW_UNALIGNED);
+
+  planC2R = fftw_plan_dft_c2r_3d(ngrid[0], ngrid[1], ngrid[2],
+				 data, work.data(),
+				 FFTW_ESTIMATE | FFTW_UNALIGNED);
+
+  if (myid==0) {
+    std::cout << "---- Cube: NUFFT engine with mesh "
+	      << ngrid[0] << "x" << ngrid[1] << "x" << ngrid[2]
+	      << ", kernel width " << 2*nspread
+	      << ", sigma=" << sigma << std::endl;
+  }
+}
+
+void Cube::nufft_weights(double x, int d, double* w, int* indx)
+{
+  double u = x*ngrid[d];
+  int l0 = std::floor(u);
+  double fac = 0.5/(sigma*sigma);
+
+  for (int t=0; t<2*nspread; t++) {
+    int j = l0 - nspread + 1 + t;
+    double s = u - j;
+    w[t]    = std::exp(-fac*s*s);
+    indx[t] = ((j % ngrid[d]) + ngrid[d]) % ngrid[d];
+  }
+}
+
+void Cube::nufft_spread(int id, double mass, double x, double y, double z)
+{
+  const int ns = 2*nspread;
+  double wx[32], wy[32], wz[32];
+  int    ix[32], iy[32], iz[32];
+
+  nufft_weights(x, 0, wx, ix);
+  nufft_weights(y, 1, wy, iy);
+  nufft_weights(z, 2, wz, iz);
+
+  auto & g = mesh[id];
+
+  for (int a=0; a<ns; a++) {
+    for (int b=0; b<ns; b++) {
+      double wab = mass*wx[a]*wy[b];
+      double* row = &g[(ix[a]*ngrid[1] + iy[b])*ngrid[2]];
+      for (int c=0; c<ns; c++) row[iz[c]] += wab*wz[c];
+    }
+  }
+}
+
+void Cube::nufft_coefficients()
+{
+  // Sum the thread meshes
+  //
+  std::copy(mesh[0].begin(), mesh[0].end(), work.begin());
+  for (int n=1; n<nthrds; n++) {
+    for (size_t j=0; j<work.size(); j++) work[j] += mesh[n][j];
+  }
+  for (auto & v : mesh) std::fill(v.begin(), v.end(), 0.0);
+
+  fftw_execute_dft_r2c(planR2C, work.data(),
+		       reinterpret_cast<fftw_complex*>(spectrum.data()));
+
+  // Unpack the half spectrum; negative kz follow from the Hermitian
+  // symmetry of a real mesh
+  //
+  int nz = ngrid[2]/2 + 1;
+
+  for (int ix=0; ix<imx; ix++) {
+    int ii = ix - nmaxx;
+    for (int iy=0; iy<imy; iy++) {
+      int jj = iy - nmaxy;
+      for (int iz=0; iz<imz; iz++) {
+	int kk = iz - nmaxz;
+
+	if (ii==0 and jj==0 and kk==0) continue;
+
+	int sgn = kk < 0 ? -1 : 1;
+	int jx  = ((sgn*ii) % ngrid[0] + ngrid[0]) % ngrid[0];
+	int jy  = ((sgn*jj) % ngrid[1] + ngrid[1]) % ngrid[1];
+	auto f  = spectrum[(jx*ngrid[1] + jy)*nz + sgn*kk];
+	if (sgn<0) f = std::conj(f);
+
+	f *= deconv[0][ix] * deconv[1][iy] * deconv[2][iz];
+
+	double norm = 1.0/sqrt(M_PI*(ii*ii + jj*jj + kk*kk));
+
+	expcoef[0](ix, iy, iz) += -f*norm;
+      }
+    }
+  }
+}
+
+void Cube::nufft_fields()
+{
+  int nz    = ngrid[2]/2 + 1;
+  int nreal = work.size();
+
+  // Field multiplier for wave number (ii, jj, kk): the potential and
+  // the three components of -grad
+  //
+  auto mult = [&](int c, int ii, int jj, int kk) -> std::complex<double>
+  {
+    if (ii==0 and jj==0 and kk==0) return 0.0;
+    if (abs(ii)<nminx or abs(jj)<nminy or abs(kk)<nminz) return 0.0;
+
+    double norm = 1.0/sqrt(M_PI*(ii*ii + jj*jj + kk*kk));
+
+    switch (c) {
+    case 1:  return std::complex<double>(0.0, -dfac*ii)*norm;
+    case 2:  return std::complex<double>(0.0, -dfac*jj)*norm;
+    case 3:  return std::complex<double>(0.0, -dfac*kk)*norm;
+    default: return norm;
+    }
+  };
+
+  for (int c=0; c<4; c++) {
+
+    std::fill(spectrum.begin(), spectrum.end(), 0.0);
+
+    // Only the real part of the sum over wave numbers is used, so the
+    // spectrum is symmetrized before the real transform
+    //
+    for (int ix=0; ix<imx; ix++) {
+      int ii = ix - nmaxx;
+      for (int iy=0; iy<imy; iy++) {
+	int jj = iy - nmaxy;
+	for (int kk=0; kk<=nmaxz; kk++) {
+	  int iz = kk + nmaxz;
+
+	  auto a = mult(c,  ii,  jj,  kk) * expcoef[0](ix, iy, iz);
+	  auto b = mult(c, -ii, -jj, -kk) *
+	    expcoef[0](imx-1-ix, imy-1-iy, imz-1-iz);
+
+	  int jx = (ii + ngrid[0]) % ngrid[0];
+	  int jy = (jj + ngrid[1]) % ngrid[1];
+
+	  spectrum[(jx*ngrid[1] + jy)*nz + kk] =
+	    0.5*(a + std::conj(b)) *
+	    deconv[0][ix] * deconv[1][iy] * deconv[2][iz];
+	}
+      }
+    }
+
+    fftw_execute_dft_c2r(planC2R,
+			 reinterpret_cast<fftw_complex*>(spectrum.data()),
+			 work.data());
+
+    for (int j=0; j<nreal; j++) fields[4*j+c] = work[j];
+  }
+}
+
+void Cube::nufft_interpolate(double x, double y, double z,
+			     double& pot, double* acc)
+{
+  const int ns = 2*nspread;
+  double wx[32], wy[32], wz[32];
+  int    ix[32], iy[32], iz[32];
+
+  nufft_weights(x, 0, wx, ix);
+  nufft_weights(y, 1, wy, iy);
+  nufft_weights(z, 2, wz, iz);
+
+  double sum[4] = {0.0, 0.0, 0.0, 0.0};
+
+  for (int a=0; a<ns; a++) {
+    for (int b=0; b<ns; b++) {
+      double wab = wx[a]*wy[b];
+      const double* row = &fields[4*(ix[a]*ngrid[1] + iy[b])*ngrid[2]];
+      for (int c=0; c<ns; c++) {
+	const double* f = row + 4*iz[c];
+	double w = wab*wz[c];
+	sum[0] += w*f[0];
+	sum[1] += w*f[1];
+	sum[2] += w*f[2];
+	sum[3] += w*f[3];
+      }
+    }
+  }
+
+  pot = sum[0];
+  for (int k=0; k<3; k++) acc[k] = sum[k+1];
+}
@@ -223,11 +223,23 @@ void CylEXP::compute_multistep_coefficients(unsigned mlevel)
 		<< std::endl << std::right;
     }
 
-    for (int mm=0; mm<=MMAX; mm++) {
-      for (int nn=0; nn<rank3; nn++) {
-	accum_cos[mm][nn] += a*cosL(M)[0][mm][nn] + b*cosN(M)[0][mm][nn];
-	if (mm)
-	  accum_sin[mm][nn] += a*sinL(M)[0][mm][nn] + b*sinN(M)[0][mm][nn];
+    if (msinterp) {
+      auto C = msinterp->combine(M, b,
+				 flatten(cosL, sinL, M),
+				 flatten(cosN, sinN, M));
+      for (int mm=0, k=0; mm<=MMAX; mm++) {
+	for (int nn=0; nn<rank3; nn++) accum_cos[mm][nn] += C[k++];
+      }
+      for (int mm=1, k=(MMAX+1)*rank3; mm<=MMAX; mm++) {
+	for (int nn=0; nn<rank3; nn++) accum_sin[mm][nn] += C[k++];
+      }
+    } else {
+      for (int mm=0; mm<=MMAX; mm++) {
+	for (int nn=0; nn<rank3; nn++) {
+	  accum_cos[mm][nn] += a*cosL(M)[0][mm][nn] + b*cosN(M)[0][mm][nn];
+	  if (mm)
+	    accum_sin[mm][nn] += a*sinL(M)[0][mm][nn] + b*sinN(M)[0][mm][nn];
+	}
       }
     }
 
@@ -279,6 +291,32 @@ void CylEXP::compute_multistep_coefficients(unsigned mlevel)
   }
 
   coefs_made = vector<short>(multistep+1, true);
+
+  if (msinterp) msinterp->report(tnow, mstep, mdrft);
+}
+
+
+Eigen::VectorXd CylEXP::flatten(MstepArray& C, MstepArray& S, unsigned M)
+{
+  Eigen::VectorXd ret((2*MMAX+1)*rank3);
+
+  for (int mm=0, k=0; mm<=MMAX; mm++) {
+    for (int nn=0; nn<rank3; nn++) ret[k++] = C(M)[0][mm][nn];
+  }
+  for (int mm=1, k=(MMAX+1)*rank3; mm<=MMAX; mm++) {
+    for (int nn=0; nn<rank3; nn++) ret[k++] = S(M)[0][mm][nn];
+  }
+
+  return ret;
+}
+
+
+void CylEXP::multistep_save(unsigned mlevel)
+{
+  // Nothing to save before the first accumulation setup
+  //
+  if (msinterp and cosL.size())
+    msinterp->push(mlevel, flatten(cosL, sinL, mlevel), tnow);
 }
 
 
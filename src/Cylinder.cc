@@ -10,6 +10,7 @@
 #include <CylEXP.H>
 #include <Cylinder.H>
 #include <MixtureBasis.H>
+#include <AsyncWriter.H>
 #include <Timer.H>
 #include <exputils.H>
 #include <NVTX.H>
@@ -106,7 +107,13 @@ Cylinder::valid_keys = {
   "self_consistent",
   "playback",
   "coefCompute",
-  "coefMaster"
+  "coefMaster",
+  "interleave",
+  "shared_tables",
+  "h5chunked",
+  "h5compress",
+  "mstep_order",
+  "mstep_diag"
 };
 
 Cylinder::Cylinder(Component* c0, const YAML::Node& conf, MixtureBasis *m) :
@@ -164,6 +171,12 @@ Cylinder::Cylinder(Component* c0, const YAML::Node& conf, MixtureBasis *m) :
   cmapR           = 1;
   cmapZ           = 1;
   logarithmic     = false;
+  interleave      = false;
+  shared_tables   = false;
+  mstep_order     = 1;
+  mstep_diag      = false;
+  h5chunked       = false;
+  h5compress      = 0;
   pcavar          = false;
   pcavtk          = false;
   pcadiag         = false;
@@ -200,6 +213,8 @@ Cylinder::Cylinder(Component* c0, const YAML::Node& conf, MixtureBasis *m) :
   EmpCylSL::CMAPR       = cmapR;
   EmpCylSL::CMAPZ       = cmapZ;
   EmpCylSL::logarithmic = logarithmic;
+  EmpCylSL::interleave  = interleave;
+  EmpCylSL::shared_tables = shared_tables;
   EmpCylSL::VFLAG       = vflag;
 
   if (cachename.size()==0)
@@ -213,6 +228,15 @@ Cylinder::Cylinder(Component* c0, const YAML::Node& conf, MixtureBasis *m) :
   // Set azimuthal harmonic order restriction?
   //
   if (mlim>=0)  ortho->set_mlim(mlim);
+
+  // Higher-order interpolation of the inactive levels
+  //
+  if (multistep and mstep_order>1) {
+    std::string diagfile;
+    if (mstep_diag) diagfile = outdir + runtag + ".mstep_diag." + component->name;
+    ortho->msinterp = std::make_shared<MultistepInterp>(mstep_order, multistep+1,
+							diagfile);
+  }
   if (EVEN_M)   ortho->setEven(EVEN_M);
   ortho->setSampT(defSampT);
 
@@ -384,6 +408,11 @@ Cylinder::Cylinder(Component* c0, const YAML::Node& conf, MixtureBasis *m) :
   pos.resize(nthrds);
   frc.resize(nthrds);
 
+  // Attributes for HDF5 coefficient output
+  //
+  cylCoefs.setName(component->name);
+  cylCoefs.setH5Chunked(h5chunked, h5compress);
+
 #ifdef DEBUG
   offgrid.resize(nthrds);
 #endif
@@ -438,6 +467,10 @@ void Cylinder::initialize()
     if (conf["expcond"   ])    precond  = conf["expcond"   ].as<bool>();
     if (conf["precond"   ])    precond  = conf["precond"   ].as<bool>();
     if (conf["logr"      ]) logarithmic = conf["logr"      ].as<bool>();
+    if (conf["interleave"])  interleave = conf["interleave"].as<bool>();
+    if (conf["shared_tables"]) shared_tables = conf["shared_tables"].as<bool>();
+    if (conf["mstep_order"]) mstep_order = conf["mstep_order"].as<int>();
+    if (conf["mstep_diag" ])  mstep_diag = conf["mstep_diag" ].as<bool>();
     if (conf["pcavar"    ])     pcavar  = conf["pcavar"    ].as<bool>();
     if (conf["pcaeof"    ])     pcaeof  = conf["pcaeof"    ].as<bool>();
     if (conf["pcavtk"    ])     pcavtk  = conf["pcavtk"    ].as<bool>();
@@ -449,6 +482,8 @@ void Cylinder::initialize()
     if (conf["cmapr"     ])      cmapR  = conf["cmapr"     ].as<int>();
     if (conf["cmapz"     ])      cmapZ  = conf["cmapz"     ].as<int>();
     if (conf["vflag"     ])      vflag  = conf["vflag"     ].as<int>();
+    if (conf["h5chunked" ])  h5chunked  = conf["h5chunked" ].as<bool>();
+    if (conf["h5compress"]) h5compress  = conf["h5compress"].as<int>();
     
     // Deprecation warning
     if (conf["expcond"]) {
@@ -932,6 +967,7 @@ void Cylinder::determine_coefficients_particles(void)
       compute = false;
   }
 
+  ortho->multistep_save(mlevel);
   ortho->setup_accumulation(mlevel);
 
   cylmass0.resize(nthrds);
@@ -1135,9 +1171,17 @@ void Cylinder::determine_coefficients_eof(void)
   if (myid==0) cerr << "Cylinder: eof grid mass=" << cylmassT0 
 		    << ", number=" << use0 << "\n";
 
+  // make_eof() writes the HDF5 cache from the root process, so the
+  // coefficient writer thread must be idle
+  //
+  AsyncWriter::flushAll();
+
   ortho->make_eof();
   if (myid==0) cerr << "Cylinder: eof computed\n";
 
+				// Earlier coefficients are in the old basis
+  if (ortho->msinterp) ortho->msinterp->reset();
+
   ortho->make_coefficients();
   if (myid==0) cerr << "Cylinder: coefs computed\n";
 
@@ -1161,22 +1205,6 @@ void check_force_values(double phi, double p, double fr, double fz, double fp)
 
 void * Cylinder::determine_acceleration_and_potential_thread(void * arg)
 {
-  double r, r2, r3, phi;
-  double xx, yy, zz;
-  double p, p0, fr, fz, fp, pa;
-
-  constexpr double ratmin = 0.75;
-  constexpr double maxerf = 3.0;
-  constexpr double midpt  = ratmin + 0.5*(1.0 - ratmin);
-  constexpr double rsmth  = 0.5*(1.0 - ratmin)/maxerf;
-
-  double ratio, frac, cfrac, mfactor = 1.0;
-
-  // Get the grid actual radius from EmpCylSL
-  //
-  double R2 = ortho->get_ascale()*ortho->get_rtable();
-  R2 = R2*R2;			// Compute the square
-
   vector<double> ctr;
   if (mix) mix->getCenter(ctr);
 
@@ -1185,7 +1213,6 @@ void * Cylinder::determine_acceleration_and_potential_thread(void * arg)
 #ifdef DEBUG
   static bool firstime = true;
   std::ofstream out;
-  int flg;
   if (firstime && myid==0 && id==0) out.open("debug.tst");
 #endif
 
@@ -1223,124 +1250,185 @@ void * Cylinder::determine_acceleration_and_potential_thread(void * arg)
       }
       */
 
-      if (mix) {
+      accel_particle(indx, id, ctr);
+
+#ifdef DEBUG
+      if (firstime && myid==0 && id==0 && q < 5) {
+	out << setw(9)  << q          << endl
+	    << setw(9)  << indx       << endl
+	    << setw(18) << pos[0][0]  << endl
+	    << setw(18) << pos[0][1]  << endl
+	    << setw(18) << pos[0][2]  << endl
+	    << setw(18) << frc[0][0]  << endl
+	    << setw(18) << frc[0][1]  << endl
+	    << setw(18) << frc[0][2]  << endl;
+      }
+#endif
+    }
+  }
 
-	if (use_external) {
-	  cC->Pos(pos[id].data(), indx, Component::Inertial);
-	  component->ConvertPos(pos[id].data(), Component::Local);
-	} else
-	  cC->Pos(pos[id].data(), indx, Component::Local);
+#ifdef DEBUG
+  firstime = false;		// DEBUG
+#endif
 
-	// Only apply this fraction of the force
-	mfactor = mix->Mixture(pos[id].data());
-	for (int k=0; k<3; k++) pos[id][k] -= ctr[k];
+  thread_timing_end(id);
 
-      } else {
+  return (NULL);
+}
 
-	if (use_external) {
-	  cC->Pos(pos[id].data(), indx, Component::Inertial);
-	  component->ConvertPos(pos[id].data(), Component::Local | Component::Centered);
-	} else
-	  cC->Pos(pos[id].data(), indx, Component::Local | Component::Centered);
 
-      }
+void Cylinder::accel_particle(unsigned indx, int id,
+			      const std::vector<double>& ctr)
+{
+  double r, r2, r3, phi;
+  double xx, yy, zz;
+  double p, p0, fr, fz, fp, pa;
+
+  constexpr double ratmin = 0.75;
+  constexpr double maxerf = 3.0;
+  constexpr double midpt  = ratmin + 0.5*(1.0 - ratmin);
+  constexpr double rsmth  = 0.5*(1.0 - ratmin)/maxerf;
+
+  double ratio, frac, cfrac, mfactor = 1.0;
+
+  // Get the grid actual radius from EmpCylSL
+  //
+  double R2 = ortho->get_ascale()*ortho->get_rtable();
+  R2 = R2*R2;			// Compute the square
+
+  if (mix) {
+
+    if (use_external) {
+      cC->Pos(pos[id].data(), indx, Component::Inertial);
+      component->ConvertPos(pos[id].data(), Component::Local);
+    } else
+      cC->Pos(pos[id].data(), indx, Component::Local);
+
+    // Only apply this fraction of the force
+    mfactor = mix->Mixture(pos[id].data());
+    for (int k=0; k<3; k++) pos[id][k] -= ctr[k];
 
-      if ( (component->EJ & Orient::AXIS) && !component->EJdryrun) 
-	pos[id] = component->orient->transformBody() * pos[id];
+  } else {
+
+    if (use_external) {
+      cC->Pos(pos[id].data(), indx, Component::Inertial);
+      component->ConvertPos(pos[id].data(), Component::Local | Component::Centered);
+    } else
+      cC->Pos(pos[id].data(), indx, Component::Local | Component::Centered);
+
+  }
 
-      xx    = pos[id][0];
-      yy    = pos[id][1];
-      zz    = pos[id][2];
+  if ( (component->EJ & Orient::AXIS) && !component->EJdryrun) 
+    pos[id] = component->orient->transformBody() * pos[id];
+
+  xx    = pos[id][0];
+  yy    = pos[id][1];
+  zz    = pos[id][2];
       
-      r2    = xx*xx + yy*yy;
-      r     = sqrt(r2) + DSMALL;
-      phi   = atan2(yy, xx);
-      pa    = 0.0;
-
-      ratio = sqrt( (r2 + zz*zz)/R2 );
-
-      if (ratio >= 1.0) {
-	frac       = 0.0;
-	cfrac      = 1.0;
-	frc[id][0] = 0.0;
-	frc[id][1] = 0.0;
-	frc[id][2] = 0.0;
-      } else if (ratio > ratmin) {
-	frac  = 0.5*(1.0 - erf( (ratio - midpt)/rsmth ));
-	cfrac = 1.0 - frac;
-      } else {
-	cfrac = 0.0;
-	frac  = 1.0;
-      }
+  r2    = xx*xx + yy*yy;
+  r     = sqrt(r2) + DSMALL;
+  phi   = atan2(yy, xx);
+  pa    = 0.0;
+
+  ratio = sqrt( (r2 + zz*zz)/R2 );
+
+  if (ratio >= 1.0) {
+    frac       = 0.0;
+    cfrac      = 1.0;
+    frc[id][0] = 0.0;
+    frc[id][1] = 0.0;
+    frc[id][2] = 0.0;
+  } else if (ratio > ratmin) {
+    frac  = 0.5*(1.0 - erf( (ratio - midpt)/rsmth ));
+    cfrac = 1.0 - frac;
+  } else {
+    cfrac = 0.0;
+    frac  = 1.0;
+  }
 	
-      cfrac *= mfactor;
-      frac  *= mfactor;
+  cfrac *= mfactor;
+  frac  *= mfactor;
 
-      if (ratio < 1.0) {
+  if (ratio < 1.0) {
 
-	ortho->accumulated_eval(r, zz, phi, p0, p, fr, fz, fp);
+    ortho->accumulated_eval(r, zz, phi, p0, p, fr, fz, fp);
 #ifdef DEBUG
-	check_force_values(phi, p, fr, fz, fp);
+    check_force_values(phi, p, fr, fz, fp);
 #endif
-	frc[id][0] = ( fr*xx/r - fp*yy/r2 ) * frac;
-	frc[id][1] = ( fr*yy/r + fp*xx/r2 ) * frac;
-	frc[id][2] = fz * frac;
-	pa         = p  * frac;
+    frc[id][0] = ( fr*xx/r - fp*yy/r2 ) * frac;
+    frc[id][1] = ( fr*yy/r + fp*xx/r2 ) * frac;
+    frc[id][2] = fz * frac;
+    pa         = p  * frac;
 	
-#ifdef DEBUG
-	flg = 1;
-#endif
-      }
+  }
 
-      if (ratio > ratmin) {
+  if (ratio > ratmin) {
 
-	r3 = r2 + zz*zz;
-	p = -cylmass/sqrt(r3);	// -M/r
-	fr = p/r3;		// -M/r^3
+    r3 = r2 + zz*zz;
+    p = -cylmass/sqrt(r3);	// -M/r
+    fr = p/r3;		// -M/r^3
 
-	frc[id][0] += xx*fr * cfrac;
-	frc[id][1] += yy*fr * cfrac;
-	frc[id][2] += zz*fr * cfrac;
-	pa         += p     * cfrac;
+    frc[id][0] += xx*fr * cfrac;
+    frc[id][1] += yy*fr * cfrac;
+    frc[id][2] += zz*fr * cfrac;
+    pa         += p     * cfrac;
 
 #ifdef DEBUG
-	offgrid[id]++;
-	flg = 2;
+    offgrid[id]++;
 #endif
-      }
+  }
     
-      cC->AddPot(indx, pa);
+  cC->AddPot(indx, pa);
+
+  if ( (component->EJ & Orient::AXIS) && !component->EJdryrun) 
+    frc[id] = component->orient->transformOrig() * frc[id];
 
-      if ( (component->EJ & Orient::AXIS) && !component->EJdryrun) 
-	frc[id] = component->orient->transformOrig() * frc[id];
+  for (int j=0; j<3; j++) cC->AddAcc(indx, j, frc[id][j]);
+}
 
-      for (int j=0; j<3; j++) cC->AddAcc(indx, j, frc[id][j]);
 
-#ifdef DEBUG
-      if (firstime && myid==0 && id==0 && q < 5) {
-	out << setw(9)  << q          << endl
-	    << setw(9)  << indx       << endl
-	    << setw(9)  << flg        << endl
-	    << setw(18) << xx         << endl
-	    << setw(18) << yy         << endl
-	    << setw(18) << zz         << endl
-	    << setw(18) << frc[0][0]  << endl
-	    << setw(18) << frc[0][1]  << endl
-	    << setw(18) << frc[0][2]  << endl;
-      }
-#endif
+void Cylinder::batch_begin(Component* C)
+{
+  cC = C;
+
+  MPL_start_timer();
+
+  if (play_back) {
+    if (play_cnew) getCoefs(P1);
+    setCoefs(P);
+  }
+
+  if (use_external == false) {
+
+    if (multistep && (self_consistent || initializing)) {
+      compute_multistep_coefficients();
     }
+
   }
 
-#ifdef DEBUG
-  firstime = false;		// DEBUG
-#endif
+  if (mix) mix->getCenter(bctr);
+}
 
-  thread_timing_end(id);
 
-  return (NULL);
+void Cylinder::batch_eval(const int* indx, int n, int id)
+{
+  for (int i=0; i<n; i++) accel_particle(indx[i], id, bctr);
 }
 
+
+void Cylinder::batch_end()
+{
+  if (play_back) {
+    getCoefs(P);
+    if (play_cnew) setCoefs(P1);
+  }
+
+  MPL_stop_timer();
+
+  use_external = false;
+}
+
+
 static int ocf = 0;
 
 void Cylinder::determine_acceleration_and_potential(void)
@@ -1552,25 +1640,14 @@ void Cylinder::dump_coefs_h5(const std::string& file)
   //
   cur->ctr = component->getCenter(Component::Local | Component::Centered);
 
-  // Check if file exists
+  // Copy the YAML config.  Only used when the file is created.
   //
-  if (std::filesystem::exists(file)) {
-    cylCoefs.clear();
-    cylCoefs.add(cur);
-    cylCoefs.ExtendH5Coefs(file);
-  } else {
-    // Copy the YAML config.  We only need this on the first call.
-    std::ostringstream sout; sout << conf;
-    cur->buf = sout.str();	// Copy to CoefStruct buffer
-
-    // Add the name attribute.  We only need this on the first call.
-    cylCoefs.setName(component->name);
+  std::ostringstream sout; sout << conf;
+  cur->buf = sout.str();	// Copy to CoefStruct buffer
 
-    // Add the new coefficients and write the new HDF5
-    cylCoefs.clear();
-    cylCoefs.add(cur);
-    cylCoefs.WriteH5Coefs(file);
-  }
+  // Create or extend the HDF5 file
+  //
+  AsyncWriter::instance().coefs(file, cylCoefs, cur);
 }
 
 				// Density debug
@@ -51,15 +51,13 @@ Direct::Direct(Component* c0, const YAML::Node& conf) : PotAccel(c0, conf)
   to_proc = (myid+1) % numprocs;
   from_proc = (myid+numprocs-1) % numprocs;
 
-				// Buffer pointers
-  tmp_buffer = NULL;
-  bod_buffer = NULL;
+				// Ring state
+  cur = 0;
+  ring_pending = false;
 }
 
 Direct::~Direct()
 {
-  delete [] tmp_buffer;
-  delete [] bod_buffer;
 }
 
 void Direct::initialize(void)
@@ -153,68 +151,104 @@ void Direct::determine_acceleration_and_potential(void)
 #endif
   
 				// Allocate buffers to handle largest list
-  delete [] tmp_buffer;
-  delete [] bod_buffer;
-
   int buffer_size = max_bodies*ndim;
-  tmp_buffer = new double [buffer_size];
-  bod_buffer = new double [buffer_size];
+  for (auto & v : ring) {
+    if (v.size() < static_cast<size_t>(buffer_size)) v.resize(buffer_size);
+  }
+  cur = 0;
   
-  // Load body buffer with local interactors
-  double *p = bod_buffer;
-  unsigned long i;
-  PartMapItr it = component->Particles().begin();
-
-  for (int q=0; q<ninteract; q++) {
-    i = (it++)->first;
-    *(p++) = component->Mass(i);
-    *(p++) = component->Pos(i, 0);
-    *(p++) = component->Pos(i, 1);
-    *(p++) = component->Pos(i, 2);
-    if (!fixed_soft) *(p++) = component->Part(i)->dattrib[soft_indx];
+  // Load body buffer with local interactors as contiguous arrays
+  double *p = ring[cur].data();
+  int q = 0;
+  for (auto & it : component->Particles()) {
+    Particle *P = it.second.get();
+    p[q              ] = P->mass;
+    p[q + ninteract*1] = P->pos[0];
+    p[q + ninteract*2] = P->pos[1];
+    p[q + ninteract*3] = P->pos[2];
+    if (!fixed_soft) p[q + ninteract*4] = P->dattrib[soft_indx];
+    q++;
   }
 
-				// Do the local interactors
-  exp_thread_fork(false);
+  // Do the ring.  The block for the next pass is sent and received
+  // while the current block is computed, so only the last pass is
+  // computed without communication in flight.
+  //
+  for (int n=0; n<numprocs; n++) {
 
-				// Do the ring . . . 
-  for (int n=1; n<numprocs; n++) {
-      
-    MPI_Request req1, req2;
-    MPI_Status stat;
-    
-				// Copy current to temp buffer
-    memcpy(tmp_buffer, bod_buffer, buffer_size*sizeof(double));
+    int nxt = 1 - cur;
 
+    if (n<numprocs-1) {
 				// Get NEW buffer from right
-    MPI_Irecv(bod_buffer, buffer_size, MPI_DOUBLE, from_proc, MSGTAG, 
-	      MPI_COMM_WORLD, &req1);
+      MPI_Irecv(ring[nxt].data(), buffer_size, MPI_DOUBLE, from_proc, MSGTAG, 
+		MPI_COMM_WORLD, &ring_req[0]);
 
-				// Send OLD buffer to left
-    MPI_Isend(tmp_buffer, ninteract*ndim, MPI_DOUBLE, to_proc, MSGTAG, 
-	      MPI_COMM_WORLD, &req2);
+				// Send CURRENT buffer to left.  The
+				// interaction loop only reads it.
+      MPI_Isend(ring[cur].data(), ninteract*ndim, MPI_DOUBLE, to_proc, MSGTAG, 
+		MPI_COMM_WORLD, &ring_req[1]);
 
-    MPI_Wait(&req2, &stat);
-    MPI_Wait(&req1, &stat);
+      ring_pending = true;
+    }
 
-				// How many particles did we get?
-    MPI_Get_count(&stat, MPI_DOUBLE, &ninteract);
-    ninteract /= ndim;
-	
 				// Accumulate the interactions
     exp_thread_fork(false);
 
+    if (n<numprocs-1) {
+      if (ring_pending) MPI_Waitall(2, ring_req, ring_stat);
+      ring_pending = false;
+
+				// How many particles did we get?
+      MPI_Get_count(&ring_stat[0], MPI_DOUBLE, &ninteract);
+      ninteract /= ndim;
+
+      cur = nxt;
+    }
   }
 				// Clear external potential flag
   use_external = false;
 }
 
-void * Direct::determine_acceleration_and_potential_thread(void * arg)
+void Direct::ring_progress()
 {
-  double pos[3], eps = soft;
+  // Many MPI implementations only advance a large nonblocking
+  // transfer from inside an MPI call
+  //
+  if (ring_pending) {
+    int flag;
+    MPI_Testall(2, ring_req, &flag, ring_stat);
+    if (flag) ring_pending = false;
+  }
+}
 
+void * Direct::determine_acceleration_and_potential_thread(void * arg)
+{
   int id = *((int*)arg);
 
+  // Source arrays in the current ring buffer
+  //
+  const int nsrc    = ninteract;
+  const double *ms  = ring[cur].data();
+  const double *xs  = ms + nsrc;
+  const double *ys  = xs + nsrc;
+  const double *zs  = ys + nsrc;
+  const double *es  = fixed_soft ? nullptr : zs + nsrc;
+
+  // Per-tile work arrays
+  //
+  double dx[tile], dy[tile], dz[tile], rr[tile], ee[tile], ww[tile];
+  double mf[tile], pt[tile];
+
+  if (fixed_soft) std::fill(ee, ee+tile, soft);
+
+  double pmMax = 0.0, pmRad = 0.0;
+  if (pm_model) {
+    pmRad = pmmodel->get_max_radius();
+    pmMax = pmmodel->get_mass(pmRad);
+  }
+
+  double adb = component->Adiabatic();
+
 #ifdef DEBUG
   double tclausius[nthrds];
   for (int i=0; i<nthrds; i++) tclausius[id] = 0.0;
@@ -229,8 +263,6 @@ void * Direct::determine_acceleration_and_potential_thread(void * arg)
     int nbeg = nbodies*id/nthrds;
     int nend = nbodies*(id+1)/nthrds;
 
-    double adb = component->Adiabatic();
-
     for (int i=nbeg; i<nend; i++) {
     
 				// Index of the current local particle
@@ -238,109 +270,99 @@ void * Direct::determine_acceleration_and_potential_thread(void * arg)
 
 				// Don't need acceleration for frozen particles
       if (cC->freeze(j)) continue;
+
+				// Keep the ring transfer moving
+      if (id==0) ring_progress();
     
-				// Loop through the particle list
-      double * p = bod_buffer;
-      for (int n=0; n<ninteract; n++) {
-
-				// Get current interaction particle
-				// mass from ring buffer
-	double mass = *(p++) * adb;
-				// Position
-	for (int k=0; k<3; k++) pos[k] = *(p++);
-	
-	// Compute interparticle squared distance
-	//
-	double rr0 = 0.0;
-	for (int k=0; k<3; k++) rr0 +=
-				  (cC->Pos(j, k) - pos[k]) *
-				  (cC->Pos(j, k) - pos[k]) ;
-	double rr = sqrt(rr0);
-	
-	// Reject particle at current location
+      Particle *P = cC->Part(j);
+      const double x0 = P->pos[0], y0 = P->pos[1], z0 = P->pos[2];
+
+      double ax = 0.0, ay = 0.0, az = 0.0, pot = 0.0;
+
+				// Loop through the sources by tile
+      for (int t0=0; t0<nsrc; t0+=tile) {
+
+	const int nt = std::min<int>(tile, nsrc - t0);
+
+	// Separations.  Sources at the current location get zero
+	// weight and unit separation so that the kernels need not
+	// branch.
 	//
-	if (rr>rtol) {
-	  
-	  // BEG: Miyamoto-Nagai (MN) disk-shaped point mass
-	  if (mn_model) {	
-
-	    // Positions relative to point mass center
-	    //
-	    double xx = cC->Pos(j, 0) - pos[0];
-	    double yy = cC->Pos(j, 1) - pos[1];
-	    double zz = cC->Pos(j, 2) - pos[2];
-
-	    // MN intermediate computation
-	    //
-	    double rr = sqrt( xx*xx + yy*yy );
-	    double zb = sqrt( zz*zz + b * b );
-	    double ab = a + zb;
-	    double dn = sqrt( rr*rr + ab*ab );
-	    
-	    // MN potential and cylindrical force
-	    //
-	    double pot = -mass/dn;
-	    double fr  = -mass*rr/(dn*dn*dn);
-	    double fz  = -mass*zz*ab/(zb*dn*dn*dn);
-	  
-	    // Add acceleration by disk particle
-	    //
-	    cC->AddAcc(j, 0, fr*xx/(rr+1.0e-10) );
-	    cC->AddAcc(j, 1, fr*yy/(rr+1.0e-10) );
-	    cC->AddAcc(j, 2, fz );
-	  
-#ifdef DEBUG
-	    if (use_external) {
-	      ncnt++;
-	      tclausius[id] += mass * ( (fr*xx + fr*yy)/(rr+1.0e-10) + fz);
-	    }
-#endif
-	    // Particle potential
-	    cC->AddPot(j, pot );
+#pragma omp simd
+	for (int k=0; k<nt; k++) {
+	  dx[k] = x0 - xs[t0+k];
+	  dy[k] = y0 - ys[t0+k];
+	  dz[k] = z0 - zs[t0+k];
+	  double r = std::sqrt(dx[k]*dx[k] + dy[k]*dy[k] + dz[k]*dz[k]);
+	  bool ok = r > rtol;
+	  ww[k] = ok ? ms[t0+k]*adb : 0.0;
+	  rr[k] = ok ? r : 1.0;
+	}
+
+	// BEG: Miyamoto-Nagai (MN) disk-shaped point mass
+	if (mn_model) {
 
+	  const double b2 = b*b;
+
+#pragma omp simd reduction(+:ax,ay,az,pot)
+	  for (int k=0; k<nt; k++) {
+	    double R  = std::sqrt(dx[k]*dx[k] + dy[k]*dy[k]);
+	    double zb = std::sqrt(dz[k]*dz[k] + b2);
+	    double ab = a + zb;
+	    double dn = std::sqrt(R*R + ab*ab);
+	    double d3 = 1.0/(dn*dn*dn);
+	    double fr = -ww[k]*R*d3;
+	    double fz = -ww[k]*dz[k]*ab*d3/zb;
+	    ax  += fr*dx[k]/(R+1.0e-10);
+	    ay  += fr*dy[k]/(R+1.0e-10);
+	    az  += fz;
+	    pot += -ww[k]/dn;
 	  }
-	  // END: Miyamoto-Nagai point mass
-	  // BEG: Spherical point mass
-	  else {
-	  
-	    if (!fixed_soft) eps = *(p++);
+
+	}
+	// END: Miyamoto-Nagai point mass
+	// BEG: Spherical point mass
+	else {
+
+	  if (!fixed_soft) std::copy(es+t0, es+t0+nt, ee);
+
+	  kernel->eval(nt, rr, ee, mf, pt);
 
 				// Extended model for point masses
                                 // Given model provides normalized mass distrbution
-	    double pot = 0.0;
-	  
-	    if (pm_model && pmmodel->get_max_radius() > rr) {
-	      double mass_frac =
-		pmmodel->get_mass(rr) / pmmodel->get_mass(pmmodel->get_max_radius());
-	      pot = pmmodel->get_pot(rr)/pmmodel->get_mass(pmmodel->get_max_radius());
-	      mass *= mass_frac;
-	    } else {
-	      auto y = (*kernel)(rr, eps);
-	      pot = mass * y.second;
-	      mass *= y.first;
+	  if (pm_model) {
+	    for (int k=0; k<nt; k++) {
+	      if (pmRad > rr[k] and ww[k] > 0.0) {
+		mf[k] = pmmodel->get_mass(rr[k]) / pmMax;
+		pt[k] = pmmodel->get_pot(rr[k]) / (pmMax * ww[k]);
+	      }
 	    }
-	    
-	    // Acceleration
-	    double rfac = 1.0/(rr*rr*rr);
-	    
-	    for (int k=0; k<3; k++)
-	      cC->AddAcc(j, k, -mass *(cC->Pos(j, k) - pos[k]) * rfac );
-	    
-	    // Potential
-#ifdef DEBUG
-	    if (use_external) {
-	      ncnt++;
-	      for (int k=0; k<3; k++)
-		tclausius[id] += -mass *
-		  (cC->Pos(j, k) - pos[k]) * cC->Pos(j, k) * rfac;
-	    }
-#endif
-	    cC->AddPot(j, pot );
+	  }
+
+#pragma omp simd reduction(+:ax,ay,az,pot)
+	  for (int k=0; k<nt; k++) {
+	    double rfac = ww[k]*mf[k]/(rr[k]*rr[k]*rr[k]);
+	    ax  += -dx[k]*rfac;
+	    ay  += -dy[k]*rfac;
+	    az  += -dz[k]*rfac;
+	    pot += ww[k]*pt[k];
 	  }
 	}
 	// END: spherical point mass
       }
-      // END: buffer interaction loop
+      // END: source tile loop
+
+      P->acc[0] += ax;
+      P->acc[1] += ay;
+      P->acc[2] += az;
+      P->pot    += pot;
+
+#ifdef DEBUG
+      if (use_external) {
+	ncnt += nsrc;
+	tclausius[id] += ax*x0 + ay*y0 + az*z0;
+      }
+#endif
     }
     // END: local particle loop
   }
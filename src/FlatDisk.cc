@@ -21,6 +21,7 @@ FlatDisk::valid_keys = {
   "model",
   "biorth",
   "diskconf",
+  "shared_tables",
   "cachename"
 };
 
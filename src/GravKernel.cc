@@ -29,3 +29,51 @@ std::pair<double, double> SplineSoft::operator()(double r, double eps)
 
   return ret;
 }
+
+void SoftKernel::eval(int n, const double* r, const double* eps,
+		      double* mfrac, double* pot)
+{
+  for (int i=0; i<n; i++) {
+    auto ret = (*this)(r[i], eps[i]);
+    mfrac[i] = ret.first;
+    pot[i]   = ret.second;
+  }
+}
+
+// The Plummer potential is -1/sqrt(r^2 + eps^2) and the enclosed mass
+// fraction is (r^2/(r^2 + eps^2))^{3/2}, so one inverse square root
+// gives both
+//
+void PlummerSoft::eval(int n, const double* r, const double* eps,
+		       double* mfrac, double* pot)
+{
+#pragma omp simd
+  for (int i=0; i<n; i++) {
+    double r2 = r[i]*r[i];
+    double s  = 1.0/std::sqrt(r2 + eps[i]*eps[i]);
+    pot[i]    = -s;
+    mfrac[i]  = r2*r[i]*s*s*s;
+  }
+}
+
+// All three regions are evaluated and the result selected so that the
+// loop has no branches
+//
+void SplineSoft::eval(int n, const double* r, const double* eps,
+		      double* mfrac, double* pot)
+{
+#pragma omp simd
+  for (int i=0; i<n; i++) {
+    double x  = r[i]/eps[i];
+    double ir = 1.0/r[i];
+    double ie = 1.0/eps[i];
+
+    double mi = m1(x);
+    double pi = -(fac1 - p1(x))*ie - (x>tol ? mi*ir : 0.0);
+    double mm = fac0 + m2(x);
+    double pm = -mm*ir - (fac2 - p2(x))*ie;
+
+    mfrac[i] = x<0.5 ? mi : (x<1.0 ? mm : 1.0);
+    pot[i]   = x<0.5 ? pi : (x<1.0 ? pm : -ir);
+  }
+}
@@ -0,0 +1,135 @@
+#include <stdexcept>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <cmath>
+
+#include <MultistepInterp.H>
+
+#include <localmpi.H>
+
+MultistepInterp::MultistepInterp(int order, unsigned levels,
+				 const std::string& diagfile) :
+  order(order), diagfile(diagfile)
+{
+  if (order<1 or order>3)
+    throw std::runtime_error("MultistepInterp: order must be 1, 2 or 3");
+
+  hist.resize(levels);
+  times.resize(levels);
+
+  reset();
+}
+
+void MultistepInterp::reset()
+{
+  for (auto & H : hist) for (auto & v : H) v.resize(0);
+
+  // NaN times are never equally spaced so the linear interpolant is
+  // used until the level has been evaluated often enough
+  //
+  const double nan = std::numeric_limits<double>::quiet_NaN();
+  for (auto & T : times) T = {nan, nan, nan, nan};
+
+  dnorm = lnorm = 0.0;
+}
+
+void MultistepInterp::push(unsigned M, const Eigen::VectorXd& L, double t)
+{
+  auto & T = times[M];
+  T[3] = T[2];
+  T[2] = T[1];
+  T[1] = T[0];
+  T[0] = t;
+
+  if (order>2) hist[M][1] = std::move(hist[M][0]);
+  if (order>1) hist[M][0] = L;
+}
+
+int MultistepInterp::history(unsigned M) const
+{
+  const auto & T = times[M];
+
+  double h = T[0] - T[1];
+  if (not (h > 0.0)) return 0;
+
+  const double tol = 1.0e-8*h;
+
+  int k = 0;
+  for (int j=1; j<order; j++) {
+    if (std::fabs(T[j] - T[j+1] - h) > tol) break;
+    k++;
+  }
+
+  // NaN differences fail the test above
+  //
+  if (k>0 and hist[M][0].size() != 0) return k;
+  return 0;
+}
+
+Eigen::VectorXd MultistepInterp::combine(unsigned M, double s,
+					 const Eigen::VectorXd& L,
+					 const Eigen::VectorXd& N)
+{
+  int k = order>1 ? history(M) : 0;
+
+  if (k==0) return (1.0 - s)*L + s*N;
+
+  // Lagrange weights on the nodes -k, ..., 0, 1 where L is at 0 and N
+  // at 1
+  //
+  Eigen::VectorXd ret;
+  const auto & H = hist[M];
+
+  if (k==1) {
+    ret =
+      0.5*s*(s - 1.0)*H[0] + (1.0 - s*s)*L + 0.5*s*(s + 1.0)*N;
+  } else {
+    ret =
+      - s*(s*s - 1.0)/6.0             * H[1]
+      + 0.5*s*(s - 1.0)*(s + 2.0)     * H[0]
+      - 0.5*(s*s - 1.0)*(s + 2.0)     * L
+      + s*(s + 1.0)*(s + 2.0)/6.0     * N;
+  }
+
+  if (diagfile.size()) {
+    Eigen::VectorXd lin = (1.0 - s)*L + s*N;
+    dnorm += (ret - lin).squaredNorm();
+    lnorm += lin.squaredNorm();
+  }
+
+  return ret;
+}
+
+Eigen::VectorXd MultistepInterp::flatten(const std::vector<VectorP>& v)
+{
+  const int n = v.size() ? v[0]->size() : 0;
+
+  Eigen::VectorXd ret(v.size()*n);
+  for (size_t j=0; j<v.size(); j++) ret.segment(j*n, n) = *v[j];
+
+  return ret;
+}
+
+void MultistepInterp::addTo(const Eigen::VectorXd& c, std::vector<VectorP>& v)
+{
+  const int n = v.size() ? v[0]->size() : 0;
+
+  for (size_t j=0; j<v.size(); j++) *v[j] += c.segment(j*n, n);
+}
+
+void MultistepInterp::report(double time, int mstep, int mdrft)
+{
+  if (diagfile.size() and myid==0 and lnorm>0.0) {
+    std::ofstream out(diagfile, std::ios::app);
+    if (out) {
+      out << std::setw(18) << time
+	  << std::setw(8)  << mstep
+	  << std::setw(8)  << mdrft
+	  << std::setw(18) << std::sqrt(dnorm/lnorm)
+	  << std::endl;
+    }
+  }
+
+  dnorm = lnorm = 0.0;
+}
@@ -13,6 +13,7 @@
 #endif
 
 #include <Orient.H>
+#include <ParallelQuantile.H>
 
 
 void EL3::debug() const 
@@ -419,39 +420,14 @@ void Orient::accumulate(double time, Component *c)
 
   comp->timer_orient.stop();
 
-  unsigned tkeep = many/numprocs;
-
+  // Find the energy of rank <many> over all processes without
+  // collecting the energies on the root node
+  //
   std::vector<double> ee;
   for (auto it = angm.begin(); it != angm.end(); it++) ee.push_back(it->E);
   
-  for (int n=1; n<numprocs; n++) {
-    if (n==myid) {
-      unsigned nsiz = ee.size();
-      // Size trim approximation; 3x the target size
-      nsiz = std::min<unsigned>(nsiz, 3.0*tkeep);
-      // Send to root node for sorting
-      MPI_Send(&nsiz,     1, MPI_UNSIGNED, 0, 331, MPI_COMM_WORLD);
-      MPI_Send(&ee[0], nsiz, MPI_DOUBLE,   0, 332, MPI_COMM_WORLD);
-    }
-    if (0==myid) {
-      unsigned nsiz;
-      MPI_Recv(&nsiz, 1, MPI_UNSIGNED, n, 331, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
-      std::vector<double> tt(nsiz);
-      MPI_Recv(&tt[0], nsiz, MPI_DOUBLE, n, 332, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
-      ee.insert(ee.end(), tt.begin(), tt.end());
-    }
-  }
-
-  if (myid==0) {
-    std::sort(ee.begin(), ee.end());
-    if (ee.size()<=many) Ecurr = ee.back();
-    else                 Ecurr = *(ee.begin()+many);
-  }
-
-  // Propagate minimum energy and current cached low energy particles
-  // within nodes
-
-  MPI_Bcast(&Ecurr, 1, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+  if (ParallelQuantile::total(ee) > 0)
+    Ecurr = ParallelQuantile::select(ee, many);
 
 				// Compute values for this step
   axis1  .setZero();
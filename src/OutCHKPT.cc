@@ -12,6 +12,7 @@
 
 #include <AxisymmetricBasis.H>
 #include <OutCHKPT.H>
+#include <AsyncWriter.H>
 
 const std::set<std::string>
 OutCHKPT::valid_keys = {
@@ -97,6 +98,10 @@ void OutCHKPT::Run(int n, int mstep, bool last)
     if (multistep>1 and mstep % nintsub !=0) return;
   }
 
+  // Make the coefficient and log files consistent with the checkpoint
+  //
+  AsyncWriter::flushAll();
+
   int returnStatus = 1;
 
   if (myid==0) {
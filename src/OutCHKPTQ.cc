@@ -12,6 +12,7 @@
 
 #include <AxisymmetricBasis.H>
 #include <OutCHKPTQ.H>
+#include <AsyncWriter.H>
 
 
 const std::set<std::string>
@@ -89,7 +90,11 @@ void OutCHKPTQ::Run(int n, int mstep, bool last)
     if (n % nint) return;
     if (multistep>1 and mstep % nintsub !=0) return;
   }
-  
+
+  // Make the coefficient and log files consistent with the checkpoint
+  //
+  AsyncWriter::flushAll();
+
   int returnStatus = 1;
   
   if (myid==0) {
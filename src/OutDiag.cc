@@ -7,6 +7,7 @@
 
 #include <AxisymmetricBasis.H>
 #include <OutDiag.H>
+#include <AsyncWriter.H>
 
 const std::set<std::string>
 OutDiag::valid_keys = {
@@ -137,8 +138,7 @@ void OutDiag::Run(int n, int mstep, bool last)
     
   ostringstream outs;
   outs << outdir << filename.c_str() << "." << n;
-  ofstream out(outs.str().c_str());
-  if (!out) return;
+  ostringstream out;
 
   out.setf(ios::scientific);
   out.precision(6);
@@ -167,5 +167,6 @@ void OutDiag::Run(int n, int mstep, bool last)
     out << endl;
   }
 
+  AsyncWriter::instance().text(outs.str(), out.str(), false);
 }
 
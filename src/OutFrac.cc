@@ -8,6 +8,7 @@
 #include <expand.H>
 #include <Timer.H>
 #include <OutFrac.H>
+#include <ParallelQuantile.H>
 
 
 const double default_quant[] = {0.001, 0.003, 0.01, 0.03, 0.1, 0.2, 0.4, 0.5, 0.6, 0.8, 0.9, 0.97, 0.99, 0.993, 0.999};
@@ -18,7 +19,8 @@ OutFrac::valid_keys = {
   "nint",
   "nintsub",
   "name",
-  "frac"
+  "frac",
+  "streaming"
 };
 
 OutFrac::OutFrac(const YAML::Node& conf) : Output(conf)
@@ -170,8 +172,13 @@ void OutFrac::initialize()
     }
 
     // Get quantiles
-    if (Output::conf["frac"])
+    if (Output::conf["frac"]) {
       Quant = Output::conf["frac"].as<std::vector<double>>();
+      numQuant = Quant.size();
+    }
+
+    if (Output::conf["streaming"])
+      streaming = Output::conf["streaming"].as<bool>();
   }
   catch (YAML::Exception & error) {
     if (myid==0) std::cout << "Error parsing parameters in OutFrac: "
@@ -194,8 +201,6 @@ void OutFrac::Run(int n, int mstep, bool last)
 
   prev = tnow;
 
-  MPI_Status status;
-
   Timer timer;
 
   if (myid==0) timer.start();
@@ -233,54 +238,34 @@ void OutFrac::Run(int n, int mstep, bool last)
     rad[n] = sqrt(r);
   }
 
-				// Send arrays to master
-  int nbodies = tcomp->Number();
-  int max_nbodies, cur_bodies;
-  MPI_Reduce(&nbodies, &max_nbodies,
-	     1, MPI_INT, MPI_MAX, 0, MPI_COMM_WORLD);
+				// Quantiles over all processes
+  std::vector<double> rquant;
+  uint64_t ntot = ParallelQuantile::total(rad);
+  if (ntot==0) return;
 
-  vector<double> rtot;
-  if (myid==0) {
-    rtot = rad;
-    rad = vector<double>(max_nbodies);
-  }
+  if (streaming) {
+    rquant = ParallelQuantile::streaming(rad, Quant);
+  } else {
+				// Get the index (nearest integer)
+    std::vector<uint64_t> indx(numQuant);
+    for (int i=0; i<numQuant; i++)
+      indx[i] = std::min<uint64_t>(static_cast<uint64_t>(Quant[i]*ntot + 0.5), ntot-1);
 
-  for (int n=1; n<numprocs; n++) {
-    if (myid==n) {
-      MPI_Send(&nbodies, 1, MPI_INT, 0, 153, MPI_COMM_WORLD);
-      MPI_Send(&rad[0], nbodies, MPI_DOUBLE, 0, 154, MPI_COMM_WORLD);
-    }
-    if (myid==0) {
-      MPI_Recv(&cur_bodies, 1, MPI_INT, n, 153, MPI_COMM_WORLD, &status);
-      MPI_Recv(&rad[0], cur_bodies, MPI_DOUBLE, n, 154, MPI_COMM_WORLD, &status);
-      rtot.insert(rtot.end(), rad.begin(), rad.begin()+cur_bodies);
-    }
-    MPI_Barrier(MPI_COMM_WORLD);
+    rquant = ParallelQuantile::select(rad, indx);
   }
 
   if (myid==0) {
 
-    if (tcomp->CurTotal() != rtot.size()) {
+    if (tcomp->CurTotal() != ntot) {
       cerr << "OutFrac: body count mismatch!\n";
     }
 
     out.setf(ios::left);
     out << setw(18) << tnow;
     
-				// Sort the radii
-    sort(rtot.begin(), rtot.end());
-    
-				// Send all radii to 
 				// Put quantiles into file
-    int indx;
+    for (int i=0; i<numQuant; i++) out << setw(18) << rquant[i];
 
-    for (int i=0; i<numQuant; i++) {
-				// get the index (nearest integer)
-      indx = (int)(Quant[i]*rtot.size()+0.5);
-      if (indx >= rtot.size()) indx = rtot.size()-1;
-
-      out << setw(18) << rtot[indx];
-    }
     out << setw(18) << timer.stop();
     out << endl;
   }
@@ -7,6 +7,7 @@ using namespace std;
 #include "expand.H"
 
 #include <OutLog.H>
+#include <AsyncWriter.H>
 
 char OutLog::lab_global[][19] = {
   "Time",
@@ -137,7 +138,10 @@ void OutLog::Run(int n, int mstep, bool last)
   char mybuffer [bufsize];
   out.rdbuf()->pubsetbuf(mybuffer, bufsize);
 
-  if (myid==0) {
+  // The header is written directly; the data rows are queued for
+  // the writer below
+  //
+  if (myid==0 and firstime) {
 
 				// Open output stream for writing
     out.open(filename, ios::out | ios::app);
@@ -540,69 +544,71 @@ void OutLog::Run(int n, int mstep, bool last)
 
   if (myid == 0) {
 
+    std::ostringstream row;
+
     // =============
     // Global
     // =============
 
-    out << std::scientific << setprecision(precision);
+    row << std::scientific << setprecision(precision);
 
 				// Current time
-    out << std::setw(cwid) << tnow;
+    row << std::setw(cwid) << tnow;
 
     double mtot0 = 0.0;
     for (int i=0; i<comp->ncomp; i++) mtot0 += mtot[i];
 
 				// Total mass
-    out << "|" << setw(cwid) << mtot0;
+    row << "|" << setw(cwid) << mtot0;
 
 				// Total number
     int nbodies0 = 0;
     for (int i=0; i<comp->ncomp; i++) nbodies0 += nbodies[i];
-    out << "|" << setw(cwid) << nbodies0;
+    row << "|" << setw(cwid) << nbodies0;
 
 				// COM
     for (int j=0; j<3; j++)
       if (mtot0>0.0)
-	out << "|" << setw(cwid) << com0[j]/mtot0;
+	row << "|" << setw(cwid) << com0[j]/mtot0;
       else
-	out << "|" << setw(cwid) << 0.0;
+	row << "|" << setw(cwid) << 0.0;
 
 
 				// COV
     for (int j=0; j<3; j++)
       if (mtot0>0.0)
-	out << "|" << setw(cwid) << cov0[j]/mtot0;
+	row << "|" << setw(cwid) << cov0[j]/mtot0;
       else
-	out << "|" << setw(cwid) << 0.0;
+	row << "|" << setw(cwid) << 0.0;
 
 				// Ang mom
     for (int j=0; j<3; j++)
-      out << "|" << setw(cwid) << angm0[j];
+      row << "|" << setw(cwid) << angm0[j];
 
 				// KE
     double ektot0 = 0.0;
     for (int i=0; i<comp->ncomp; i++) ektot0 += ektot[i];
-    out << "|" << setw(cwid) << ektot0;
+    row << "|" << setw(cwid) << ektot0;
 
 				// PE
     double eptot0 = 0.0;
     for (int i=0; i<comp->ncomp; i++) eptot0 += eptot[i] + eptotx[i];
-    out << "|" << setw(cwid) << eptot0;
+    row << "|" << setw(cwid) << eptot0;
 
 				// Clausius, Total, 2T/VC
     double clausius0 = 0.0;
     for (int i=0; i<comp->ncomp; i++) clausius0 += clausius[i];
-    out << "|" << setw(cwid) << clausius0;
-    out << "|" << setw(cwid) << ektot0 + clausius0;
+    row << "|" << setw(cwid) << clausius0;
+    row << "|" << setw(cwid) << ektot0 + clausius0;
     if (clausius0 != 0.0)
-      out << "|" << setw(cwid) << -2.0*ektot0/clausius0;
+      row << "|" << setw(cwid) << -2.0*ektot0/clausius0;
     else
-      out << "|" << setw(cwid) << 0.0;
+      row << "|" << setw(cwid) << 0.0;
 
-    out << "|" << setw(cwid) << wtime;
+    row << "|" << setw(cwid) << wtime;
     int usedT = 0;
     for (int i=0; i<comp->ncomp; i++) usedT += used[i];
-    out << "|" << setw(cwid) << usedT;
+    row << "|" << setw(cwid) << usedT;
 
 
     // =============
@@ -612,22 +618,22 @@ void OutLog::Run(int n, int mstep, bool last)
 
     for (int i=0; i<comp->ncomp; i++) {
 
-      out << "|" << setw(cwid) << mtot[i];
-      out << "|" << setw(cwid) << nbodies[i];
+      row << "|" << setw(cwid) << mtot[i];
+      row << "|" << setw(cwid) << nbodies[i];
       for (int j=0; j<3; j++)
 	if (mtot[i]>0.0)
-	  out << "|" << setw(cwid) << com[i][j]/mtot[i];
+	  row << "|" << setw(cwid) << com[i][j]/mtot[i];
 	else
-	  out << "|" << setw(cwid) << 0.0;
+	  row << "|" << setw(cwid) << 0.0;
       for (int j=0; j<3; j++)
 	if (mtot[i]>0.0)
-	  out << "|" << setw(cwid) << cov[i][j]/mtot[i];
+	  row << "|" << setw(cwid) << cov[i][j]/mtot[i];
 	else
-	  out << "|" << setw(cwid) << 0.0;
+	  row << "|" << setw(cwid) << 0.0;
       for (int j=0; j<3; j++)
-	out << "|" << setw(cwid) << angm[i][j];
+	row << "|" << setw(cwid) << angm[i][j];
       for (int j=0; j<3; j++)
-	out << "|" << setw(cwid) << ctr[i][j];
+	row << "|" << setw(cwid) << ctr[i][j];
 
       double vbar2=0.0;		// Kinetic energy in per component
       if (mtot[i]>0.0) {	// center of velocity frame
@@ -638,26 +644,32 @@ void OutLog::Run(int n, int mstep, bool last)
 				// Update KE to cov frame
       if (nbodies[i]>1) ektot[i] -= 0.5*mtot[i]*vbar2;
 
-      out << "|" << setw(cwid) << ektot[i];
-      out << "|" << setw(cwid) << eptot[i] + eptotx[i];
-      out << "|" << setw(cwid) << clausius[i];
-      out << "|" << setw(cwid) << ektot[i] + clausius[i];
+      row << "|" << setw(cwid) << ektot[i];
+      row << "|" << setw(cwid) << eptot[i] + eptotx[i];
+      row << "|" << setw(cwid) << clausius[i];
+      row << "|" << setw(cwid) << ektot[i] + clausius[i];
       if (clausius[i] != 0.0)
-	out << "|" << setw(cwid) << -2.0*ektot[i]/clausius[i];
+	row << "|" << setw(cwid) << -2.0*ektot[i]/clausius[i];
       else
-	out << "|" << setw(cwid) << 0.0;
-      out << "|" << setw(cwid) << used[i];
+	row << "|" << setw(cwid) << 0.0;
+      row << "|" << setw(cwid) << used[i];
     }
 
-    out << std::endl;
+    row << std::endl;
 
-    try {
-      out.close();
-    }
-    catch (const ofstream::failure& e) {
-      std::cout << "OutLog: exception closing file <" << filename
-		<< ": " << e.what() << std::endl;
+    // Make sure that the header is on disk before the first row
+    //
+    if (out.is_open()) {
+      try {
+	out.close();
+      }
+      catch (const ofstream::failure& e) {
+	std::cout << "OutLog: exception closing file <" << filename
+		  << ": " << e.what() << std::endl;
+      }
     }
+
+    AsyncWriter::instance().text(filename, row.str());
   }
 
 }
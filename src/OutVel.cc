@@ -1,4 +1,3 @@
-#include <filesystem>
 #include <iostream>
 #include <fstream>
 #include <iomanip>
@@ -6,6 +5,7 @@
 #include <expand.H>
 
 #include <OutVel.H>
+#include <AsyncWriter.H>
 
 const std::set<std::string>
 OutVel::valid_keys = {
@@ -185,35 +185,13 @@ void OutVel::Run(int n, int mstep, bool last)
     }
   }
   
-  // Make coefficients and enter in coefficient DB
+  // Make coefficients
   //
-  coefs->add(basis->makeFromArray(tnow));
+  auto cur = basis->makeFromArray(tnow);
 
-  // Only root node writes the coefficient file
+  // Only root node writes the coefficient file.  The writer creates
+  // or extends the HDF5 file and owns the container from here on.
   //
-  if (myid==0) {
-
-    // Check if file exists and extend the existing HDF5 file
-    //
-    if (std::filesystem::exists(outfile)) {
-      if (dof==2)
-	std::dynamic_pointer_cast<CoefClasses::CylFldCoefs>(coefs)->
-	  ExtendH5Coefs(outfile);
-      else
-	std::dynamic_pointer_cast<CoefClasses::SphFldCoefs>(coefs)->
-	  ExtendH5Coefs(outfile);
-    }
-    // Otherwise, write a new HDF5 coefficient file
-    //
-    else {
-      if (dof==2)
-	std::dynamic_pointer_cast<CoefClasses::CylFldCoefs>(coefs)->
-	  WriteH5Coefs(outfile);
-      else
-	std::dynamic_pointer_cast<CoefClasses::SphFldCoefs>(coefs)->
-	  WriteH5Coefs(outfile);
-    }
-  }
-  // END: write to file
+  if (myid==0) AsyncWriter::instance().coefs(outfile, *coefs, cur);
 }
 
@@ -10,6 +10,7 @@
 
 #include <PolarBasis.H>
 #include <MixtureBasis.H>
+#include <AsyncWriter.H>
 
 // #define TMP_DEBUG
 // #define MULTI_DEBUG
@@ -46,7 +47,9 @@ PolarBasis::valid_keys = {
   "mlim",
   "ssfrac",
   "playback",
-  "coefMaster"
+  "coefMaster",
+  "mstep_order",
+  "mstep_diag"
 };
 
 PolarBasis::PolarBasis(Component* c0, const YAML::Node& conf, MixtureBasis *m) : 
@@ -82,6 +85,8 @@ PolarBasis::PolarBasis(Component* c0, const YAML::Node& conf, MixtureBasis *m) :
   cuda_aware       = true;
 #endif
   is_flat          = false;
+  mstep_order      = 1;
+  mstep_diag       = false;
 
   // Remove matched keys
   //
@@ -185,6 +190,8 @@ PolarBasis::PolarBasis(Component* c0, const YAML::Node& conf, MixtureBasis *m) :
       }
     }
 
+    if (conf["mstep_order"]) mstep_order = conf["mstep_order"].as<int>();
+    if (conf["mstep_diag"])  mstep_diag  = conf["mstep_diag"].as<bool>();
   }
   catch (YAML::Exception & error) {
     if (myid==0) std::cout << "Error parsing parameters in PolarBasis: "
@@ -233,6 +240,15 @@ PolarBasis::PolarBasis(Component* c0, const YAML::Node& conf, MixtureBasis *m) :
       v->setZero();
     }
   }
+
+  // Higher-order interpolation of the inactive levels
+  //
+  if (multistep and mstep_order>1) {
+    std::string diagfile;
+    if (mstep_diag) diagfile = outdir + runtag + ".mstep_diag." + component->name;
+    msinterp = std::make_shared<MultistepInterp>(mstep_order, multistep+1,
+						 diagfile);
+  }
     
   expcoef .resize(2*Mmax+1);
   expcoef1.resize(2*Mmax+1);
@@ -328,6 +344,11 @@ PolarBasis::PolarBasis(Component* c0, const YAML::Node& conf, MixtureBasis *m) :
   //
   cylmass = 0.0;
   cylmass1 = std::vector<double>(nthrds);
+
+  // Attributes for HDF5 coefficient output
+  //
+  cylCoefs.setName(component->name);
+  cylCoefs.setH5Chunked(h5chunked, h5compress);
 }
 
 PolarBasis::~PolarBasis()
@@ -710,6 +731,11 @@ void PolarBasis::determine_coefficients_particles(void)
   cout << "Process " << myid << ": in <determine_coefficients>" << endl;
 #endif
 
+  // Save the outgoing coefficients for higher-order interpolation
+  //
+  if (msinterp)
+    msinterp->push(mlevel, MultistepInterp::flatten(expcoefL[mlevel]), tnow);
+
   // Swap interpolation arrays
   //
   auto p = expcoefL[mlevel];
@@ -1134,8 +1160,15 @@ void PolarBasis::compute_multistep_coefficients()
     double b = numer/denom;	// Interpolation weights
     double a = 1.0 - b;
 
-    for (int m=0; m<=2*Mmax; m++) {
-      *expcoef[m] += a*(*expcoefL[M][m]) + b*(*expcoefN[M][m]);
+    if (msinterp) {
+      auto C = msinterp->combine(M, b,
+				 MultistepInterp::flatten(expcoefL[M]),
+				 MultistepInterp::flatten(expcoefN[M]));
+      MultistepInterp::addTo(C, expcoef);
+    } else {
+      for (int m=0; m<=2*Mmax; m++) {
+	*expcoef[m] += a*(*expcoefL[M][m]) + b*(*expcoefN[M][m]);
+      }
     }
     
     //  +--- Deep debugging
@@ -1203,6 +1236,8 @@ void PolarBasis::compute_multistep_coefficients()
     }
   }
 
+  if (msinterp) msinterp->report(tnow, mstep, mdrft);
+
 #ifdef TMP_DEBUG
   if (myid==0) {
 
@@ -1323,15 +1358,6 @@ void PolarBasis::compute_multistep_coefficients()
 
 void * PolarBasis::determine_acceleration_and_potential_thread(void * arg)
 {
-  constexpr double norm0 = 0.5*M_2_SQRTPI/M_SQRT2;
-  constexpr double norm1 = 0.5*M_2_SQRTPI;
-
-  double r, r0=0.0, phi;
-  double potr, potz, potl, potp, p, pc, drc, drs, dzc, dzs, ps, dfacp, facdp;
-
-  double pos[3];
-  double xx, yy, zz, mfac=1.0;
-
   vector<double> ctr;
   if (mix) mix->getCenter(ctr);
   
@@ -1365,155 +1391,215 @@ void * PolarBasis::determine_acceleration_and_potential_thread(void * arg)
 
       if (cC->freeze(indx)) continue;
 
-      if (mix) {
-	if (use_external) {
-	  cC->Pos(pos, indx, Component::Inertial);
-	  component->ConvertPos(pos, Component::Local);
-	} else
-	  cC->Pos(pos, indx, Component::Local);
-
-	mfac = mix->Mixture(pos);
-	xx = pos[0] - ctr[0];
-	yy = pos[1] - ctr[1];
-	zz = pos[2] - ctr[2];
-      } else {
-	if (use_external) {
-	  cC->Pos(pos, indx, Component::Inertial);
-	  component->ConvertPos(pos, Component::Local | Component::Centered);
-	} else
-	  cC->Pos(pos, indx, Component::Local | Component::Centered);
+      accel_particle(indx, id, ctr);
+    }
+    // END: particle loop
+  }
+  // END: level loop
+
+  thread_timing_end(id);
+
+  return (NULL);
+}
+
+
+void PolarBasis::accel_particle(int indx, int id,
+				const std::vector<double>& ctr)
+{
+  constexpr double norm0 = 0.5*M_2_SQRTPI/M_SQRT2;
+  constexpr double norm1 = 0.5*M_2_SQRTPI;
+
+  double r, phi;
+  double potr, potz, potl, potp, p, pc, drc, drs, dzc, dzs, ps;
+
+  double pos[3];
+  double xx, yy, zz, mfac=1.0;
+
+  if (mix) {
+    if (use_external) {
+      cC->Pos(pos, indx, Component::Inertial);
+      component->ConvertPos(pos, Component::Local);
+    } else
+      cC->Pos(pos, indx, Component::Local);
+
+    mfac = mix->Mixture(pos);
+    xx = pos[0] - ctr[0];
+    yy = pos[1] - ctr[1];
+    zz = pos[2] - ctr[2];
+  } else {
+    if (use_external) {
+      cC->Pos(pos, indx, Component::Inertial);
+      component->ConvertPos(pos, Component::Local | Component::Centered);
+    } else
+      cC->Pos(pos, indx, Component::Local | Component::Centered);
 	
-	xx = pos[0];
-	yy = pos[1];
-	zz = pos[2];
-      }	
+    xx = pos[0];
+    yy = pos[1];
+    zz = pos[2];
+  }	
 
-      r = sqrt(xx*xx + yy*yy) + DSMALL;
-      phi = atan2(yy, xx);
+  r = sqrt(xx*xx + yy*yy) + DSMALL;
+  phi = atan2(yy, xx);
 
-      double rtab  = getRtable();
-      double ratio = sqrt(r*r + zz*zz)/rtab;
-      double frac = 1.0, cfrac = 0.0;
+  double rtab  = getRtable();
+  double ratio = sqrt(r*r + zz*zz)/rtab;
+  double frac = 1.0, cfrac = 0.0;
 
-      // Algorithm constants
-      //
-      constexpr double ratmin = 0.75;
-      constexpr double maxerf = 3.0;
-      constexpr double midpt  = ratmin + 0.5*(1.0 - ratmin);
-      constexpr double rsmth  = 0.5*(1.0 - ratmin)/maxerf;
+  // Algorithm constants
+  //
+  constexpr double ratmin = 0.75;
+  constexpr double maxerf = 3.0;
+  constexpr double midpt  = ratmin + 0.5*(1.0 - ratmin);
+  constexpr double rsmth  = 0.5*(1.0 - ratmin)/maxerf;
       
-      if (NO_MONO) {
-	ratio = 0.0;
-      } else if (ratio >= 1.0) {
-	frac  = 0.0;
-	cfrac = 1.0;
-      } else if (ratio > ratmin) {
-	frac  = 0.5*(1.0 - erf( (ratio - midpt)/rsmth ));
-	cfrac = 1.0 - frac;
-      } else {
-	frac  = 1.0;
-      }
+  if (NO_MONO) {
+    ratio = 0.0;
+  } else if (ratio >= 1.0) {
+    frac  = 0.0;
+    cfrac = 1.0;
+  } else if (ratio > ratmin) {
+    frac  = 0.5*(1.0 - erf( (ratio - midpt)/rsmth ));
+    cfrac = 1.0 - frac;
+  } else {
+    frac  = 1.0;
+  }
       
-      // TEST ratio override
-      ratio = 0.0;
+  // TEST ratio override
+  ratio = 0.0;
 
-      // Ongrid contribution
-      //
-      if (ratio < 1.0) {
+  // Ongrid contribution
+  //
+  if (ratio < 1.0) {
 
-	sinecosine_R(Mmax, phi, cosm[id], sinm[id]);
+    sinecosine_R(Mmax, phi, cosm[id], sinm[id]);
 
-	potl = potr = potz = potp = 0.0;
+    potl = potr = potz = potp = 0.0;
       
-	get_dpotl(r, zz, potd[id], dpotR[id], dpotZ[id], id);
+    get_dpotl(r, zz, potd[id], dpotR[id], dpotZ[id], id);
 
-	// Add m=0 force contribution
-	//
-	if (not NO_M0) {
+    // Add m=0 force contribution
+    //
+    if (not NO_M0) {
 
-	  if (M0_back) {
-	    auto [p, drc, dzc] = get_pot_background(r, zz);
+      if (M0_back) {
+	auto [p, drc, dzc] = get_pot_background(r, zz);
 
-	    potl = mfac * p;
-	    potr = mfac * drc;
-	    potz = mfac * dzc;
-	  } else {
-	    get_pot_coefs_safe(0, *expcoef[0], p, drc, dzc,
-			       potd[id], dpotR[id], dpotZ[id]);
+	potl = mfac * p;
+	potr = mfac * drc;
+	potz = mfac * dzc;
+      } else {
+	get_pot_coefs_safe(0, *expcoef[0], p, drc, dzc,
+			   potd[id], dpotR[id], dpotZ[id]);
 
-	    potl = mfac*norm0 * p;
-	    potr = mfac*norm0 * drc;
-	    potz = mfac*norm0 * dzc;
-	  }
-	}
+	potl = mfac*norm0 * p;
+	potr = mfac*norm0 * drc;
+	potz = mfac*norm0 * dzc;
+      }
+    }
 	
-	// Asymmetric terms?
-	//
-	if (not M0_only) {
+    // Asymmetric terms?
+    //
+    if (not M0_only) {
 
-	  //		m loop
-	  //		------
-	  for (int m=1, moffset=1; m<=std::min(mlim, Mmax); m++, moffset+=2) {
+      //		m loop
+      //		------
+      for (int m=1, moffset=1; m<=std::min(mlim, Mmax); m++, moffset+=2) {
 	    
-	    // Skip m=1 terms?
-	    //
-	    if (NO_M1 && m==1) continue;
+	// Skip m=1 terms?
+	//
+	if (NO_M1 && m==1) continue;
 	    
-	    // Skip odd m terms?
-	    //
-	    if (EVEN_M && (m/2)*2 != m) continue;
+	// Skip odd m terms?
+	//
+	if (EVEN_M && (m/2)*2 != m) continue;
 	    
-	    get_pot_coefs_safe(m, *expcoef[moffset  ], pc, drc, dzc, potd[id], dpotR[id], dpotZ[id]);
-	    get_pot_coefs_safe(m, *expcoef[moffset+1], ps, drs, dzs, potd[id], dpotR[id], dpotZ[id]);
+	get_pot_coefs_safe(m, *expcoef[moffset  ], pc, drc, dzc, potd[id], dpotR[id], dpotZ[id]);
+	get_pot_coefs_safe(m, *expcoef[moffset+1], ps, drs, dzs, potd[id], dpotR[id], dpotZ[id]);
 	    
-	    potl += mfac*norm1 * (pc*  cosm[id][m] + ps*  sinm[id][m]);
-	    potr += mfac*norm1 * (drc* cosm[id][m] + drs* sinm[id][m]);
-	    potp += mfac*norm1 * (pc*  sinm[id][m] - ps*  cosm[id][m]) * m;
-	    potz += mfac*norm1 * (dzc* cosm[id][m] + dzs* sinm[id][m]);
-	  }
-	  // END: m loop
-	}
-	// END: not M0_only
+	potl += mfac*norm1 * (pc*  cosm[id][m] + ps*  sinm[id][m]);
+	potr += mfac*norm1 * (drc* cosm[id][m] + drs* sinm[id][m]);
+	potp += mfac*norm1 * (pc*  sinm[id][m] - ps*  cosm[id][m]) * m;
+	potz += mfac*norm1 * (dzc* cosm[id][m] + dzs* sinm[id][m]);
+      }
+      // END: m loop
+    }
+    // END: not M0_only
 
-	double rfac = xx*xx + yy*yy;
+    double rfac = xx*xx + yy*yy;
 
-	cC->AddAcc(indx, 0, potr*xx/r * frac);
-	cC->AddAcc(indx, 1, potr*yy/r * frac);
-	cC->AddAcc(indx, 2, potz      * frac);
+    cC->AddAcc(indx, 0, potr*xx/r * frac);
+    cC->AddAcc(indx, 1, potr*yy/r * frac);
+    cC->AddAcc(indx, 2, potz      * frac);
 
-	if (rfac > DSMALL) {
-	  cC->AddAcc(indx, 0, -potp*yy/rfac * frac);
-	  cC->AddAcc(indx, 1,  potp*xx/rfac * frac);
-	}
+    if (rfac > DSMALL) {
+      cC->AddAcc(indx, 0, -potp*yy/rfac * frac);
+      cC->AddAcc(indx, 1,  potp*xx/rfac * frac);
+    }
 	
-	cC->AddPot(indx, potl * frac);
-      }
-      // END: ratio < 1.0
+    cC->AddPot(indx, potl * frac);
+  }
+  // END: ratio < 1.0
 
       
-      // Off-grid contribution
-      //
-      if (ratio > ratmin) {
+  // Off-grid contribution
+  //
+  if (ratio > ratmin) {
 
-	double r3 = r*r + zz*zz;
-	double pp = -cylmass*mfac/sqrt(r3); // -M/r
-	double fr = pp/r3;		    // -M/r^3
+    double r3 = r*r + zz*zz;
+    double pp = -cylmass*mfac/sqrt(r3); // -M/r
+    double fr = pp/r3;		    // -M/r^3
 
-	cC->AddAcc(indx, 0, xx*fr * cfrac);
-	cC->AddAcc(indx, 1, yy*fr * cfrac);
-	cC->AddAcc(indx, 2, zz*fr * cfrac);
+    cC->AddAcc(indx, 0, xx*fr * cfrac);
+    cC->AddAcc(indx, 1, yy*fr * cfrac);
+    cC->AddAcc(indx, 2, zz*fr * cfrac);
 
-	cC->AddPot(indx, pp * cfrac);
-      }
-      // END: ratio > ratmin
+    cC->AddPot(indx, pp * cfrac);
+  }
+  // END: ratio > ratmin
+}
+
+
+void PolarBasis::batch_begin(Component* C)
+{
+  cC = C;
+  nbodies = cC->Number();
+
+  MPL_start_timer();
+
+  if (play_back) {
+    swap_coefs(expcoefP, expcoef);
+  }
+
+  if (use_external == false) {
+
+    if (multistep && (self_consistent || initializing)) {
+      compute_multistep_coefficients();
     }
-    // END: particle loop
+
   }
-  // END: level loop
 
-  thread_timing_end(id);
+  if (mix) mix->getCenter(bctr);
+}
 
-  return (NULL);
+
+void PolarBasis::batch_eval(const int* indx, int n, int id)
+{
+  for (int i=0; i<n; i++) {
+    if (cC->freeze(indx[i])) continue;
+    accel_particle(indx[i], id, bctr);
+  }
+}
+
+
+void PolarBasis::batch_end()
+{
+  if (play_back) {
+    swap_coefs(expcoef, expcoefP);
+  }
+
+  MPL_stop_timer();
+
+  use_external = false;
 }
 
 
@@ -1786,28 +1872,14 @@ void PolarBasis::dump_coefs_h5(const std::string& file)
   //
   cur->ctr = component->getCenter(Component::Local | Component::Centered);
 
-  // Check if file exists
+  // Copy the YAML config.  Only used when the file is created.
   //
-  if (std::filesystem::exists(file)) {
-    cylCoefs.clear();
-    cylCoefs.add(cur);
-    cylCoefs.ExtendH5Coefs(file);
-  }
-  // Otherwise, extend the existing HDF5 file
+  std::ostringstream sout; sout << conf;
+  cur->buf = sout.str();	// Copy to CoefStruct buffer
+
+  // Create or extend the HDF5 file
   //
-  else {
-    // Copy the YAML config.  We only need this on the first call.
-    std::ostringstream sout; sout << conf;
-    cur->buf = sout.str();	// Copy to CoefStruct buffer
-
-    // Add the name attribute.  We only need this on the first call.
-    cylCoefs.setName(component->name);
-
-    // And the new coefficients and write the new HDF5
-    cylCoefs.clear();
-    cylCoefs.add(cur);
-    cylCoefs.WriteH5Coefs(file);
-  }
+  AsyncWriter::instance().coefs(file, cylCoefs, cur);
 }
 
 
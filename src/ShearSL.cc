@@ -1,9 +1,9 @@
-#include <filesystem>
 #include <cmath>
 
 #include "expand.H"
 
 #include <Coefficients.H>
+#include <AsyncWriter.H>
 #include <biorth1d.H>
 #include <ShearSL.H>
 
@@ -76,6 +76,11 @@ ShearSL::ShearSL(Component* c0, const YAML::Node& conf) : PotAccel(c0, conf)
 
   for (auto & v : zpot) v.resize(nmaxz);
   for (auto & v : zfrc) v.resize(nmaxz);
+
+  // Name for the coefficient file; set here since the container
+  // belongs to the output writer once the first snapshot is queued
+  //
+  slabCoefs.setName(component->name);
 }
 
 ShearSL::~ShearSL()
@@ -357,27 +362,13 @@ void ShearSL::dump_coefs_h5(const std::string& file)
     }
   }
 
-  // Check if file exists
+  // Copy the YAML config.  Only used when the file is created.
   //
-  if (std::filesystem::exists(file)) {
-    slabCoefs.clear();
-    slabCoefs.add(cur);
-    slabCoefs.ExtendH5Coefs(file);
-  }
-  // Otherwise, extend the existing HDF5 file
+  std::ostringstream sout; sout << conf;
+  cur->buf = sout.str();	// Copy to CoefStruct buffer
+
+  // Create or extend the HDF5 file
   //
-  else {
-    // Copy the YAML config.  We only need this on the first call.
-    std::ostringstream sout; sout << conf;
-    cur->buf = sout.str();	// Copy to CoefStruct buffer
-
-    // Add the name attribute.  We only need this on the first call.
-    slabCoefs.setName(component->name);
-
-    // And the new coefficients and write the new HDF5
-    slabCoefs.clear();
-    slabCoefs.add(cur);
-    slabCoefs.WriteH5Coefs(file);
-  }
+  AsyncWriter::instance().coefs(file, slabCoefs, cur);
 }
 
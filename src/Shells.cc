@@ -1,4 +1,5 @@
 #include <Shells.H>
+#include <ParallelQuantile.H>
 
 const std::set<std::string>
 Shells::valid_keys = {
@@ -20,22 +21,9 @@ Shells::Shells(Component* c0, const YAML::Node& conf) : PotAccel(c0, conf)
   rgridT.resize(nthrds);
   mgridT.resize(nthrds);
   igridT.resize(nthrds);
+  lgridT.resize(nthrds);
   usedT .resize(nthrds);
 
-				// For Alltoallv calls
-  sdispl.resize(numprocs);
-  std::fill(sdispl.begin(), sdispl.end(), 0);
-  
-  sndcts.resize(numprocs);
-  std::fill(sndcts.begin(), sndcts.end(), 1);
-
-  rcvcts.resize(numprocs);
-  for (int n=0; n<numprocs; n++) rcvcts[n] = n;
-
-  rdispl.resize(numprocs);
-  snumbr.resize(numprocs);
-  rnumbr.resize(numprocs);
-
 				// For storage of samples at each level
   rgrid.resize(multistep+1);
   mgrid.resize(multistep+1);
@@ -173,100 +161,54 @@ void * Shells::determine_acceleration_and_potential_thread(void * arg)
 
 void Shells::determine_coefficients(void) 
 {
-				// For error info
-  char msg[MPI_MAX_ERROR_STRING];
-  int msglen;
 				// Clear the data arrays
   for (int i=0; i<nthrds; i++) {
     rgridT[i].clear();
     mgridT[i].clear();
     igridT[i].clear();
+    lgridT[i].clear();
     usedT[i] = 0;
   }
+				// The samples are kept for local
+				// particles only.  If the particle
+				// set has changed since the last
+				// pass, resample every level so that
+				// no particle is counted twice or
+				// missed.
+  bool rebuild = cC->particle_epoch != epoch;
+  epoch = cC->particle_epoch;
+
+  lfirst = rebuild ? 0 : mlevel;
+  llast  = rebuild ? multistep : mlevel;
+
 				// Make the radius--mass lists
   exp_thread_fork(true);
   
-  used1  = usedT[0];
-  rgrid1 = rgridT[0];
-  mgrid1 = mgridT[0];
-  igrid1 = igridT[0];
-  for (int i=1; i<nthrds; i++) {
-    rgrid1.insert(rgrid1.end(), rgridT[i].begin(), rgridT[i].end());
-    mgrid1.insert(mgrid1.end(), mgridT[i].begin(), mgridT[i].end());
-    igrid1.insert(igrid1.end(), igridT[i].begin(), igridT[i].end());
-    used1 += usedT[i];
-  }
+  used1 = 0;
+  for (int i=0; i<nthrds; i++) used1 += usedT[i];
 
 
   MPI_Allreduce(&used1, &used, 1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
 
-  if (used) {
+				// Each process keeps the samples for
+				// its own particles only
+  if (used or rebuild) {
 
-    int pn = rgrid1.size();
-
-    if (int ret=
-	MPI_Alltoallv(&pn, &sndcts[0], &sdispl[0], MPI_INT, 
-		      &rnumbr[0], &sndcts[0], &rcvcts[0], MPI_INT, 
-		      MPI_COMM_WORLD)
-	) 
-      {
-	MPI_Error_string(ret, msg, &msglen);
-	cout << "Shells::determine_coefficients: " << msg << endl;
-      }
-  
-    int nsum = 0;
-    for (int n=0; n<numprocs; n++) {
-      snumbr[n] = pn;
-      rdispl[n] = nsum;
-      nsum += rnumbr[n];
+    for (int m=lfirst; m<=llast; m++) {
+      rgrid[m].clear();
+      mgrid[m].clear();
     }
-				// Share the lists will all processes
-
-    vector<double> rgridX(nsum);
-    vector<double> mgridX(nsum);
-    vector<int   > igridX(nsum);
-
-    rgrid[mlevel].clear();
-    mgrid[mlevel].clear();
-
-    if (int ret=
-	MPI_Alltoallv(&rgrid1[0], &snumbr[0], &sdispl[0], MPI_DOUBLE, 
-		      &rgridX[0], &rnumbr[0], &rdispl[0], MPI_DOUBLE,
-		      MPI_COMM_WORLD)
-	)
-      {
-	MPI_Error_string(ret, msg, &msglen);
-	cout << "Shells::determine_coefficients: " << msg << endl;
-      }
-
-    
-    if (int ret=
-	MPI_Alltoallv(&mgrid1[0], &snumbr[0], &sdispl[0], MPI_DOUBLE, 
-		      &mgridX[0], &rnumbr[0], &rdispl[0], MPI_DOUBLE,
-		      MPI_COMM_WORLD)
-	)
-      {
-	MPI_Error_string(ret, msg, &msglen);
-	cout << "Shells::determine_coefficients: " << msg << endl;
-      }
 
-    if (int ret=
-	MPI_Alltoallv(&igrid1[0], &snumbr[0], &sdispl[0], MPI_INT, 
-		      &igridX[0], &rnumbr[0], &rdispl[0], MPI_INT,
-		      MPI_COMM_WORLD)
-	)
-      {
-	MPI_Error_string(ret, msg, &msglen);
-	cout << "Shells::determine_coefficients: " << msg << endl;
+    for (int n=0; n<nthrds; n++) {
+      for (size_t i=0; i<igridT[n].size(); i++) {
+	int m = lgridT[n][i];
+	rgrid[m][igridT[n][i]] = rgridT[n][i];
+	mgrid[m][igridT[n][i]] = mgridT[n][i];
       }
-
-    for (int i=0; i<nsum; i++) {
-      rgrid[mlevel][igridX[i]] = rgridX[i];
-      mgrid[mlevel][igridX[i]] = mgridX[i];
     }
   }
 
-				// Make and sort the list
+				// Make and sort the local list
 
   double mfac = 1.0;
   if (nsample>1) mfac *= nsample;
@@ -279,38 +221,57 @@ void Shells::determine_coefficients(void)
       grid.push_back(Dpair((ri++)->second, (mi++)->second*mfac));
   }
   
-  if (grid.size()) {
+  sort(grid.begin(), grid.end());
 
-    sort(grid.begin(), grid.end());
+  std::vector<double> rloc(grid.size());
+  for (size_t i=0; i<grid.size(); i++) rloc[i] = grid[i].first;
 
-    int ntot = grid.size();
-  
-    rgrid0.clear();
-    mgrid0.clear();
-    pgrid0.clear();
-
-    double rL=0.0, rC, mL=0.0, mC;
-    vector<double> vval(3, 0.0);
-
-    for (int i=0; i<ntot; i++) {
-      rC = grid[i].first;
-      mC = grid[i].second;
-
-      vval[0] = rC;
-      vval[1] += 0.5*(mL + mC);
-      if (rL > 0.0)
-	vval[2] += 0.5*(mL/rL + mC/rC);
-      else
-	vval[2] += 0.5*(0.0   + mC/rC);
-      
-      if ( (i % nselect) == 0) {
-	rgrid0.push_back(vval[0]);
-	mgrid0.push_back(vval[1]);
-	pgrid0.push_back(vval[2]);
-      }
+  uint64_t ntot = ParallelQuantile::total(rloc);
+
+  rgrid0.clear();
+  mgrid0.clear();
+  pgrid0.clear();
+
+  if (ntot) {
+
+    // The shell radii are every nselect-th radius over all
+    // processes, found without collecting the radii
+    //
+    int nshell = (ntot - 1)/nselect + 1;
+    std::vector<uint64_t> indx(nshell);
+    for (int k=0; k<nshell; k++) indx[k] = static_cast<uint64_t>(k)*nselect;
 
-      rL = rC;
-      mL = mC;
+    rgrid0 = ParallelQuantile::select(rloc, indx);
+
+    // Cumulative local mass and mass/radius
+    //
+    std::vector<double> cumM(grid.size()+1, 0.0), cumP(grid.size()+1, 0.0);
+    for (size_t i=0; i<grid.size(); i++) {
+      cumM[i+1] = cumM[i] + grid[i].second;
+      cumP[i+1] = cumP[i] + grid[i].second/grid[i].first;
+    }
+
+    // Trapezoidal rule in particle order: all of the mass inside each
+    // shell radius and half of the mass at the radius
+    //
+    std::vector<double> sums(4*nshell);
+    for (int k=0; k<nshell; k++) {
+      int lo = std::lower_bound(rloc.begin(), rloc.end(), rgrid0[k]) - rloc.begin();
+      int hi = std::upper_bound(rloc.begin(), rloc.end(), rgrid0[k]) - rloc.begin();
+      sums[4*k+0] = cumM[lo];
+      sums[4*k+1] = cumM[hi] - cumM[lo];
+      sums[4*k+2] = cumP[lo];
+      sums[4*k+3] = cumP[hi] - cumP[lo];
+    }
+
+    MPI_Allreduce(MPI_IN_PLACE, sums.data(), sums.size(), MPI_DOUBLE, MPI_SUM,
+		  MPI_COMM_WORLD);
+
+    mgrid0.resize(nshell);
+    pgrid0.resize(nshell);
+    for (int k=0; k<nshell; k++) {
+      mgrid0[k] = sums[4*k+0] + 0.5*sums[4*k+1];
+      pgrid0[k] = sums[4*k+2] + 0.5*sums[4*k+3];
     }
 
     double potlF = pgrid0.back();
@@ -328,34 +289,38 @@ void Shells::determine_coefficients(void)
 void * Shells::determine_coefficients_thread(void *arg) 
 {
   double rr;
-
-  unsigned nbodies = cC->levlist[mlevel].size();
-  int id   = *((int*)arg);
-  int nbeg = nbodies*id/nthrds;
-  int nend = nbodies*(id+1)/nthrds;
+  int id = *((int*)arg);
 
   unsigned long j;		// Index of the current local particle
 
-  for (int i=nbeg; i<nend; i++) {
+  for (int lev=lfirst; lev<=llast; lev++) {
+
+    unsigned nbodies = cC->levlist[lev].size();
+    int nbeg = nbodies*id/nthrds;
+    int nend = nbodies*(id+1)/nthrds;
+
+    for (int i=nbeg; i<nend; i++) {
     
-    j = cC->levlist[mlevel][i];
+      j = cC->levlist[lev][i];
 
 				// Don't need acceleration for frozen particles
-    if (cC->freeze(j)) continue;
+      if (cC->freeze(j)) continue;
     
-    if (nsample>1 && (i % nsample)) continue;
+      if (nsample>1 && (i % nsample)) continue;
 
 				// Compute radius
-    rr = sqrt(
-	      cC->Pos(j, 0)*cC->Pos(j, 0) +
-	      cC->Pos(j, 1)*cC->Pos(j, 1) +
-	      cC->Pos(j, 2)*cC->Pos(j, 2) 
-	      );
+      rr = sqrt(
+		cC->Pos(j, 0)*cC->Pos(j, 0) +
+		cC->Pos(j, 1)*cC->Pos(j, 1) +
+		cC->Pos(j, 2)*cC->Pos(j, 2) 
+		);
 				// Load vectors
-    rgridT[id].push_back(rr);
-    mgridT[id].push_back(cC->Mass(j));
-    igridT[id].push_back(j);
-    usedT[id]++;
+      rgridT[id].push_back(rr);
+      mgridT[id].push_back(cC->Mass(j));
+      igridT[id].push_back(j);
+      lgridT[id].push_back(lev);
+      usedT[id]++;
+    }
   }
 
   return (NULL);
@@ -376,73 +341,28 @@ void Shells::multistep_update_begin()
 void Shells::multistep_update_finish()
 {
   //
-  // Accumulate the change requests from each thread
-  //
-  for (int n=1; n<nthrds; n++) {
-    update_fr[0].insert(update_fr[0].end(),
-			update_fr[n].begin(), update_fr[n].end());
-
-    update_to[0].insert(update_to[0].end(),
-			update_to[n].begin(), update_to[n].end());
-
-    update_ii[0].insert(update_ii[0].end(),
-			update_ii[n].begin(), update_ii[n].end());
-  }
-  
-  //
-  // Number of changes for this process
-  //
-  int pn = update_fr[0].size();
-
-  //
-  // Communicate the changes per process to all processes
-  //
-  MPI_Alltoallv(&pn, &sndcts[0], &sdispl[0], MPI_INT, 
-		&rnumbr[0], &sndcts[0], &rcvcts[0], MPI_INT, 
-		MPI_COMM_WORLD);
-
-  int nsum = 0;
-  for (int n=0; n<numprocs; n++) {
-    snumbr[n] = pn;
-    rdispl[n] = nsum;
-    nsum += rnumbr[n];
-  }
-
-
-  vector<int> fr(nsum);
-  vector<int> to(nsum);
-  vector<int> ii(nsum);
-
-  //
-  // Share exchange lists will all processes
+  // The sample lists only hold local particles so each process
+  // applies its own changes
   //
-  MPI_Alltoallv(&update_fr[0][0], &snumbr[0], &sdispl[0], MPI_INT, 
-		&fr[0],           &rnumbr[0], &rdispl[0], MPI_INT,
-		MPI_COMM_WORLD);
+  map<int, double>::iterator rr, mm;
 
-  MPI_Alltoallv(&update_to[0][0], &snumbr[0], &sdispl[0], MPI_INT, 
-		&to[0],           &rnumbr[0], &rdispl[0], MPI_INT,
-		MPI_COMM_WORLD);
+  for (int n=0; n<nthrds; n++) {
 
-  MPI_Alltoallv(&update_ii[0][0], &snumbr[0], &sdispl[0], MPI_INT, 
-		&ii[0],           &rnumbr[0], &rdispl[0], MPI_INT,
-		MPI_COMM_WORLD);
+    for (size_t i=0; i<update_fr[n].size(); i++) {
 
-  //
-  // Each process performs the update
-  //
-  map<int, double>::iterator rr, mm;
-
-  for (int i=0; i<nsum; i++) {
+      int fr = update_fr[n][i];
+      int to = update_to[n][i];
+      int ii = update_ii[n][i];
 
-    rr = rgrid[fr[i]].find(ii[i]);
-    mm = mgrid[fr[i]].find(ii[i]);
+      rr = rgrid[fr].find(ii);
+      mm = mgrid[fr].find(ii);
 
-    rgrid[to[i]][ii[i]] = rr->second;
-    mgrid[to[i]][ii[i]] = mm->second;
+      rgrid[to][ii] = rr->second;
+      mgrid[to][ii] = mm->second;
 
-    rgrid[fr[i]].erase(rr);
-    mgrid[fr[i]].erase(mm);
+      rgrid[fr].erase(rr);
+      mgrid[fr].erase(mm);
+    }
   }
 
 }
@@ -4,6 +4,7 @@
 #include "expand.H"
 
 #include <SlabSL.H>
+#include <AsyncWriter.H>
 
 const std::set<std::string>
 SlabSL::valid_keys = {
@@ -15,7 +16,9 @@ SlabSL::valid_keys = {
   "hslab",
   "zmax",
   "ngrid",
-  "type"
+  "type",
+  "mstep_order",
+  "mstep_diag"
 };
 
 //@{
@@ -32,6 +35,8 @@ SlabSL::SlabSL(Component* c0, const YAML::Node& conf) : PotAccel(c0, conf)
   zmax      = 10.0;
   hslab     = 0.2;
   coef_dump = true;
+  mstep_order = 1;
+  mstep_diag  = false;
 
 #if HAVE_LIBCUDA==1
   cuda_aware = true;
@@ -134,7 +139,19 @@ SlabSL::SlabSL(Component* c0, const YAML::Node& conf) : PotAccel(c0, conf)
     expccofN[i] -> setZero();
     expccofL[i] -> setZero();
   }
+
+  // Higher-order interpolation of the inactive levels
+  //
+  if (multistep and mstep_order>1) {
+    std::string diagfile;
+    if (mstep_diag) diagfile = outdir + runtag + ".mstep_diag." + component->name;
+    msinterp = std::make_shared<MultistepInterp>(mstep_order, multistep+1,
+						 diagfile);
+  }
     
+  // Name attribute for HDF5 coefficient output
+  //
+  slabCoefs.setName(component->name);
 }
 
 SlabSL::~SlabSL()
@@ -162,6 +179,8 @@ void SlabSL::initialize()
     if (conf["hslab"])          hslab       = conf["hslab"].as<double>();
     if (conf["zmax" ])          zmax        = conf["zmax" ].as<double>();
     if (conf["type" ])          type        = conf["type" ].as<std::string>();
+    if (conf["mstep_order"])    mstep_order = conf["mstep_order"].as<int>();
+    if (conf["mstep_diag"])     mstep_diag  = conf["mstep_diag"].as<bool>();
   }
   catch (YAML::Exception & error) {
     if (myid==0) std::cout << "Error parsing parameters in SlabSL: "
@@ -196,6 +215,11 @@ void SlabSL::determine_coefficients(void)
   //
   if (multistep) {
 
+    // Save the outgoing coefficients for higher-order interpolation
+    //
+    if (msinterp)
+      msinterp->push(mlevel, MultistepInterp::flatten(expccofL[mlevel]->data(), jmax), tnow);
+
     auto p = expccofL[mlevel];
   
     expccofL[mlevel] = expccofN[mlevel];
@@ -496,28 +520,14 @@ void SlabSL::dump_coefs_h5(const std::string& file)
 				// coefficients through the map
   *cur->coefs   = expccof[0];
 
-  // Check if file exists
+  // Copy the YAML config.  Only used when the file is created.
   //
-  if (std::filesystem::exists(file)) {
-    slabCoefs.clear();
-    slabCoefs.add(cur);
-    slabCoefs.ExtendH5Coefs(file);
-  }
-  // Otherwise, extend the existing HDF5 file
+  std::ostringstream sout; sout << conf;
+  cur->buf = sout.str();	// Copy to CoefStruct buffer
+
+  // Create or extend the HDF5 file
   //
-  else {
-    // Copy the YAML config.  We only need this on the first call.
-    std::ostringstream sout; sout << conf;
-    cur->buf = sout.str();	// Copy to CoefStruct buffer
-
-    // Add the name attribute.  We only need this on the first call.
-    slabCoefs.setName(component->name);
-
-    // And the new coefficients and write the new HDF5
-    slabCoefs.clear();
-    slabCoefs.add(cur);
-    slabCoefs.WriteH5Coefs(file);
-  }
+  AsyncWriter::instance().coefs(file, slabCoefs, cur);
 }
 
 void SlabSL::multistep_update_begin()
@@ -640,9 +650,16 @@ void SlabSL::compute_multistep_coefficients()
     double b = numer/denom;	// Interpolation weights
     double a = 1.0 - b;
 
-    for (int i=0; i<jmax; i++) {
-      expccof[0].data()[i] +=
-	a*expccofL[M]->data()[i] + b*expccofN[M]->data()[i] ;
+    if (msinterp) {
+      auto C = msinterp->combine(M, b,
+				 MultistepInterp::flatten(expccofL[M]->data(), jmax),
+				 MultistepInterp::flatten(expccofN[M]->data(), jmax));
+      MultistepInterp::addTo(C, expccof[0].data());
+    } else {
+      for (int i=0; i<jmax; i++) {
+	expccof[0].data()[i] +=
+	  a*expccofL[M]->data()[i] + b*expccofN[M]->data()[i] ;
+      }
     }
     
     // Sanity debug check
@@ -667,4 +684,6 @@ void SlabSL::compute_multistep_coefficients()
       expccof[0].data()[i] += expccofN[M]->data()[i];
     }
   }
+
+  if (msinterp) msinterp->report(tnow, mstep, mdrft);
 }
@@ -8,6 +8,7 @@
 #include <plummer.H>
 #include <interp.H>
 #include <exputils.H>
+#include <AsyncWriter.H>
 
 const std::set<std::string>
 Sphere::valid_keys = {
@@ -338,6 +339,11 @@ void Sphere::make_model_bin()
   // Regenerate Sturm-Liouville grid
   //
   std::string cachename = outdir  + cache_file;
+
+  // The new grid writes its HDF5 cache, so the coefficient writer
+  // thread must be idle
+  //
+  AsyncWriter::flushAll();
   
   if (logR) {
     Rmin = exp(Rmin);
@@ -489,6 +495,11 @@ void Sphere::make_model_plummer()
   // Regenerate Sturm-Liouville grid
   //
   std::string cachename = outdir  + cache_file;
+
+  // The new grid writes its HDF5 cache, so the coefficient writer
+  // thread must be idle
+  //
+  AsyncWriter::flushAll();
   ortho = std::make_shared<SLGridSph>(mod, Lmax, nmax, numr, Rmin, Rmax, false, 1, 1.0, cachename);
 
   // Test for basis consistency (will generate an exception if maximum
@@ -9,6 +9,7 @@
 
 #include <SphericalBasis.H>
 #include <MixtureBasis.H>
+#include <AsyncWriter.H>
 
 // #define TMP_DEBUG
 // #define MULTI_DEBUG
@@ -44,7 +45,10 @@ SphericalBasis::valid_keys = {
   "playback",
   "coefCompute",
   "coefMaster",
-  "orthocheck"
+  "orthocheck",
+  "nonblocking",
+  "mstep_order",
+  "mstep_diag"
 };
 
 SphericalBasis::SphericalBasis(Component* c0, const YAML::Node& conf, MixtureBasis *m) : 
@@ -83,6 +87,13 @@ SphericalBasis::SphericalBasis(Component* c0, const YAML::Node& conf, MixtureBas
   cuda_aware       = true;
 #endif
   ortho_check      = false;
+  nonblocking      = false;
+  mstep_order      = 1;
+  mstep_diag       = false;
+  red_pending      = false;
+  red_compute      = false;
+  red_level        = 0;
+  red_request      = MPI_REQUEST_NULL;
 
   // Remove matched keys
   //
@@ -198,6 +209,11 @@ SphericalBasis::SphericalBasis(Component* c0, const YAML::Node& conf, MixtureBas
     // END: playback config
 
     if (conf["orthocheck"]) ortho_check = conf["orthocheck"].as<bool>();
+
+    if (conf["nonblocking"]) nonblocking = conf["nonblocking"].as<bool>();
+
+    if (conf["mstep_order"]) mstep_order = conf["mstep_order"].as<int>();
+    if (conf["mstep_diag"])  mstep_diag  = conf["mstep_diag"].as<bool>();
   }
   catch (YAML::Exception & error) {
     if (myid==0) std::cout << "Error parsing parameters in SphericalBasis: "
@@ -246,6 +262,15 @@ SphericalBasis::SphericalBasis(Component* c0, const YAML::Node& conf, MixtureBas
       v->setZero();
     }
   }
+
+  // Higher-order interpolation of the inactive levels
+  //
+  if (multistep and mstep_order>1) {
+    std::string diagfile;
+    if (mstep_diag) diagfile = outdir + runtag + ".mstep_diag." + component->name;
+    msinterp = std::make_shared<MultistepInterp>(mstep_order, multistep+1,
+						 diagfile);
+  }
     
   expcoef .resize((Lmax+1)*(Lmax+1));
   expcoef1.resize((Lmax+1)*(Lmax+1));
@@ -276,6 +301,23 @@ SphericalBasis::SphericalBasis(Component* c0, const YAML::Node& conf, MixtureBas
     pthread_mutex_init(&cc_lock, NULL);
   }
 
+  // Per-thread EOF accumulators and column blocks
+  //
+  if (pcaeof) {
+    int Lsize = (Lmax+1)*(Lmax+2)/2;
+
+    tvar0.resize(nthrds);
+    wbuf .resize(nthrds);
+    wcnt .resize(nthrds, 0);
+
+    for (int n=0; n<nthrds; n++) {
+      tvar0[n].resize(Lsize);
+      wbuf [n].resize(Lsize);
+      for (auto & v : tvar0[n]) v = Eigen::MatrixXd::Zero(nmax, nmax);
+      for (auto & v : wbuf [n]) v.resize(nmax, pcaBlock);
+    }
+  }
+
   // Potential and deriv matrices
   //
   normM.resize(Lmax+1, nmax);
@@ -322,6 +364,11 @@ SphericalBasis::SphericalBasis(Component* c0, const YAML::Node& conf, MixtureBas
   firstime_coef  = true;
   firstime_accel = true;
 
+  // Attributes for HDF5 coefficient output
+  //
+  sphCoefs.setName(component->name);
+  sphCoefs.setH5Chunked(h5chunked, h5compress);
+
 #ifdef DEBUG
   pthread_mutex_init(&io_lock, NULL);
 #endif
@@ -444,12 +491,42 @@ void * SphericalBasis::determine_coefficients_thread(void * arg)
 				// subset of particles
   if (subset) nend = (int)floor(ssfrac*nend);
 
+				// On a jackknife step, visit the
+				// slice ordered by subsample so that
+				// consecutive particles share the
+				// subsample block
+  bool jk = compute and pcavar;
+  if (jk) {
+    auto & order = jkord[id];
+    order.clear();
+    for (int i=nbeg; i<nend; i++) {
+      int indx = component->levlist[mlevel][i];
+      order.push_back({indx % sampT, i});
+    }
+    std::sort(order.begin(), order.end());
+  }
+
   unsigned whch = 0;		// For PCA jacknife
 
-  for (int i=nbeg; i<nend; i++) {
+  Eigen::MatrixXd* wb = 0;	// Column block for the EOF update
+  if (compute and pcaeof) wb = wbuf[id].data();
+
+  Eigen::MatrixXd* jb = 0;	// Column block for the jackknife
+  if (jk) jb = jkbuf[id].data();
+
+  for (int q=0; q<nend-nbeg; q++) {
 
+    int i = jk ? jkord[id][q].second : nbeg + q;
     int indx = component->levlist[mlevel][i];
 
+    if (jk) {
+      whch = jkord[id][q].first;
+      if (whch != jkcur[id]) {
+	jk_flush(id);
+	jkcur[id] = whch;
+      }
+    }
+
     if (component->freeze(indx)) continue;
 
     
@@ -485,12 +562,7 @@ void * SphericalBasis::determine_coefficients_thread(void * arg)
 
       if (compute) {
 	muse1[id] += mass;
-	if (pcavar) {
-	  whch = indx % sampT;
-	  pthread_mutex_lock(&cc_lock);
-	  massT1[whch] += mass;
-	  pthread_mutex_unlock(&cc_lock);
-	}
+	if (pcavar) jkMb[id] += mass;
       }
 
       //		l loop
@@ -506,26 +578,15 @@ void * SphericalBasis::determine_coefficients_thread(void * arg)
 	      (*expcoef0[id][loffset+moffset])[n] += wk[n];
 	    }
 
-	    if (compute and pcavar) {
-	      pthread_mutex_lock(&cc_lock);
-	      for (int n=0; n<nmax; n++) {
-		(*expcoefT1[whch][iC])[n] += wk[n];
-		for (int o=0; o<nmax; o++)
-		  (*expcoefM1[whch][iC])(n, o) += wk[n]*wk[o]/mass;
-	      }
-	      pthread_mutex_unlock(&cc_lock);
-	    }
+	    Eigen::Map<Eigen::VectorXd> w(wk.data(), nmax);
 
-	    if (compute and pcaeof) {
-	      pthread_mutex_lock(&cc_lock);
-	      for (int n=0; n<nmax; n++) {
-		for (int o=0; o<nmax; o++) {
-		  (*tvar[iC])(n, o) += wk[n]*wk[o]/mass;
-		}
-	      }
-	      pthread_mutex_unlock(&cc_lock);
+	    if (jk) {
+	      jkTb[id].col(iC) += w;
+	      jb[iC].col(jkcnt[id]) = w/sqrt(mass);
 	    }
 
+	    if (compute and pcaeof) wb[iC].col(wcnt[id]) = w/sqrt(mass);
+
 	    iC++;
 	    moffset++;
 	  }
@@ -543,25 +604,18 @@ void * SphericalBasis::determine_coefficients_thread(void * arg)
 		(*expcoef0[id][loffset+moffset+1])[n] += wk[n]*fac2;
 	      }
 
-	      if (compute and pcavar) {
-		pthread_mutex_lock(&cc_lock);
-		for (int n=0; n<nmax; n++) {
-		  (*expcoefT1[whch][iC])[n] += wk[n]*facL;
-		  for (int o=0; o<nmax; o++)
-		    (*expcoefM1[whch][iC])(n, o) += wk[n]*wk[o]*facL*facL/mass;
-		}
-		pthread_mutex_unlock(&cc_lock);
+	      Eigen::Map<Eigen::VectorXd> w(wk.data(), nmax);
+
+	      if (jk) {
+		jkTb[id].col(iC) += w*facL;
+		jb[iC].col(jkcnt[id]) = w*facL/sqrt(mass);
 	      }
 	    
-	      if (compute and pcaeof) {
-		pthread_mutex_lock(&cc_lock);
-		for (int n=0; n<nmax; n++) {
-		  for (int o=0; o<nmax; o++) {
-		    (*tvar[iC])(n, o) += wk[n]*wk[o]/mass;
-		  }
-		}
-		pthread_mutex_unlock(&cc_lock);
-	      }
+	      if (compute and pcaeof) wb[iC].col(wcnt[id]) = w/sqrt(mass);
+	    }
+	    else {
+	      if (jk) jb[iC].col(jkcnt[id]).setZero();
+	      if (compute and pcaeof) wb[iC].col(wcnt[id]).setZero();
 	    }
 
 	    iC++;
@@ -572,16 +626,145 @@ void * SphericalBasis::determine_coefficients_thread(void * arg)
 
       } // l loop
 
+				// Flush a full block of EOF columns
+      if (compute and pcaeof and ++wcnt[id] == pcaBlock) pca_flush(id);
+
+				// Flush a full jackknife block
+      if (jk and ++jkcnt[id] == pcaBlock) jk_flush(id);
+
     } // r < rmax
 
   } // particle loop
 
+  if (jk) jk_flush(id);
+  if (compute and pcaeof) pca_flush(id);
+
   thread_timing_end(id);
 
   return (NULL);
 }
 
 
+void SphericalBasis::pca_flush(int id)
+{
+  if (wcnt[id]==0) return;
+
+  for (size_t iC=0; iC<tvar0[id].size(); iC++)
+    tvar0[id][iC].selfadjointView<Eigen::Lower>()
+      .rankUpdate(wbuf[id][iC].leftCols(wcnt[id]));
+
+  wcnt[id] = 0;
+}
+
+void SphericalBasis::jk_setup()
+{
+  int Lsize = (Lmax+1)*(Lmax+2)/2;
+
+  // Per-thread subsample covariances only if they are affordable
+  //
+  jkPrivate = sizeof(double)*nthrds*sampT*Lsize*nmax*nmax <= jkPrivateMax;
+
+  jkbuf.resize(nthrds);
+  jkTb .resize(nthrds);
+  jkMb .resize(nthrds, 0.0);
+  jkcnt.resize(nthrds, 0);
+  jkcur.resize(nthrds, 0);
+  jkord.resize(nthrds);
+
+  for (int n=0; n<nthrds; n++) {
+    jkbuf[n].resize(Lsize);
+    for (auto & v : jkbuf[n]) v.resize(nmax, pcaBlock);
+    jkTb[n] = Eigen::MatrixXd::Zero(nmax, Lsize);
+  }
+
+  if (jkPrivate) {
+    jkM   .resize(nthrds);
+    jkT   .resize(nthrds);
+    jkMass.resize(nthrds);
+    for (int n=0; n<nthrds; n++) {
+      jkM[n].resize(sampT);
+      for (auto & t : jkM[n]) {
+	t.resize(Lsize);
+	for (auto & v : t) v = Eigen::MatrixXd::Zero(nmax, nmax);
+      }
+      jkT[n].resize(sampT, Eigen::MatrixXd::Zero(nmax, Lsize));
+      jkMass[n].resize(sampT, 0.0);
+    }
+  } else {
+    jklock = std::make_unique<std::mutex[]>(sampT);
+  }
+}
+
+void SphericalBasis::jk_flush(int id)
+{
+  int k = jkcnt[id];
+
+  if (k) {
+    unsigned T = jkcur[id];
+
+    if (jkPrivate) {
+      for (size_t iC=0; iC<jkbuf[id].size(); iC++)
+	jkM[id][T][iC].selfadjointView<Eigen::Lower>()
+	  .rankUpdate(jkbuf[id][iC].leftCols(k));
+      jkT[id][T]    += jkTb[id];
+      jkMass[id][T] += jkMb[id];
+    } else {
+      std::lock_guard<std::mutex> lock(jklock[T]);
+      for (size_t iC=0; iC<jkbuf[id].size(); iC++) {
+	expcoefM1[T][iC]->selfadjointView<Eigen::Lower>()
+	  .rankUpdate(jkbuf[id][iC].leftCols(k));
+	*expcoefT1[T][iC] += jkTb[id].col(iC);
+      }
+      massT1[T] += jkMb[id];
+    }
+  }
+
+  jkTb[id].setZero();
+  jkMb[id]  = 0.0;
+  jkcnt[id] = 0;
+}
+
+void SphericalBasis::pca_merge()
+{
+  // Add the per-thread EOF variance and restore the full symmetric
+  // matrices from the lower triangles
+  //
+  if (pcaeof) {
+    for (size_t iC=0; iC<tvar.size(); iC++) {
+      for (int n=0; n<nthrds; n++) {
+	*tvar[iC] += Eigen::MatrixXd(tvar0[n][iC].selfadjointView<Eigen::Lower>());
+	tvar0[n][iC].setZero();
+      }
+    }
+  }
+
+  // Add the per-thread subsample sums
+  //
+  if (pcavar and jkPrivate) {
+    for (int n=0; n<nthrds; n++) {
+      for (unsigned T=0; T<sampT; T++) {
+	for (size_t iC=0; iC<expcoefM1[T].size(); iC++) {
+	  *expcoefM1[T][iC] += jkM[n][T][iC];
+	  *expcoefT1[T][iC] += jkT[n][T].col(iC);
+	  jkM[n][T][iC].setZero();
+	}
+	massT1[T] += jkMass[n][T];
+	jkT[n][T].setZero();
+	jkMass[n][T] = 0.0;
+      }
+    }
+  }
+
+  // The subsample covariances are only needed once the last level
+  // has been accumulated
+  //
+  if (pcavar and mlevel==multistep) {
+    for (auto & t : expcoefM1) {
+      for (auto & v : t) *v = v->selfadjointView<Eigen::Lower>();
+    }
+  }
+}
+
 void SphericalBasis::determine_coefficients(void)
 {
   if (play_back) {
@@ -672,6 +855,10 @@ void SphericalBasis::determine_coefficients_particles(void)
 
   start0 = std::chrono::high_resolution_clock::now();
 
+  // Complete a reduction still in flight from a previous call
+  //
+  finish_coefficients();
+
   // Return if we should leave the coefficients fixed
   //
   if (!self_consistent && !firstime_coef && !initializing) return;
@@ -684,7 +871,7 @@ void SphericalBasis::determine_coefficients_particles(void)
   }
 
 
-  int loffset, moffset, use1;
+  int use1;
 
   if (compute) {
 
@@ -718,6 +905,8 @@ void SphericalBasis::determine_coefficients_particles(void)
 	for (auto & v : t) v = std::make_shared<Eigen::MatrixXd>(nmax, nmax);
       }
 
+      if (pcavar) jk_setup();
+
     }
 
     // Zero arrays?
@@ -744,6 +933,14 @@ void SphericalBasis::determine_coefficients_particles(void)
   cout << "Process " << myid << ": in <determine_coefficients>" << endl;
 #endif
 
+  // Save the outgoing coefficients for higher-order interpolation
+  //
+  if (msinterp) {
+    Eigen::VectorXd L((Lmax+1)*(Lmax+1)*nmax);
+    pack_coefs(expcoefL[mlevel], L.data());
+    msinterp->push(mlevel, L, tnow);
+  }
+
   // Swap interpolation arrays
   //
   auto p = expcoefL[mlevel];
@@ -820,75 +1017,48 @@ void SphericalBasis::determine_coefficients_particles(void)
   for (int i=1; i<nthrds; i++) {
     for (int l=0; l<(Lmax+1)*(Lmax+1); l++) (*expcoef0[0][l]) += (*expcoef0[i][l]);
   }
+
+  if (compute) pca_merge();
   
   if (multistep==0 or tnow==resetT) {
     used += use1;
   }
   
-  for (int l=0, loffset=0; l<=Lmax; loffset+=(2*l+1), l++) {
-    
-    for (int m=0, moffset=0; m<=l; m++) {
-
-      if (m==0) {
-	  
-	if (multistep)
-	  MPI_Allreduce ( (*expcoef0[0][loffset+moffset]).data(),
-			  (*expcoefN[mlevel][loffset+moffset]).data(),
-			  nmax, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
-	else
-	  MPI_Allreduce ( (*expcoef0[0][loffset+moffset]).data(),
-			  (*expcoef[loffset+moffset]).data(),
-			  nmax, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
-	
-	moffset++;
-	  
-      } else {
-	
-	if (multistep) {
-	  MPI_Allreduce ( (*expcoef0[0][loffset+moffset]).data(),
-			  (*expcoefN[mlevel][loffset+moffset]).data(),
-			  nmax, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
-	  
-	  MPI_Allreduce ( (*expcoef0[0][loffset+moffset+1]).data(),
-			  (*expcoefN[mlevel][loffset+moffset+1]).data(),
-			  nmax, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
-	} else {
-	  MPI_Allreduce ( (*expcoef0[0][loffset+moffset]).data(),
-			  (*expcoef[loffset+moffset]).data(),
-			  nmax, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
-	  
-	  MPI_Allreduce ( (*expcoef0[0][loffset+moffset+1]).data(),
-			  (*expcoef[loffset+moffset+1]).data(),
-			  nmax, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
-	}
-	moffset+=2;
-      }
-    }
-  }
-  
   //======================================
-  // Last level?
+  // Pack the coefficients and, on the
+  // last level of a PCA step, the PCA
+  // accumulators for a single reduction
   //======================================
-  
-  if (mlevel==multistep) {
 
-    //======================================
-    // Multistep update
-    //======================================
+  unsigned csz = (Lmax+1)*(Lmax+1)*nmax, sz = csz;
 
-    if (multistep) compute_multistep_coefficients();
+  red_level   = mlevel;
+  red_compute = compute and mlevel==multistep;
 
-    //======================================
-    // PCA computation
-    //======================================
-    
-    if (compute) {
-      for (int i=0; i<nthrds; i++) muse0 += muse1[i];
-      MPI_Allreduce ( &muse0, &muse,  1, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
-      parallel_gather_coef2();
-    }
+  if (red_compute) sz += 1 + pca_pack_size();
+
+  if (pack.size() < sz) {
+    pack  .resize(sz);
+    unpack.resize(sz);
+  }
+
+  pack_coefs(expcoef0[0], pack.data());
 
-    pca_hall(compute);
+  if (red_compute) {
+    for (int i=0; i<nthrds; i++) muse0 += muse1[i];
+    pack[csz] = muse0;
+    pca_pack(&pack[csz+1]);
+  }
+
+  red_pending = true;
+
+  if (nonblocking) {
+    MPI_Iallreduce(pack.data(), unpack.data(), sz,
+		   MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD, &red_request);
+  } else {
+    MPI_Allreduce (pack.data(), unpack.data(), sz,
+		   MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+    finish_coefficients();
   }
 
   print_timings("SphericalBasis: coefficient timings");
@@ -912,6 +1082,61 @@ void SphericalBasis::determine_coefficients_particles(void)
   }
 #endif
 
+  firstime_coef = false;
+}
+
+void SphericalBasis::pack_coefs(const std::vector<VectorXdP>& src, double* buf)
+{
+  for (int l=0; l<(Lmax+1)*(Lmax+1); l++)
+    buf = std::copy(src[l]->data(), src[l]->data() + nmax, buf);
+}
+
+void SphericalBasis::unpack_coefs(const double* buf,
+				  std::vector<VectorXdP>& dst, bool add)
+{
+  for (int l=0; l<(Lmax+1)*(Lmax+1); l++, buf+=nmax) {
+    Eigen::Map<const Eigen::VectorXd> v(buf, nmax);
+    if (add) *dst[l] += v;
+    else     *dst[l]  = v;
+  }
+}
+
+void SphericalBasis::finish_coefficients()
+{
+  if (not red_pending) return;
+
+  if (nonblocking) MPI_Wait(&red_request, MPI_STATUS_IGNORE);
+  red_pending = false;
+
+  if (multistep)
+    unpack_coefs(unpack.data(), expcoefN[red_level]);
+  else
+    unpack_coefs(unpack.data(), expcoef);
+
+  //======================================
+  // Last level?
+  //======================================
+  
+  if (red_level != multistep) return;
+
+  //======================================
+  // Multistep update
+  //======================================
+
+  if (multistep) compute_multistep_coefficients();
+
+  //======================================
+  // PCA computation
+  //======================================
+    
+  if (red_compute) {
+    unsigned csz = (Lmax+1)*(Lmax+1)*nmax;
+    muse = unpack[csz];
+    pca_unpack(&unpack[csz+1]);
+  }
+
+  pca_hall(compute);
+
   //================================
   // Dump coefficients for debugging
   //================================
@@ -919,7 +1144,7 @@ void SphericalBasis::determine_coefficients_particles(void)
   //  +--- Deep debugging. Set to 'false' for production.
   //  |
   //  v
-  if (false and myid==0 and mstep==0 and mlevel==multistep) {
+  if (false and myid==0 and mstep==0) {
 
     std::cout << std::string(60, '-') << std::endl
 	      << "-- SphericalBasis T=" << std::setw(16) << tnow << std::endl
@@ -958,8 +1183,6 @@ void SphericalBasis::determine_coefficients_particles(void)
     }
     std::cout << std::string(60, '-') << std::endl;
   }
-
-  firstime_coef = false;
 }
 
 void SphericalBasis::multistep_reset()
@@ -995,6 +1218,10 @@ void SphericalBasis::multistep_update_finish()
 {
   if (play_back and not play_cnew) return;
 
+				// The reduction buffers are shared
+				// with the coefficient reduction
+  finish_coefficients();
+
 				// Combine the update matricies
 				// from all nodes
   unsigned sz = (multistep - mfirst[mdrft] + 1)*(Lmax+1)*(Lmax+1)*nmax;
@@ -1030,13 +1257,7 @@ void SphericalBasis::multistep_update_finish()
 
     unsigned offset0 = (M - mfirst[mdrft])*(Lmax+1)*(Lmax+1)*nmax;
 
-    for (int l=0; l<=Lmax*(Lmax+2); l++) {
-
-      unsigned offset1 = l*nmax;
-
-      for (int ir=0; ir<nmax; ir++)
-	(*expcoefN[M][l])[ir] += unpack[offset0+offset1+ir];
-    }
+    unpack_coefs(&unpack[offset0], expcoefN[M], true);
   }
 
   //  +--- Deep debugging
@@ -1218,10 +1439,18 @@ void SphericalBasis::compute_multistep_coefficients()
     double b = numer/denom;	// Interpolation weights
     double a = 1.0 - b;
 
-    for (int l=0; l<=Lmax*(Lmax+2); l++) {
-      for (int n=0; n<nmax; n++) {
-	(*expcoef[l])[n] += a*(*expcoefL[M][l])[n] + b*(*expcoefN[M][l])[n];
-	if (l==0 and n==1) saveF += a*(*expcoefL[M][l])[n] + b*(*expcoefN[M][l])[n];
+    if (msinterp) {
+      Eigen::VectorXd L((Lmax+1)*(Lmax+1)*nmax), N(L.size());
+      pack_coefs(expcoefL[M], L.data());
+      pack_coefs(expcoefN[M], N.data());
+      Eigen::VectorXd C = msinterp->combine(M, b, L, N);
+      unpack_coefs(C.data(), expcoef, true);
+    } else {
+      for (int l=0; l<=Lmax*(Lmax+2); l++) {
+	for (int n=0; n<nmax; n++) {
+	  (*expcoef[l])[n] += a*(*expcoefL[M][l])[n] + b*(*expcoefN[M][l])[n];
+	  if (l==0 and n==1) saveF += a*(*expcoefL[M][l])[n] + b*(*expcoefN[M][l])[n];
+	}
       }
     }
     
@@ -1293,6 +1522,8 @@ void SphericalBasis::compute_multistep_coefficients()
     }
   }
 
+  if (msinterp) msinterp->report(tnow, mstep, mdrft);
+
   //  +--- Deep debugging
   //  |
   //  v
@@ -1436,18 +1667,6 @@ void SphericalBasis::compute_multistep_coefficients()
 
 void * SphericalBasis::determine_acceleration_and_potential_thread(void * arg)
 {
-  // Density basis is 4piG times physical density
-  //
-  double dfac=0.25/M_PI;
-
-  // Local variables
-  //
-  double r0=0.0, dp;
-  double potr, potl, pott, potp, p, pc, dpc, ps, dps, facp, facdp;
-
-  double pos[3];
-  double xx, yy, zz, mfactor=1.0;
-
   vector<double> ctr;
   if (mix) mix->getCenter(ctr);
 
@@ -1481,143 +1700,204 @@ void * SphericalBasis::determine_acceleration_and_potential_thread(void * arg)
 
       if (cC->freeze(indx)) continue;
 
-      if (mix) {
-	if (use_external) {
-	  cC->Pos(pos, indx, Component::Inertial);
-	  component->ConvertPos(pos, Component::Local);
-	} else
-	  cC->Pos(pos, indx, Component::Local);
-
-	mfactor = mix->Mixture(pos);
-	xx = pos[0] - ctr[0];
-	yy = pos[1] - ctr[1];
-	zz = pos[2] - ctr[2];
-      } else {
-	if (use_external) {
-	  cC->Pos(pos, indx, Component::Inertial);
-	  component->ConvertPos(pos, Component::Local | Component::Centered);
-	} else
-	  cC->Pos(pos, indx, Component::Local | Component::Centered);
+      accel_particle(indx, id, ctr);
+    }
+
+  }
+
+  thread_timing_end(id);
+
+  return (NULL);
+}
+
+
+void SphericalBasis::accel_particle(int indx, int id,
+				    const std::vector<double>& ctr)
+{
+  double r0=0.0, dp;
+  double potr, potl, pott, potp, p, pc, dpc, ps, dps, facp, facdp;
+
+  double pos[3];
+  double xx, yy, zz, mfactor=1.0;
+
+  if (mix) {
+    if (use_external) {
+      cC->Pos(pos, indx, Component::Inertial);
+      component->ConvertPos(pos, Component::Local);
+    } else
+      cC->Pos(pos, indx, Component::Local);
+
+    mfactor = mix->Mixture(pos);
+    xx = pos[0] - ctr[0];
+    yy = pos[1] - ctr[1];
+    zz = pos[2] - ctr[2];
+  } else {
+    if (use_external) {
+      cC->Pos(pos, indx, Component::Inertial);
+      component->ConvertPos(pos, Component::Local | Component::Centered);
+    } else
+      cC->Pos(pos, indx, Component::Local | Component::Centered);
 	
-	xx = pos[0];
-	yy = pos[1];
-	zz = pos[2];
-      }	
+    xx = pos[0];
+    yy = pos[1];
+    zz = pos[2];
+  }	
 
-      double r = sqrt(xx*xx + yy*yy + zz*zz) + DSMALL;
-      double costh = zz/r;
-      double rs = r/scale;
-      double phi = atan2(yy, xx);
+  double r = sqrt(xx*xx + yy*yy + zz*zz) + DSMALL;
+  double costh = zz/r;
+  double rs = r/scale;
+  double phi = atan2(yy, xx);
 
-      dlegendre_R (Lmax, costh, legs[id], dlegs[id]);
-      sinecosine_R(Lmax, phi,   cosm[id], sinm [id]);
+  dlegendre_R (Lmax, costh, legs[id], dlegs[id]);
+  sinecosine_R(Lmax, phi,   cosm[id], sinm [id]);
 
-      int ioff = 0;
-      if (r>rmax) {
-	ioff = 1;
-	r0   = r;
-	r    = rmax;
-	rs   = r/scale;
-      }
+  int ioff = 0;
+  if (r>rmax) {
+    ioff = 1;
+    r0   = r;
+    r    = rmax;
+    rs   = r/scale;
+  }
 
-      // Zero coefficient accumulated field values
-      //
-      potl = potr = pott = potp = 0.0;
+  // Zero coefficient accumulated field values
+  //
+  potl = potr = pott = potp = 0.0;
       
-      get_dpotl(Lmax, nmax, rs, potd[id], dpot[id], id);
+  get_dpotl(Lmax, nmax, rs, potd[id], dpot[id], id);
 
-      if (!NO_L0) {
-	get_pot_coefs_safe(0, *expcoef[0], p, dp, potd[id], dpot[id]);
-	if (ioff) {
-	  p *= rmax/r0;
-	  dp = -p/r0;
-	}
-	double facL = mfactor * factorial(0, 0);
-	potl = facL * p;
-	potr = facL * dp;
-      }
+  if (!NO_L0) {
+    get_pot_coefs_safe(0, *expcoef[0], p, dp, potd[id], dpot[id]);
+    if (ioff) {
+      p *= rmax/r0;
+      dp = -p/r0;
+    }
+    double facL = mfactor * factorial(0, 0);
+    potl = facL * p;
+    potr = facL * dp;
+  }
       
-      //		l loop
-      //		------
-      for (int l=1, loffset=1; l<=Lmax; loffset+=(2*l+1), l++) {
+  //		l loop
+  //		------
+  for (int l=1, loffset=1; l<=Lmax; loffset+=(2*l+1), l++) {
 
-				// Suppress L=1 terms?
-	if (NO_L1 && l==1) continue;
+			    // Suppress L=1 terms?
+    if (NO_L1 && l==1) continue;
 	
-				// Suppress odd L terms?
-	if (EVEN_L && (l/2)*2 != l) continue;
+			    // Suppress odd L terms?
+    if (EVEN_L && (l/2)*2 != l) continue;
 
-	//		m loop
-	//		------
-	for (int m=0, moffset=0; m<=l; m++) {
+    //		m loop
+    //		------
+    for (int m=0, moffset=0; m<=l; m++) {
 	  
-	  double facL = factorial(l, m) *  legs[id](l, m) * mfactor;
-	  double facD = factorial(l, m) * dlegs[id](l, m) * mfactor;
+      double facL = factorial(l, m) *  legs[id](l, m) * mfactor;
+      double facD = factorial(l, m) * dlegs[id](l, m) * mfactor;
 
-				// Suppress odd M terms?
-	  if (EVEN_M && (m/2)*2 != m) continue;
+			    // Suppress odd M terms?
+      if (EVEN_M && (m/2)*2 != m) continue;
 
-				// Suppress all asymmetric terms
-	  if (M0_only and m!=0) continue;
+			    // Suppress all asymmetric terms
+      if (M0_only and m!=0) continue;
 
-	  if (m==0) {
-	    get_pot_coefs_safe(l, *expcoef[loffset+moffset], p, dp,
-			       potd[id], dpot[id]);
-	    if (ioff) {
-	      p *= pow(rmax/r0,(double)(l+1));
-	      dp = -p/r0 * (l+1);
-	    }
-	    potl += facL * p;
-	    potr += facL * dp;
-	    pott += facD * p;
-	    moffset++;
-	  }
-	  else {
-	    get_pot_coefs_safe(l, *expcoef[loffset+moffset], pc, dpc,
-			       potd[id], dpot[id]);
-
-	    get_pot_coefs_safe(l, *expcoef[loffset+moffset+1], ps, dps,
-			       potd[id], dpot[id]);
-	    if (ioff) {		// Factors for external multipole solution
-	      facp  = pow(rmax/r0,(double)(l+1));
-	      facdp = -1.0/r0 * (l+1);
-				// Apply the factors
-	      pc   *= facp;
-	      ps   *= facp;
-	      dpc   = pc * facdp;
-	      dps   = ps * facdp;
-	    }
-	    potl += facL * (pc *cosm[id][m] + ps *sinm[id][m] );
-	    potr += facL * (dpc*cosm[id][m] + dps*sinm[id][m] );
-	    pott += facD * (pc *cosm[id][m] + ps *sinm[id][m] );
-	    potp += facL * (-pc*sinm[id][m] + ps *cosm[id][m] )*m;
-	    moffset +=2;
-	  }
+      if (m==0) {
+	get_pot_coefs_safe(l, *expcoef[loffset+moffset], p, dp,
+			   potd[id], dpot[id]);
+	if (ioff) {
+	  p *= pow(rmax/r0,(double)(l+1));
+	  dp = -p/r0 * (l+1);
+	}
+	potl += facL * p;
+	potr += facL * dp;
+	pott += facD * p;
+	moffset++;
+      }
+      else {
+	get_pot_coefs_safe(l, *expcoef[loffset+moffset], pc, dpc,
+			   potd[id], dpot[id]);
+
+	get_pot_coefs_safe(l, *expcoef[loffset+moffset+1], ps, dps,
+			   potd[id], dpot[id]);
+	if (ioff) {		// Factors for external multipole solution
+	  facp  = pow(rmax/r0,(double)(l+1));
+	  facdp = -1.0/r0 * (l+1);
+			    // Apply the factors
+	  pc   *= facp;
+	  ps   *= facp;
+	  dpc   = pc * facdp;
+	  dps   = ps * facdp;
 	}
+	potl += facL * (pc *cosm[id][m] + ps *sinm[id][m] );
+	potr += facL * (dpc*cosm[id][m] + dps*sinm[id][m] );
+	pott += facD * (pc *cosm[id][m] + ps *sinm[id][m] );
+	potp += facL * (-pc*sinm[id][m] + ps *cosm[id][m] )*m;
+	moffset +=2;
       }
+    }
+  }
 
-      double fac = xx*xx + yy*yy;
+  double fac = xx*xx + yy*yy;
 
-      potr /= scale*scale;
-      potl /= scale;
-      pott /= scale;
-      potp /= scale;
+  potr /= scale*scale;
+  potl /= scale;
+  pott /= scale;
+  potp /= scale;
 
-      cC->AddAcc(indx, 0, -(potr*xx/r - pott*xx*zz/(r*r*r)) );
-      cC->AddAcc(indx, 1, -(potr*yy/r - pott*yy*zz/(r*r*r)) );
-      cC->AddAcc(indx, 2, -(potr*zz/r + pott*fac/(r*r*r))   );
-      if (fac > DSMALL) {
-	cC->AddAcc(indx, 0,  potp*yy/fac );
-	cC->AddAcc(indx, 1, -potp*xx/fac );
-      }
-      cC->AddPot(indx, potl);
+  cC->AddAcc(indx, 0, -(potr*xx/r - pott*xx*zz/(r*r*r)) );
+  cC->AddAcc(indx, 1, -(potr*yy/r - pott*yy*zz/(r*r*r)) );
+  cC->AddAcc(indx, 2, -(potr*zz/r + pott*fac/(r*r*r))   );
+  if (fac > DSMALL) {
+    cC->AddAcc(indx, 0,  potp*yy/fac );
+    cC->AddAcc(indx, 1, -potp*xx/fac );
+  }
+  cC->AddPot(indx, potl);
+}
+
+
+void SphericalBasis::batch_begin(Component* C)
+{
+  cC = C;
+  nbodies = cC->Number();
+
+  if (NOISE) update_noise();
+
+  MPL_start_timer();
+
+  finish_coefficients();
+
+  if (play_back) {
+    swap_coefs(expcoefP, expcoef);
+  }
+
+  if (use_external == false) {
+
+    if (multistep && (self_consistent || initializing)) {
+      compute_multistep_coefficients();
     }
 
   }
 
-  thread_timing_end(id);
+  if (mix) mix->getCenter(bctr);
+}
 
-  return (NULL);
+
+void SphericalBasis::batch_eval(const int* indx, int n, int id)
+{
+  for (int i=0; i<n; i++) {
+    if (cC->freeze(indx[i])) continue;
+    accel_particle(indx[i], id, bctr);
+  }
+}
+
+
+void SphericalBasis::batch_end()
+{
+  if (play_back) {
+    swap_coefs(expcoef, expcoefP);
+  }
+
+  MPL_stop_timer();
+
+  use_external = false;
 }
 
 
@@ -1634,6 +1914,8 @@ void SphericalBasis::determine_acceleration_and_potential(void)
   cout << "Process " << myid << ": in determine_acceleration_and_potential\n";
 #endif
 
+  finish_coefficients();
+
   if (play_back) {
     swap_coefs(expcoefP, expcoef);
   }
@@ -1781,6 +2063,8 @@ void SphericalBasis::get_dens_coefs(int l, Eigen::VectorXd& coef, double& p)
 
 void SphericalBasis::dump_coefs(ostream& out)
 {
+  finish_coefficients();
+
   if (NewCoefs) {
 
     // This is a node of simple {key: value} pairs.  More general
@@ -1861,6 +2145,8 @@ void SphericalBasis::dump_coefs(ostream& out)
 
 void SphericalBasis::dump_coefs_h5(const std::string& file)
 {
+  finish_coefficients();
+
   // Add the current coefficients
   auto cur = std::make_shared<CoefClasses::SphStruct>();
 
@@ -1895,28 +2181,14 @@ void SphericalBasis::dump_coefs_h5(const std::string& file)
   //
   cur->ctr = component->getCenter(Component::Local | Component::Centered);
 
-  // Check if file exists
-  //
-  if (std::filesystem::exists(file)) {
-    sphCoefs.clear();
-    sphCoefs.add(cur);
-    sphCoefs.ExtendH5Coefs(file);
-  }
-  // Otherwise, extend the existing HDF5 file
+  // Copy the YAML config.  Only used when the file is created.
   //
-  else {
-    // Copy the YAML config.  We only need this on the first call.
-    std::ostringstream sout; sout << conf;
-    cur->buf = sout.str();	// Copy to CoefStruct buffer
-
-    // Add the name attribute.  We only need this on the first call.
-    sphCoefs.setName(component->name);
+  std::ostringstream sout; sout << conf;
+  cur->buf = sout.str();	// Copy to CoefStruct buffer
 
-    // And the new coefficients and write the new HDF5
-    sphCoefs.clear();
-    sphCoefs.add(cur);
-    sphCoefs.WriteH5Coefs(file);
-  }
+  // Create or extend the HDF5 file
+  //
+  AsyncWriter::instance().coefs(file, sphCoefs, cur);
 }
 
 
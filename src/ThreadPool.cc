@@ -0,0 +1,155 @@
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+#include "expand.H"
+#include <ThreadPool.H>
+
+std::unique_ptr<ThreadPool> ThreadPool::pool;
+
+// Set in each worker so that nested calls can be detected, along
+// with the worker id of the current thread
+//
+static thread_local bool in_worker = false;
+static thread_local int  worker_id = 0;
+
+ThreadPool::ThreadPool(int n)
+{
+  for (int id=1; id<n; id++)
+    workers.emplace_back(&ThreadPool::worker, this, id);
+}
+
+ThreadPool::~ThreadPool()
+{
+  {
+    std::lock_guard<std::mutex> lock(mtx);
+    stop = true;
+  }
+  cv_work.notify_all();
+
+  for (auto & t : workers) t.join();
+}
+
+ThreadPool& ThreadPool::instance()
+{
+  if (not pool) pool = std::make_unique<ThreadPool>(std::max<int>(nthrds, 1));
+  return *pool;
+}
+
+bool ThreadPool::inWorker()
+{
+  return in_worker;
+}
+
+void ThreadPool::execute(const std::function<void(int)>& func, int id)
+{
+  try {
+    func(id);
+  }
+  catch (...) {
+    std::lock_guard<std::mutex> lock(mtx);
+    if (not error) error = std::current_exception();
+  }
+}
+
+void ThreadPool::worker(int id)
+{
+  in_worker = true;
+  worker_id = id;
+
+  unsigned seen = 0;
+
+  while (true) {
+    const std::function<void(int)>* func;
+    {
+      std::unique_lock<std::mutex> lock(mtx);
+      cv_work.wait(lock, [&]{ return stop or generation != seen; });
+      if (stop) return;
+      seen = generation;
+      func = task;
+    }
+
+    execute(*func, id);
+
+    {
+      std::lock_guard<std::mutex> lock(mtx);
+      if (--pending == 0) cv_done.notify_one();
+    }
+  }
+}
+
+void ThreadPool::run(const std::function<void(int)>& func)
+{
+  // A nested call cannot replay every id on this worker: per-thread
+  // scratch indexed by id would alias the other workers' entries
+  //
+  if (in_worker)
+    throw std::runtime_error("ThreadPool::run: nested call from worker "
+			     + std::to_string(worker_id)
+			     + "; use parallel_for");
+
+  // Serial execution for a single thread
+  //
+  if (workers.size()==0) {
+    for (int id=0; id<size(); id++) func(id);
+    return;
+  }
+
+  // Wake the workers
+  //
+  {
+    std::lock_guard<std::mutex> lock(mtx);
+    task    = &func;
+    pending = workers.size();
+    error   = nullptr;
+    generation++;
+  }
+  cv_work.notify_all();
+
+  // The caller is worker 0
+  //
+  in_worker = true;
+  execute(func, 0);
+  in_worker = false;
+
+  // Wait for the rest
+  //
+  std::exception_ptr err;
+  {
+    std::unique_lock<std::mutex> lock(mtx);
+    cv_done.wait(lock, [&]{ return pending == 0; });
+    task = nullptr;
+    std::swap(err, error);
+  }
+
+  if (err) std::rethrow_exception(err);
+}
+
+void ThreadPool::parallel_for
+(size_t n, size_t chunk, const std::function<void(size_t, size_t, int)>& func)
+{
+  if (n==0) return;
+
+  // Default chunk: roughly eight blocks per worker, but not so small
+  // that the atomic counter becomes the bottleneck
+  //
+  if (chunk==0) chunk = std::max<size_t>(64, n/(8*size()) + 1);
+
+  // A nested call does the whole loop on the calling worker with its
+  // own id
+  //
+  if (in_worker) {
+    for (size_t beg=0; beg<n; beg+=chunk)
+      func(beg, std::min<size_t>(beg+chunk, n), worker_id);
+    return;
+  }
+
+  std::atomic<size_t> next(0);
+
+  run([&](int id) {
+    size_t beg;
+    while ((beg = next.fetch_add(chunk)) < n) {
+      func(beg, std::min<size_t>(beg+chunk, n), id);
+    }
+  });
+}
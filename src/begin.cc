@@ -48,13 +48,6 @@ void begin_run(void)
     exit(115);
   }
 
-  //===================================
-  // Make the kick/drift thread vectors
-  //===================================
-  
-  posvel_data = vector<thrd_pass_posvel>(nthrds);
-  posvel_thrd = vector<pthread_t>       (nthrds);
-
   //==============================
   // Initialize multistepping
   //==============================
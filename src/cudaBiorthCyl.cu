@@ -272,7 +272,7 @@ void BiorthCyl::initialize_cuda
     for (int mm=0; mm<=mmax; mm++) {
       for (size_t n=0; n<nmax; n++) {
 	
-	std::vector<Eigen::MatrixXd*> orig =
+	std::vector<GridMat*> orig =
 	  {&pot[mm][n], &rforce[mm][n], &zforce[mm][n]};
 
 	int kmax = 3;
@@ -1118,5 +1118,9 @@ void Component::MakeLevlist()
 {
   levlist.resize(multistep+1);
   for (auto & v : levlist) v.clear();
-  for (auto & v : particles) levlist[v.second->level].push_back(v.first);
+  for (auto & v : particles) {
+    auto & l = levlist[v.second->level];
+    v.second->levslot = l.size();
+    l.push_back(v.first);
+  }
 }
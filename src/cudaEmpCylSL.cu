@@ -176,7 +176,7 @@ void EmpCylSL::initialize_cuda
     for (int mm=0; mm<=MMAX; mm++) {
       for (size_t n=0; n<rank3; n++) {
 	
-	std::vector<Eigen::MatrixXd*> orig =
+	std::vector<GridMat*> orig =
 	  {&potC[mm][n], &rforceC[mm][n], &zforceC[mm][n],
 	   &potS[mm][n], &rforceS[mm][n], &zforceS[mm][n]};
 
@@ -8,6 +8,8 @@
 #include <global.H>
 #include <OutputContainer.H>
 #include <ExternalCollection.H>
+#include <AsyncWriter.H>
+#include <NodeShared.H>
 
 #include <sys/types.h>
 #include <unistd.h>
@@ -18,6 +20,8 @@ void clean_up(void)
   output->Run(this_step, 0, true);
 				// Cache for restart
   external->finish();
+				// Drain the background writer
+  AsyncWriter::flushAll();
 
   MPI_Barrier(MPI_COMM_WORLD);
 
@@ -49,6 +53,9 @@ void clean_up(void)
   delete external;
   delete comp;
 
+				// Free the node-shared basis tables
+  NodeShared::finalize();
+
   //===================================
   // Shutdown MPI
   //===================================
@@ -82,17 +82,6 @@ int cudaGlobalDevice;
 #endif
 
 
-				// Multithreading data structures for
-				// incr_position and incr_velocity
-/*struct thrd_pass_posvel 
-{
-  double dt;
-  int mlevel;
-  int id;
-};*/
-
-vector<thrd_pass_posvel> posvel_data;
-vector<pthread_t> posvel_thrd;
 int is_init=1;
 
 				// List of host names and ranks
@@ -139,6 +128,10 @@ bool fpe_wait      = false;
 bool traceback     = false;
 
 bool ignore_info   = false;
+bool restart_mpiio = true;
+bool async_output  = false;
+bool fuse_interactions = false;
+int  async_depth   = 32;
 bool all_couples   = true;
 
 int  rlimit_val    = 0;
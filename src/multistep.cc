@@ -3,10 +3,12 @@
 */
 
 #include <expand.H>
+#include <ThreadPool.H>
 #include <sstream>
 #include <chrono>
 #include <limits>
 #include <map>
+#include <cmath>
 
 // #define VERBOSE_TIMING
 
@@ -17,21 +19,6 @@ extern void cuda_initialize_multistep();
 extern void cuda_compute_levels();
 #endif
 
-//
-// Helper class to pass info to threaded multistep update routine
-//
-struct thrd_pass_sync 
-{
-  //! Level
-  int level;
-
-  //! Thread counter id
-  int id;
-
-  //! Component
-  Component *c;
-};
-
 //
 // Count offgrid particles in the threads
 //
@@ -43,91 +30,169 @@ static std::vector< double > adjtm2;
 static std::vector< unsigned> numsw;
 static std::vector< unsigned> numtt;
 
-// Type counter
-static std::vector< std::vector< std::vector<unsigned> > > tmdt;
+// Type counter: per thread, flattened as [level*mdtDim + criterion]
+static ThreadScratch< std::vector<unsigned> > tmdt;
 
 //
-// The threaded routine
+// Per-thread work arrays for the timestep kernel.  These grow to the
+// largest block seen and are then reused, so the particle loop does
+// no allocation after the first call.
 //
-void * adjust_multistep_level_thread(void *ptr)
+struct TimestepScratch
 {
-  // Begin diagnostic timing
-  std::chrono::high_resolution_clock::time_point start0, finish0;
+  std::vector<Particle*> part;
+  std::vector<double> vdota, v2, a2, phi, rscl, dt;
+  std::vector<int> crit;
+
+  void resize(size_t n)
+  {
+    if (part.size() >= n) return;
+    part. resize(n);
+    vdota.resize(n);
+    v2.   resize(n);
+    a2.   resize(n);
+    phi.  resize(n);
+    rscl. resize(n);
+    dt.   resize(n);
+    crit. resize(n);
+  }
+};
 
-  start0 = std::chrono::high_resolution_clock::now();
+static ThreadScratch<TimestepScratch> tscr;
+
+//
+// Smallest of the five timestep criteria and the criterion that set
+// it, for n particles in structure-of-arrays form.  The criterion
+// index order (0=drift, 1=force, 2=size, 3=work, 4=escape) is the one
+// reported in the level histogram.  On ties the higher index wins.
+// The work and escape criteria only count when positive.
+//
+static void timestep_kernel(size_t n,
+			    const double* __restrict__ vdota,
+			    const double* __restrict__ v2,
+			    const double* __restrict__ a2,
+			    const double* __restrict__ phi,
+			    const double* __restrict__ rscl,
+			    double* __restrict__ dtmin,
+			    int*    __restrict__ crit)
+{
+  //
+  // Small positive constant
+  //
+  const double eps = 1.0e-10;
+
+#pragma omp simd
+  for (size_t i=0; i<n; i++) {
 
-  // Level
-  int level = static_cast<thrd_pass_sync*>(ptr)->level;
+    // dtd = eps* rscale/v_i    -- char. drift time scale
+    // dtv = eps* min(v_i/a_i)  -- char. force time scale
+    // dts = eps* scale/v_i     -- char. particle size time scale
+    // dta = eps* phi/(v * a)   -- char. work time scale
+    // dtA = eps* sqrt(phi/a^2) -- char. "escape" time scale
+    
+    double dtd = dynfracD * 1.0/sqrt(v2[i]+eps);
+    double dtv = dynfracV * sqrt(v2[i]/(a2[i]+eps));
+    double dts = dynfracS*rscl[i]/fabs(sqrt(v2[i])+eps);
+    double dta = dynfracA * phi[i]/(fabs(vdota[i])+eps);
+    double dtA = dynfracP * sqrt(phi[i]/(a2[i]+eps));
+
+    // Selects rather than branches so the loop vectorizes
+    //
+    dts = rscl[i] > 0.0 ? dts : 1.0/eps;
+
+    double dt = dtd;
+    int    k  = 0;
+    bool   b;
+
+    b  = dtv <= dt;
+    k  = b ? 1   : k;
+    dt = b ? dtv : dt;
+
+    b  = dts <= dt;
+    k  = b ? 2   : k;
+    dt = b ? dts : dt;
+
+    b  = (dta > 0.0) & (dta <= dt);
+    k  = b ? 3   : k;
+    dt = b ? dta : dt;
 
-  // Thread ID
-  int   id = static_cast<thrd_pass_sync*>(ptr)->id;
+    b  = (dtA > 0.0) & (dtA <= dt);
+    k  = b ? 4   : k;
+    dt = b ? dtA : dt;
 
-  // Component
-  Component *c = static_cast<thrd_pass_sync*>(ptr)->c;
+    dtmin[i] = dt;
+    crit [i] = k;
+  }
+}
+
+//
+// The threaded routine: called by the pool for each block
+// [nbeg, nend) of the level list
+//
+static void adjust_multistep_level_thread
+(Component *c, int level, size_t nbeg, size_t nend, int id)
+{
+  // Begin diagnostic timing
+  std::chrono::high_resolution_clock::time_point start0, finish0;
+
+  start0 = std::chrono::high_resolution_clock::now();
 
   // Examine all time steps at or below this level and compute timestep
   // criterion and adjust level if necessary
 
-  double dt, dts, dtv, dta, dtA, dtd, dtr, dsr, rtot, vtot, atot, ptot;
-  int npart = c->levlist[level].size();
   int offlo = 0, offhi = 0;
 
-  //
-  // Compute the beginning and end points for threads
-  //
-  int nbeg = npart*id    /nthrds;
-  int nend = npart*(id+1)/nthrds;
-
   //
   // Small positive constant
   //
   const double eps = 1.0e-10;
 
   //
-  // The particle loop
+  // Gather the phase space for this block into contiguous arrays
   //
-  for (int i=nbeg; i<nend; i++) {
+  size_t npart = nend - nbeg;
+  TimestepScratch & S = tscr[id];
+  S.resize(npart);
 
-    int n = c->levlist[level][i];
-    Particle *p = c->Part(n);
+  for (size_t i=0; i<npart; i++) {
 
-    // dtd = eps* rscale/v_i    -- char. drift time scale
-    // dtv = eps* min(v_i/a_i)  -- char. force time scale
-    // dta = eps* phi/(v * a)   -- char. work time scale
-    // dtA = eps* sqrt(phi/a^2) -- char. "escape" time scale
-    
-    dtr  = 0.0;
-    vtot = 0.0;
-    atot = 0.0;
+    Particle *p = c->Part(c->levlist[level][nbeg+i]);
+
+    double dtr = 0.0, vtot = 0.0, atot = 0.0;
 
     for (int k=0; k<c->dim; k++) {
       dtr  += p->vel[k]*p->acc[k];
       vtot += p->vel[k]*p->vel[k];
       atot += p->acc[k]*p->acc[k];
     }
-    ptot = fabs(p->pot + p->potext);
 
+    S.part [i] = p;
+    S.vdota[i] = dtr;
+    S.v2   [i] = vtot;
+    S.a2   [i] = atot;
+    S.phi  [i] = fabs(p->pot + p->potext);
+    S.rscl [i] = p->scale;
+  }
 
-    dsr = p->scale;
-    if (dsr>0) dts = dynfracS*dsr/fabs(sqrt(vtot)+eps);
-    else       dts = 1.0/eps;
-    
-    dtd = dynfracD * 1.0/sqrt(vtot+eps);
-    dtv = dynfracV * sqrt(vtot/(atot+eps));
-    dta = dynfracA * ptot/(fabs(dtr)+eps);
-    dtA = dynfracP * sqrt(ptot/(atot+eps));
+  //
+  // Timestep criteria for the whole block
+  //
+  timestep_kernel(npart, S.vdota.data(), S.v2.data(), S.a2.data(),
+		  S.phi.data(), S.rscl.data(), S.dt.data(), S.crit.data());
+
+  //
+  // The particle loop
+  //
+  unsigned *tcnt = tmdt[id].data();
 
-    std::map<double, int> dseq;
+  for (size_t i=0; i<npart; i++) {
 
-    dseq[dtd] = 0;
-    dseq[dtv] = 1;
-    dseq[dts] = 2;
-    if ( dta > 0.0 ) dseq[dta] = 3;
-    if ( dtA > 0.0 ) dseq[dtA] = 4;
+    int n = c->levlist[level][nbeg+i];
+    Particle *p = S.part[i];
 
     // Smallest time step
     //
-    dt = std::max<double>(eps, dseq.begin()->first);
+    double dt = std::max<double>(eps, S.dt[i]);
 
     // Enforce minimum step per level
     //
@@ -217,11 +282,11 @@ void * adjust_multistep_level_thread(void *ptr)
       //
       // Tally smallest (e.g. controlling) timestep
       //
-      tmdt[id][p->level][dseq.begin()->second]++;
+      tcnt[p->level*mdtDim + S.crit[i]]++;
       //
       // Counter
       //
-      tmdt[id][p->level][mdtDim-1]++;
+      tcnt[p->level*mdtDim + mdtDim-1]++;
     }
   }
 
@@ -231,8 +296,6 @@ void * adjust_multistep_level_thread(void *ptr)
   finish0 = std::chrono::high_resolution_clock::now();
   std::chrono::duration<double, std::micro> duration = finish0 - start0;
   adjtm1[id] += duration.count();
-
-  return (NULL);
 }
 
 
@@ -384,7 +447,7 @@ void adjust_multistep_level()
   }
 
   //
-  // Preliminary data structure and thread creation
+  // Preliminary per-thread data structures
   //
   mindt1 = std::vector< double > (nthrds,  1.0e20);
   maxdt1 = std::vector< double > (nthrds, -1.0e20);
@@ -403,31 +466,11 @@ void adjust_multistep_level()
     }
   }
 
-  thrd_pass_sync* td = new thrd_pass_sync [nthrds];
-
-  if (!td) {
-    std::ostringstream sout;
-    sout << "Process " << myid
-	 << ": adjust_multistep_level: error allocating thread structures";
-    throw GenericError(sout.str(), __FILE__, __LINE__, 1024, true);
-  }
-
-  pthread_t* t  = new pthread_t [nthrds];
-
-  if (!t) {
-    std::ostringstream sout;
-    sout << "Process " << myid
-	 << ": adjust_multistep_level: error allocating memory for thread";
-    throw GenericError(sout.str(), __FILE__, __LINE__, 1024, true);
-  }
-  
-
   if (tmdt.size() == 0) {
-    tmdt = std::vector< std::vector< std::vector<unsigned> > >(nthrds);
-    for (int n=0; n<nthrds; n++) {
-      tmdt[n] = std::vector< std::vector<unsigned> >(multistep+1);
-      for (int k=0; k<=multistep; k++) tmdt[n][k] = std::vector<unsigned>(mdtDim);
-    }
+    tmdt.resize(nthrds);
+    tscr.resize(nthrds);
+    for (int n=0; n<nthrds; n++)
+      tmdt[n] = std::vector<unsigned>((multistep+1)*mdtDim, 0);
   }
 
   for (auto c : comp->components) {
@@ -439,8 +482,7 @@ void adjust_multistep_level()
     //
     if (mdrft == Mstep) {
       for (int n=0; n<nthrds; n++)
-	for (int k=0; k<=multistep; k++) 
-	  for (int j=0; j<mdtDim; j++) tmdt[n][k][j] = 0;
+	std::fill(tmdt[n].begin(), tmdt[n].end(), 0);
     }
     
     int first = mfirst[mdrft];	// First active level at drifted
@@ -449,62 +491,16 @@ void adjust_multistep_level()
     if (this_step==0 and mstep==0) first = 0; // Do all levels
 
     for (int level=first; level<=multistep; level++) {
-      
-      if (nthrds==1) {
-
-	td[0].level = level;
-	td[0].id = 0;
-	td[0].c = c;
-	
-	adjust_multistep_level_thread(&td[0]);
-	
-      } else {
-	  
-	//
-	// Make the <nthrds> threads
-	//
-	int errcode;
-	void *retval;
-	
-	for (int i=0; i<nthrds; i++) {
-	  
-	  td[i].level = level;
-	  td[i].id = i;
-	  td[i].c = c;
-	  
-	  errcode =  pthread_create(&t[i], 0, adjust_multistep_level_thread, &td[i]);
-	    
-	  if (errcode) {
-	    std::ostringstream sout;
-	    sout << "Process " << myid
-		 << " adjust_multistep_level: cannot make thread " << i
-		 << ", errcode=" << errcode;
-	    throw GenericError(sout.str(), __FILE__, __LINE__, 1024, true);
-	  }
-#ifdef DEBUG
-	  else {
-	    cout << "Process " << myid << ": thread <" << i << "> created\n";
-	  }
-#endif
-	}
-	  
-	//
-	// Collapse the threads
-	//
-	for (int i=0; i<nthrds; i++) {
-	  if ((errcode=pthread_join(t[i], &retval))) {
-	    std::ostringstream sout;
-	    sout << "Process " << myid
-		 << " adjust_multistep_level: thread join " << i
-		 << " failed, errcode=" << errcode;
-	    throw GenericError(sout.str(), __FILE__, __LINE__, 1024, true);
-	  }
-#ifdef DEBUG    
-	  cout << "Process " << myid 
-	       << ": multistep thread <" << i << "> thread exited\n";
-#endif
-	}
-      }
+
+      // Dynamic blocks balance the uneven cost of particles that
+      // change level
+      //
+      ThreadPool::instance().parallel_for
+	(c->levlist[level].size(), 0,
+	 [c, level](size_t nbeg, size_t nend, int id)
+	 {
+	   adjust_multistep_level_thread(c, level, nbeg, nend, id);
+	 });
     }
 
     // Accumulate counters for all threads at the master step boundary
@@ -513,13 +509,10 @@ void adjust_multistep_level()
       for (int n=0; n<nthrds; n++)
 	for (int k=0; k<=multistep; k++) 
 	  for (int j=0; j<mdtDim; j++) 
-	    c->mdt_ctr[k][j] += tmdt[n][k][j];
+	    c->mdt_ctr[k][j] += tmdt[n][k*mdtDim + j];
     }
   }
 
-  delete [] td;
-  delete [] t;
-
   //
   // Finish the update
   //
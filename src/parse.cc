@@ -241,6 +241,10 @@ void initialize(void)
     if (_G["runtag"])		runtag       = _G["runtag"].as<std::string>();
     if (_G["restart_cmd"])      restart_cmd  = _G["restart_cmd"].as<std::string>();
     if (_G["restart_as_new"])   ignore_info  = _G["restart_as_new"].as<bool>();
+    if (_G["restart_mpiio"])    restart_mpiio = _G["restart_mpiio"].as<bool>();
+    if (_G["async_output"])     async_output = _G["async_output"].as<bool>();
+    if (_G["async_depth"])      async_depth  = _G["async_depth"].as<int>();
+    if (_G["fuse_interactions"]) fuse_interactions = _G["fuse_interactions"].as<bool>();
     if (_G["allcouples"])       all_couples  = _G["allcouples"].as<bool>();
     
     bool ok = true;
@@ -0,0 +1,23 @@
+#!/usr/bin/env python
+# coding: utf-8
+
+# Check that the Cube coefficients from the NUFFT engine (runN) match
+# the direct sum over particles (runC)
+
+import pyEXP
+import numpy as np
+
+ref  = pyEXP.coefs.Coefs.factory('outcoef.cube.runC')
+test = pyEXP.coefs.Coefs.factory('outcoef.cube.runN')
+
+if len(ref.Times()) == 0 or not np.allclose(ref.Times(), test.Times()):
+    print("Coefficient times differ")
+    exit(1)
+
+a = ref.getAllCoefs()
+b = test.getAllCoefs()
+
+diff = np.max(np.abs(a - b))/np.max(np.abs(a))
+print("Maximum relative coefficient difference:", diff)
+
+exit(0 if diff <= 1.0e-6 else 1)
@@ -0,0 +1,62 @@
+#!/usr/bin/env python
+# coding: utf-8
+
+# Check that the batched field evaluation matches the pointwise one
+# for the cylindrical basis
+
+import pyEXP
+import numpy as np
+
+disk_config = """
+---
+id: cylinder
+parameters:
+  acyl: 0.01
+  hcyl: 0.001
+  lmaxfid: 20
+  nmaxfid: 20
+  mmax: 6
+  nmax: 8
+  ncylnx: 128
+  ncylny: 64
+  ncylodd: 3
+  rnum: 32
+  pnum: 0
+  tnum: 16
+  ashift: 0.5
+  vflag: 0
+  logr: false
+  density: true
+  eof_file: .eof.cache.run0t
+  ignore: true
+...
+"""
+
+basis = pyEXP.basis.Basis.factory(disk_config)
+
+# Coefficients from an exponential disk with a bar-like m=2
+# distortion so that the non-axisymmetric terms are populated
+#
+rng   = np.random.default_rng(23)
+npart = 20000
+R     = rng.gamma(2.0, 0.01, npart)
+phi   = rng.uniform(0.0, 2.0*np.pi, npart)
+pos   = np.array([1.3*R*np.cos(phi), R*np.sin(phi),
+                  rng.normal(0.0, 0.001, npart)])
+mass  = np.ones(npart)/npart
+
+basis.set_coefs(basis.createFromArray(mass, pos, time=0.0))
+
+# Random points plus a line of points along y at fixed (x, z)
+#
+x = np.concatenate([rng.uniform(-0.05, 0.05, 200), np.full(50, 0.01)])
+y = np.concatenate([rng.uniform(-0.05, 0.05, 200), np.linspace(-0.05, 0.05, 50)])
+z = np.concatenate([rng.uniform(-0.005, 0.005, 200), np.full(50, 0.001)])
+
+batch = basis.getFieldsBatch(x, y, z)
+point = np.array([basis.getFields(a, b, c) for a, b, c in zip(x, y, z)])
+
+err = np.max(np.abs(batch - point), axis=0)/(np.max(np.abs(point), axis=0) + 1.0e-30)
+print("Relative differences by field:", err)
+
+exit(0 if np.all(err < 1.0e-12) else 1)
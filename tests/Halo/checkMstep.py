@@ -0,0 +1,36 @@
+#!/usr/bin/env python
+# coding: utf-8
+
+import math
+
+# The multistep interpolation diagnostic must exist and hold one line
+# per step with the time, mstep, mdrft and a finite, non-negative
+# relative difference from the linear interpolant
+#
+rows = []
+with open("runI.mstep_diag.halo") as file:
+    for line in file:
+        v = line.split()
+        if len(v) != 4:
+            print("Bad diagnostic line:", line.strip())
+            exit(1)
+        rows.append([float(x) for x in v])
+
+if len(rows) == 0:
+    print("No diagnostic lines")
+    exit(1)
+
+for v in rows:
+    if not math.isfinite(v[3]) or v[3] < 0.0:
+        print("Bad relative difference at T={}: {}".format(v[0], v[3]))
+        exit(1)
+
+# The run recomputes the basis at T=0.02 and continues to T=0.048 so
+# the history must have been rebuilt after the reset
+#
+if max(v[0] for v in rows) <= 0.02:
+    print("No diagnostic lines after the basis was recomputed")
+    exit(1)
+
+print("Multistep diagnostic OK:", len(rows), "lines")
+exit(0)
@@ -0,0 +1,26 @@
+#!/usr/bin/env python
+# coding: utf-8
+
+# Check that the coefficients written with async_output on (run1)
+# match those from the synchronous run (run0) at the common times
+
+import pyEXP
+import numpy as np
+
+ref  = pyEXP.coefs.Coefs.factory('outcoef.halo.run0')
+test = pyEXP.coefs.Coefs.factory('outcoef.halo.run1')
+
+times = test.Times()
+ntim  = len(times)
+
+if ntim == 0 or not np.allclose(ref.Times()[:ntim], times):
+    print("Coefficient times differ")
+    exit(1)
+
+a = ref.getAllCoefs()[:, :, :ntim]
+b = test.getAllCoefs()
+
+diff = np.max(np.abs(a - b))/np.max(np.abs(a))
+print("Maximum relative coefficient difference over", ntim, "times:", diff)
+
+exit(0 if diff <= 1.0e-12 else 1)
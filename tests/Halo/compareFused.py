@@ -0,0 +1,30 @@
+#!/usr/bin/env python
+# coding: utf-8
+
+# Check that the forces from the fused interaction pass (runF) match
+# those from the separate interaction calls (runU)
+
+import numpy as np
+
+ok = True
+
+for name in ['halo', 'inner', 'outer']:
+    # Columns: indx, mass, pos, vel, acc, pot, potext
+    a = np.loadtxt('OUTASC.' + name + '.runF.00000', skiprows=2, usecols=range(13))
+    b = np.loadtxt('OUTASC.' + name + '.runU.00000', skiprows=2, usecols=range(13))
+
+    a = a[np.argsort(a[:,0])]
+    b = b[np.argsort(b[:,0])]
+
+    if a.shape != b.shape or not np.array_equal(a[:,0], b[:,0]):
+        print("Particle lists differ for", name)
+        ok = False
+        continue
+
+    scale = np.max(np.abs(b[:,8:13]))
+    diff  = np.max(np.abs(a[:,8:13] - b[:,8:13]))/scale
+    print("Maximum relative acc/pot difference for", name, ":", diff)
+
+    if diff > 1.0e-12: ok = False
+
+exit(0 if ok else 1)
@@ -0,0 +1,41 @@
+#!/usr/bin/env python
+# coding: utf-8
+
+# Check that the matrix-free Hankel MSSA agrees with the dense
+# trajectory matrix analysis on the halo coefficients
+
+import pyEXP
+import numpy as np
+
+coefs = pyEXP.coefs.Coefs.factory('outcoef.halo.run0')
+
+keys   = [[0, 0, 0], [0, 0, 1], [0, 0, 2], [2, 0, 0], [2, 0, 1]]
+config = {'halo': (coefs, keys, [])}
+
+window = len(coefs.Times())//2
+npc    = 4
+
+dense  = pyEXP.mssa.expMSSA(config, window, npc, 'Jacobi: true')
+hankel = pyEXP.mssa.expMSSA(config, window, npc, 'Hankel: true')
+
+ev1 = dense.eigenvalues()[:npc]
+ev2 = hankel.eigenvalues()[:npc]
+
+ex1 = dense.explained()[:npc]
+ex2 = hankel.explained()[:npc]
+
+print("Dense eigenvalues: ", ev1)
+print("Hankel eigenvalues:", ev2)
+print("Dense explained:   ", ex1)
+print("Hankel explained:  ", ex2)
+
+ok = np.allclose(ev1, ev2, rtol=1.0e-4) and np.allclose(ex1, ex2, rtol=1.0e-4)
+
+# The truncated Hankel analysis must not report more than the full
+# variance
+#
+if hankel.explained()[-1] > 1.0 + 1.0e-12:
+    print("Explained variance exceeds unity")
+    ok = False
+
+exit(0 if ok else 1)
@@ -0,0 +1,94 @@
+#!/usr/bin/env python
+# coding: utf-8
+
+# Check that an incremental MSSA update agrees with an analysis of
+# the extended series from scratch
+
+import pyEXP
+import numpy as np
+
+# Each channel is a sum of sinusoids with periods that divide both
+# the initial and the extended lengths.  Then the mean and variance
+# used for detrending are the same for both series, and the two
+# analyses see the same data.
+#
+n0, n1 = 96, 128
+times  = np.arange(n1)*0.1
+amps   = [[1.0, 0.5, 0.2], [0.7, 0.9, 0.1], [0.3, 0.4, 0.8]]
+phases = [[0.0, 0.3, 1.1], [0.5, 1.7, 0.2], [2.1, 0.9, 1.4]]
+pers   = [32, 16, 8]
+
+data = np.zeros((n1, len(amps)))
+for c in range(len(amps)):
+    for a, p, T in zip(amps[c], phases[c], pers):
+        data[:, c] += a*np.sin(2.0*np.pi*np.arange(n1)/T + p)
+
+first = pyEXP.coefs.TableData(times[:n0].tolist(), data[:n0].tolist(), False)
+full  = pyEXP.coefs.TableData(times.tolist(), data.tolist(), False)
+
+keys   = [[0], [1], [2]]
+window = 24
+npc    = 6
+
+# Jacobi gives the full-rank basis, for which the update is exact
+#
+update = pyEXP.mssa.expMSSA({'table': (first, keys, [])}, window, npc, 'Jacobi: true')
+update.eigenvalues()            # Compute the analysis before updating
+update.update({'table': (full, keys, [])})
+
+scratch = pyEXP.mssa.expMSSA({'table': (full, keys, [])}, window, npc, 'Jacobi: true')
+
+ev1 = update.eigenvalues()[:npc]
+ev2 = scratch.eigenvalues()[:npc]
+
+print("Updated eigenvalues:     ", ev1)
+print("From scratch eigenvalues:", ev2)
+
+ok = np.allclose(ev1, ev2, rtol=1.0e-6)
+
+# The reconstructions from the signal subspace do not depend on the
+# sign or rotation of the singular vectors, so they must agree too
+#
+update.reconstruct(list(range(npc)))
+scratch.reconstruct(list(range(npc)))
+
+for key in scratch.getRCkeys():
+    rc1 = update.getRC(key)
+    rc2 = scratch.getRC(key)
+    err = np.max(np.abs(rc1 - rc2))/np.max(np.abs(rc2))
+    print("Relative reconstruction difference for", key, "=", err)
+    if not err < 1.0e-6: ok = False
+
+# With a truncated basis the update is approximate, but the PCs must
+# still be the projection of the full trajectory matrix onto the
+# updated basis, for both the dense and the matrix-free analyses
+#
+rng   = np.random.default_rng(11)
+noisy = data + 0.3*rng.standard_normal(data.shape)
+
+first = pyEXP.coefs.TableData(times[:n0].tolist(), noisy[:n0].tolist(), False)
+full  = pyEXP.coefs.TableData(times.tolist(), noisy.tolist(), False)
+
+# The update detrends with the mean and variance of the initial series
+#
+mean = noisy[:n0].mean(axis=0)
+std  = noisy[:n0].std(axis=0)
+det  = (noisy - mean)/std
+
+numK = n1 - window + 1
+Y = np.zeros((numK, window*len(keys)))
+for c in range(len(keys)):
+    for j in range(window):
+        Y[:, window*c + j] = det[j:j+numK, c]
+
+for flags in ['rank: 4', '{Hankel: true, rank: 4}']:
+    trunc = pyEXP.mssa.expMSSA({'table': (first, keys, [])}, window, 4, flags)
+    trunc.eigenvalues()
+    trunc.update({'table': (full, keys, [])})
+
+    PC  = trunc.getPC()
+    err = np.max(np.abs(PC - Y @ trunc.getU()))/np.max(np.abs(PC))
+    print("Relative PC projection error for", flags, "=", err)
+    if not err < 1.0e-8: ok = False
+
+exit(0 if ok else 1)
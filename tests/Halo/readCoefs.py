@@ -1,9 +1,65 @@
 #!/usr/bin/env python
 # coding: utf-8
 
+import os
 import pyEXP
+import numpy as np
 
 coefs = pyEXP.coefs.Coefs.factory('outcoef.halo.run0')
 data  = coefs.getAllCoefs()
 print(data.shape)
 print(coefs.getName())
+
+# Round trip through the HDF5 layouts: the snapshot-group layout
+# (v1.x) and the chunked layout (v2.0) must return the same values
+#
+v1file = 'outcoef.halo.run0.v1.h5'
+v2file = 'outcoef.halo.run0.v2.h5'
+
+for f in [v1file, v2file]:
+    if os.path.exists(f): os.remove(f)
+
+coefs.setH5Chunked(False)
+coefs.WriteH5Coefs(v1file)
+
+# Write the v2.0 file in two parts to exercise ExtendH5Coefs
+#
+times = coefs.Times()
+tmid  = times[len(times)//2]
+
+first = pyEXP.coefs.Coefs.factory('outcoef.halo.run0', tmax=tmid)
+last  = pyEXP.coefs.Coefs.factory('outcoef.halo.run0', tmin=tmid*(1.0 + 1.0e-8) + 1.0e-12)
+
+first.setH5Chunked(True, 4)
+first.WriteH5Coefs(v2file)
+last.ExtendH5Coefs(v2file)
+
+ok = True
+
+for f in [v1file, v2file]:
+    test = pyEXP.coefs.Coefs.factory(f)
+    if not np.allclose(test.Times(), times):
+        print("Times differ for", f)
+        ok = False
+    elif not np.allclose(test.getAllCoefs(), data):
+        print("Coefficients differ for", f)
+        ok = False
+    else:
+        print("Round trip OK for", f)
+
+# A window of the chunked file must match the same slice of the
+# full series
+#
+wtimes, wdata = pyEXP.coefs.Coefs.ReadH5Window(v2file, tmin=times[1], tmax=times[-2],
+                                               harmonics=[0, 2], radial=[0, 1, 2])
+beg = 1
+end = len(times) - 1
+if not np.allclose(wtimes, times[beg:end]) or \
+   not np.allclose(wdata, data[[0, 2]][:, [0, 1, 2]][:, :, beg:end].transpose(2, 0, 1)):
+    print("Windowed read differs")
+    ok = False
+
+for f in [v1file, v2file]:
+    if os.path.exists(f): os.remove(f)
+
+exit(0 if ok else 1)
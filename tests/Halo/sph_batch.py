@@ -0,0 +1,52 @@
+#!/usr/bin/env python
+# coding: utf-8
+
+# Check that the batched field evaluation matches the pointwise one
+# for the spherical basis
+
+import pyEXP
+import numpy as np
+
+halo_config="""
+---
+id: sphereSL
+parameters :
+  numr:  2000
+  rmin:  0.0001
+  rmax:  1.95
+  Lmax:  4
+  nmax:  10
+  scale: 0.0667
+  modelname: SLGridSph.model
+  cachename: .slgrid_sph_cache
+...
+"""
+
+basis = pyEXP.basis.Basis.factory(halo_config)
+
+# Coefficients from a lopsided, flattened cloud so that all (l, m)
+# terms are populated
+#
+rng  = np.random.default_rng(17)
+npart = 20000
+pos  = rng.normal(0.0, 0.1, (3, npart))
+pos[0] += 0.02
+pos[2] *= 0.5
+mass = np.ones(npart)/npart
+
+basis.set_coefs(basis.createFromArray(mass, pos, time=0.0))
+
+# Random points plus a line of points along y at fixed (x, z), which
+# exercises the reuse of the tables between neighbouring points
+#
+x = np.concatenate([rng.uniform(-0.5, 0.5, 200), np.full(50, 0.1)])
+y = np.concatenate([rng.uniform(-0.5, 0.5, 200), np.linspace(-0.5, 0.5, 50)])
+z = np.concatenate([rng.uniform(-0.5, 0.5, 200), np.full(50, 0.05)])
+
+batch = basis.getFieldsBatch(x, y, z)
+point = np.array([basis.getFields(a, b, c) for a, b, c in zip(x, y, z)])
+
+err = np.max(np.abs(batch - point), axis=0)/(np.max(np.abs(point), axis=0) + 1.0e-30)
+print("Relative differences by field:", err)
+
+exit(0 if np.all(err < 1.0e-12) else 1)
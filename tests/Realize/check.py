@@ -0,0 +1,26 @@
+import sys
+
+# The realization must not depend on the number of threads or
+# processes: the particle files must be identical, byte for byte.
+# The multiprocess run writes one file per rank in rank order.
+#
+# Usage: python3 check.py
+
+def read(prefix, nproc):
+    data = ""
+    for n in range(nproc):
+        with open("{}.{}".format(prefix, n)) as f:
+            data += f.read()
+    return data
+
+ref = read("thr1.bods", 1)
+
+ok = True
+for prefix, nproc in [("thr4.bods", 1), ("mpi2.bods", 2)]:
+    if read(prefix, nproc) != ref:
+        print("Realization <{}> differs from the serial one".format(prefix))
+        ok = False
+    else:
+        print("Realization <{}> is identical to the serial one".format(prefix))
+
+exit(0 if ok else 1)
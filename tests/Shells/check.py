@@ -0,0 +1,28 @@
+# Compare the potential energy from the Shells runs on one process
+# (runS) and on two processes with particle migration (runM).  Stale
+# or missing shell samples after a migration change the mass profile
+# and so the potential energy.
+
+def read(runtag):
+    """Read the global PE column from OUTLOG"""
+    pe = []
+    with open("OUTLOG." + runtag) as file:
+        n = 0
+        while (line := file.readline()) != "":
+            if n >= 6:          # Skip the header stuff
+                v = [float(x) for x in line.split('|')]
+                pe.append(v[13])
+            n = n + 1
+    return pe
+
+ref  = read("runS")
+test = read("runM")
+
+if len(ref) == 0 or len(ref) != len(test):
+    print("Log lengths differ:", len(ref), len(test))
+    exit(1)
+
+diff = max([abs(a - b)/abs(a) for a, b in zip(ref, test)])
+print("Maximum relative PE difference:", diff)
+
+exit(0 if diff < 1.0e-6 else 1)
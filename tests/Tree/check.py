@@ -0,0 +1,35 @@
+import sys
+import numpy as np
+
+# Compare the tree forces with direct summation for the same particles
+#
+# Usage: python3 check.py runtag tolerance
+
+def read(runtag):
+    """Read indx, acc, pot from an OUTASC file written with indexing
+    and accel on"""
+    data = np.loadtxt("OUTASC." + runtag + ".00000", skiprows=2, usecols=range(13))
+    data = data[np.argsort(data[:,0])]
+    return data[:,0], data[:,8:11], data[:,11]
+
+runtag = sys.argv[1]
+tol    = float(sys.argv[2])
+
+indxD, accD, potD = read("runD")
+indxT, accT, potT = read(runtag)
+
+if not np.array_equal(indxD, indxT):
+    print("Particle indices do not match")
+    exit(1)
+
+# Relative force and potential errors
+#
+da = np.linalg.norm(accT - accD, axis=1)/np.linalg.norm(accD, axis=1)
+dp = np.abs(potT - potD)/np.abs(potD)
+
+print("Median relative error in acc={:.3e}, pot={:.3e}".format(np.median(da), np.median(dp)))
+
+if not np.all(np.isfinite(da)) or np.median(da) > tol or np.median(dp) > tol:
+    exit(1)
+else:
+    exit(0)
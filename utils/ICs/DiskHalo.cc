@@ -408,12 +408,21 @@ void DiskHalo::set_halo(vector<Particle>& phalo, int nhalo, int npart)
   unsigned int count1=0, count=0;
   unsigned int badms1=0, badms=0;
 
+  // Realize the halo in threaded batches with one random stream per
+  // particle keyed by its global index, so the halo does not depend
+  // on the number of processes or threads
+  //
+  unsigned long first = 0, nloc = npart;
+  MPI_Exscan(&nloc, &first, 1, MPI_UNSIGNED_LONG, MPI_SUM, MPI_COMM_WORLD);
+  if (myid==0) first = 0;
+
+  unsigned nfail = 0;
+  Eigen::MatrixXd batch = multi->gen_points(npart, SEED, first, nfail);
+  count1 += nfail;
+
   for (int i=0; i<npart; i++) {
 
-    do {
-      ps = multi->gen_point(ierr);
-      if (ierr) count1++;
-    } while (ierr);
+    ps = batch.row(i).transpose();
     
     if (ps[0]<0.0) badms1++;
     p.mass = meanmass * ps[0];
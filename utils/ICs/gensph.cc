@@ -67,7 +67,7 @@ int
 main(int argc, char **argv)
 {
   int HMODEL, N, NUMDF, NUMR, NUMJ, NUME, NUMG, NREPORT, SEED, ITMAX;
-  int  NUMMODEL, RNUM, DIVERGE, DIVERGE2, LINEAR, NUMINT, NI, ND;
+  int  NUMMODEL, RNUM, DIVERGE, DIVERGE2, LINEAR, NUMINT, NI, ND, DIGITS;
   double DIVERGE_RFAC, DIVERGE_RFAC2, NN, MM, RA, RMODMIN, RMOD, EPS;
   double X0, Y0, Z0, U0, V0, W0, TOLE;
   double Emin0, Emax0, Kmin0, Kmax0, RBAR, MBAR, BRATIO, CRATIO, SMOOTH;
@@ -131,6 +131,8 @@ main(int argc, char **argv)
      cxxopts::value<int>(NREPORT)->default_value("1000"))
     ("SEED", "Initial seed for random number generator",
      cxxopts::value<int>(SEED)->default_value("11"))
+    ("DIGITS", "Significant digits in the phase-space output (17 reproduces the doubles exactly)",
+     cxxopts::value<int>(DIGITS)->default_value("12"))
     ("ITMAX", "Maximum number of interations for acceptance-rejection method",
      cxxopts::value<int>(ITMAX)->default_value("100000"))
     ("NUMMODEL", "Number of points for GeneralizedPolytrope",
@@ -271,8 +273,9 @@ main(int argc, char **argv)
     exit(-1);
   }
 
-  out.precision(11);
+  out.precision(DIGITS-1);
   out.setf(ios::scientific, ios::floatfield);
+  const int width = std::max<int>(20, DIGITS+8);
 
   // Begin integration
   //
@@ -703,9 +706,30 @@ main(int argc, char **argv)
   std::vector<Eigen::VectorXd> PS;
   Eigen::VectorXd zz = Eigen::VectorXd::Zero(7);
 
+  // Realize the default case in threaded batches.  Each particle
+  // draws from its own stream keyed by its global index so the
+  // realization does not depend on the number of processes or threads.
+  //
+  const int nbatch = 1<<20;
+  bool batched = not ELIMIT and not VTEST;
+  Eigen::MatrixXd batch;
+  int bbeg = beg;
+
+  // Table setup is collective for multimass models
+  //
+  if (batched) rmodel->gen_setup();
+
   for (int n=beg; n<end; n++) {
 
-    do {
+    if (batched and (n==beg or n-bbeg==batch.rows())) {
+      unsigned nfail;
+      bbeg  = n;
+      batch = rmodel->gen_points(std::min<int>(nbatch, end-n), SEED, n, nfail);
+      count += nfail;
+    }
+
+    if (batched) ps = batch.row(n-bbeg).transpose();
+    else do {
       if (ELIMIT)
 	ps = rmodel->gen_point(Emin0, Emax0, Kmin0, Kmax0, ierr);
       else if (VTEST) {
@@ -744,14 +768,14 @@ main(int argc, char **argv)
       if (zerovel) for (int i=4; i<7; i++) zz[i] -= ps[0]*ps[i];
     }
     else {
-      out << std::setw(20) << mass * ps[0];
-      for (int i=1; i<=6; i++) out << std::setw(20) << ps[i]+ps0[i];
+      out << std::setw(width) << mass * ps[0];
+      for (int i=1; i<=6; i++) out << std::setw(width) << ps[i]+ps0[i];
 
       if (NI) {
 	for (int n=0; n<NI; n++) out << std::setw(10) << 0;
       }
       if (ND) {
-	for (int n=0; n<ND; n++) out << std::setw(20) << 0.0;
+	for (int n=0; n<ND; n++) out << std::setw(width) << 0.0;
       }
 
       out << std::endl;
@@ -767,14 +791,14 @@ main(int argc, char **argv)
     }
 
     for (auto ps : PS) {
-      out << std::setw(20) << ps[0];
-      for (int i=1; i<=6; i++) out << std::setw(20) << ps[i]+ps0[i];
+      out << std::setw(width) << ps[0];
+      for (int i=1; i<=6; i++) out << std::setw(width) << ps[i]+ps0[i];
 
       if (NI) {
 	for (int n=0; n<NI; n++) out << std::setw(10) << 0;
       }
       if (ND) {
-	for (int n=0; n<ND; n++) out << std::setw(20) << 0.0;
+	for (int n=0; n<ND; n++) out << std::setw(width) << 0.0;
       }
 
       out << std::endl;
@@ -0,0 +1,161 @@
+// Build the Sturm-Liouville table cache for SLGridSph or SLGridSlab
+// ahead of a run.  Each finished table is checkpointed, so an
+// interrupted build is resumed by running the same command again.
+
+#include <exception>
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include <EXPException.H>
+#include <SLGridMP2.H>
+#include <localmpi.H>
+#include <libvars.H>
+#include <cxxopts.H>
+
+int main(int argc, char** argv)
+{
+  bool use_mpi, use_slab, verbose;
+  double rmin, rmax, rmapping, dfac, zmax;
+  int numr, cmap, diverge, Lmax, nmax, numk, numz;
+  std::string filename, cachefile, type;
+
+  //====================
+  // Parse command line
+  //====================
+
+  cxxopts::Options options(argv[0], "Compute and cache the tables for a spherical or slab SL basis.\nThe build is checkpointed: rerun the same command to resume an\ninterrupted build.  Use mpirun with --mpi to share the tables\nbetween processes.\n");
+
+  options.add_options()
+    ("h,help", "Print this help message")
+    ("v,verbose", "Print progress for each table",
+     cxxopts::value<bool>(verbose)->default_value("false"))
+    ("mpi", "using parallel computation",
+     cxxopts::value<bool>(use_mpi)->default_value("false"))
+    ("slab", "build the slab (SLGridSlab) tables rather than the spherical tables",
+     cxxopts::value<bool>(use_slab)->default_value("false"))
+    ("cmap", "coordinates in SphereSL: use mapped (1) or linear(0) coordinates",
+     cxxopts::value<int>(cmap)->default_value("1"))
+    ("Lmax", "maximum number of angular harmonics in the expansion",
+     cxxopts::value<int>(Lmax)->default_value("2"))
+    ("nmax", "maximum number of radial (or vertical) harmonics in the expansion",
+     cxxopts::value<int>(nmax)->default_value("10"))
+    ("numr", "radial knots for the SL grid",
+     cxxopts::value<int>(numr)->default_value("1000"))
+    ("rmin", "minimum radius for the SL grid",
+     cxxopts::value<double>(rmin)->default_value("-1.0"))
+    ("rmax", "maximum radius for the SL grid",
+     cxxopts::value<double>(rmax)->default_value("-1.0"))
+    ("rmapping", "cmap scale factor",
+     cxxopts::value<double>(rmapping)->default_value("0.067"))
+    ("diverge", "cusp divergence for spherical model",
+     cxxopts::value<int>(diverge)->default_value("0"))
+    ("dfac", "cusp divergence exponent for spherical model",
+     cxxopts::value<double>(dfac)->default_value("1.0"))
+    ("filename", "model file",
+     cxxopts::value<std::string>(filename)->default_value("SLGridSph.model"))
+    ("cache", "spherical cache file",
+     cxxopts::value<std::string>(cachefile)->default_value(".slgrid_sph_cache"))
+    ("numk", "maximum order of the in-plane harmonics for the slab",
+     cxxopts::value<int>(numk)->default_value("4"))
+    ("numz", "size of the vertical grid for the slab",
+     cxxopts::value<int>(numz)->default_value("1000"))
+    ("zmax", "maximum extent of the vertical grid for the slab",
+     cxxopts::value<double>(zmax)->default_value("10.0"))
+    ("type", "slab model: isothermal, parabolic or constant",
+     cxxopts::value<std::string>(type)->default_value("isothermal"))
+    ("H", "slab scale height",
+     cxxopts::value<double>(SLGridSlab::H))
+    ("L", "slab periodic box size",
+     cxxopts::value<double>(SLGridSlab::L))
+    ("ZBEG", "slab offset from the origin",
+     cxxopts::value<double>(SLGridSlab::ZBEG))
+    ("ZEND", "slab potential offset",
+     cxxopts::value<double>(SLGridSlab::ZEND))
+    ("interrupt", "stop a single-process spherical build after this many tables (for testing the resume)",
+     cxxopts::value<int>(SLGridSph::interrupt))
+    ;
+
+
+  //===================
+  // Parse options
+  //===================
+
+  cxxopts::ParseResult vm;
+
+  try {
+    vm = options.parse(argc, argv);
+  } catch (cxxopts::OptionException& e) {
+    if (myid==0) std::cout << "Option error: " << e.what() << std::endl;
+    return 2;
+  }
+
+  //===================
+  // MPI preliminaries
+  //===================
+  if (use_mpi) {
+    local_init_mpi(argc, argv);
+  }
+
+  // Print help message and exit
+  //
+  if (vm.count("help")) {
+    if (myid == 0) {
+      std::cout << options.help() << std::endl << std::endl;
+    }
+    if (use_mpi) MPI_Finalize();
+    return 1;
+  }
+
+  // The tables are shared between processes only when there are
+  // workers; a single process computes them itself
+  //
+  SLGridSph::mpi  = use_mpi and numprocs>1 ? 1 : 0;
+  SLGridSlab::mpi = use_mpi and numprocs>1 ? 1 : 0;
+  SLGridSlab::cache = 1;
+
+  int ret = 0;
+
+  // Build the tables; the constructors read a complete cache, resume
+  // from a checkpoint or compute from scratch
+  //
+  try {
+    if (use_slab) {
+      auto ortho = std::make_shared<SLGridSlab>(numk, nmax, numz, zmax,
+						type, verbose);
+      if (myid==0)
+	std::cout << "slbuild: slab tables with numk=" << numk
+		  << " nmax=" << nmax << " numz=" << numz
+		  << " are in <.slgrid_slab_cache>" << std::endl;
+    } else {
+				// Get default model bounds unless
+				// specificed on the command line
+      SphericalModelTable model(filename);
+
+      if (rmin<0.0) rmin = model.get_min_radius();
+      if (rmax<0.0) rmax = model.get_max_radius();
+
+      auto ortho = std::make_shared<SLGridSph>(filename, Lmax, nmax, numr,
+					       rmin, rmax, true, cmap, rmapping,
+					       diverge, dfac, cachefile, verbose);
+      if (myid==0)
+	std::cout << "slbuild: spherical tables with Lmax=" << Lmax
+		  << " nmax=" << nmax << " numr=" << numr
+		  << " are in <" << cachefile << ">" << std::endl;
+    }
+  }
+  catch (const EXPException& err) {
+    if (myid==0) {
+      std::cerr << err.what() << std::endl;
+    }
+    ret = 1;
+  }
+  catch (const std::exception& err) {
+    std::cerr << "slbuild [" << myid << "]: " << err.what() << std::endl;
+    ret = 1;
+  }
+
+  if (use_mpi) MPI_Finalize();
+
+  return ret;
+}